@@ -6,6 +6,7 @@
  */
 
 #include "Exti.h"
+#include "CritSec.h"
 
 /**
  * @brief Array of function pointers for external interrupt callbacks.
@@ -21,14 +22,17 @@ void (*EXTI_Callbacks[2])(void) = {0}; // Only two external interrupts on Atmega
  *
  * This function configures the specified external interrupt line (INT0 or INT1) to trigger
  * on the specified edge (rising, falling, or any logical change). It disables global interrupts
- * while making changes to ensure atomic operation.
+ * while making changes to ensure atomic operation and restores SREG afterwards, so it can be
+ * called with the interrupts disabled (fast boot) without enabling them.
  *
  * @param extiLine The external interrupt line to configure (EXTI_INT0 or EXTI_INT1).
  * @param edge The edge trigger to configure (EXTI_RISING_EDGE, EXTI_FALLING_EDGE, or EXTI_RISING_FALLING_EDGES).
  * @return None
  */
 void Exti_Init(EXTI_Line extiLine, EXTI_Edge edge) {
-    cli(); // Disable global interrupts
+    uint8 sreg;
+
+    CRITSEC_ENTER(CRITSEC_SITE_EXTI_INIT, sreg); // Disable global interrupts
 
     switch (extiLine) {
         case EXTI_INT0:
@@ -60,7 +64,7 @@ void Exti_Init(EXTI_Line extiLine, EXTI_Edge edge) {
             break;
     }
 
-    sei(); // Re-enable global interrupts
+    CRITSEC_EXIT(CRITSEC_SITE_EXTI_INIT, sreg); // Restore the global interrupt flag
 }
 
 
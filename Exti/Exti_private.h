@@ -12,7 +12,7 @@
 #include <avr/interrupt.h>
 #include <stdio.h>
 #include "Bit_Operations.h"
-#include "Std_Types.h"
+#include "Std_types.h"
 
 
 /*******************************************************************************
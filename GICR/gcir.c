@@ -7,20 +7,24 @@
 
 #include "gicr.h"
 #include <avr/interrupt.h>
+#include "CritSec.h"
 
 /**
  * @brief Initializes the specified external interrupt line with the given edge trigger.
  *
  * This function configures the specified external interrupt line (INT0 or INT1) to trigger
  * on the specified edge (rising, falling, or any logical change). It disables global interrupts
- * while making changes to ensure atomic operation.
+ * while making changes to ensure atomic operation and restores SREG afterwards, so it can be
+ * called with the interrupts disabled (fast boot) without enabling them.
  *
  * @param line The external interrupt line to configure (GICR_INT0 or GICR_INT1).
  * @param edge The edge trigger to configure (GICR_RISING_EDGE, GICR_FALLING_EDGE, or GICR_RISING_FALLING_EDGES).
  * @return None
  */
 void Gicr_Init(GICR_Line line, GICR_Edge edge) {
-    cli(); // Disable global interrupts
+    uint8 sreg;
+
+    CRITSEC_ENTER(CRITSEC_SITE_GICR_INIT, sreg); // Disable global interrupts
 
     switch (line) {
         case GICR_INT0:
@@ -58,7 +62,7 @@ void Gicr_Init(GICR_Line line, GICR_Edge edge) {
             break;
     }
 
-    sei(); // Re-enable global interrupts
+    CRITSEC_EXIT(CRITSEC_SITE_GICR_INIT, sreg); // Restore the global interrupt flag
 }
 
 /**
@@ -13,11 +13,11 @@
  ******************************   Macros Start      ****************************
  *******************************************************************************/
 #include "Bit_Operations.h"
-#include "gpio.h"
+#include "GPIO.h"
 
 // Define LCD-related macros with specific register addresses
-#define LCD_Dir  (*(volatile uint8_t *)(GPIOD_BASE_ADDR - GPIO_DDR_OFFSET))  /* Define LCD data port direction */
-#define LCD_Port (*(volatile uint8_t *)(GPIOD_BASE_ADDR))                    /* Define LCD data port */
+#define LCD_Dir  DDRD   /* Define LCD data port direction */
+#define LCD_Port PORTD  /* Define LCD data port */
 #define RS 2                                                                  /* Define Register Select pin */
 #define EN 3                                                                  /* Define Register Enable pin */
 /*******************************************************************************
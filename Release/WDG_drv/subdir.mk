@@ -17,7 +17,7 @@ C_DEPS += \
 WDG_drv/%.o: ../WDG_drv/%.c WDG_drv/subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: AVR Compiler'
-	avr-gcc -I"D:\Final_WDG_AVR\gpio" -I"D:\Final_WDG_AVR\buzzer" -I"D:\Final_WDG_AVR\Exti" -I"D:\Final_WDG_AVR\GICR" -I"D:\Final_WDG_AVR\Lcd" -I"D:\Final_WDG_AVR\lib" -I"D:\Final_WDG_AVR\led_mrg" -I"D:\Final_WDG_AVR\src" -I"D:\Final_WDG_AVR\timer" -I"D:\Final_WDG_AVR\WDG_drv" -I"D:\Final_WDG_AVR\WDGMrh" -Wall -Os -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega328p -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
+	avr-gcc -I"D:\Final_WDG_AVR\gpio" -I"D:\Final_WDG_AVR\buzzer" -I"D:\Final_WDG_AVR\Exti" -I"D:\Final_WDG_AVR\GICR" -I"D:\Final_WDG_AVR\Lcd" -I"D:\Final_WDG_AVR\lib" -I"D:\Final_WDG_AVR\led_mrg" -I"D:\Final_WDG_AVR\src" -I"D:\Final_WDG_AVR\timer" -I"D:\Final_WDG_AVR\WDG_drv" -I"D:\Final_WDG_AVR\WDGMrh" -I"D:\Final_WDG_AVR\shell" -I"D:\Final_WDG_AVR\run_cfg" -I"D:\Final_WDG_AVR\vcc_mon" -I"D:\Final_WDG_AVR\tick_mon" -I"D:\Final_WDG_AVR\crit_sec" -I"D:\Final_WDG_AVR\win_cal" -I"D:\Final_WDG_AVR\eeprom" -I"D:\Final_WDG_AVR\telemetry" -I"D:\Final_WDG_AVR\fault_inj" -I"D:\Final_WDG_AVR\remote_mon" -I"D:\Final_WDG_AVR\ext_wdg" -I"D:\Final_WDG_AVR\limp_home" -I"D:\Final_WDG_AVR\boot" -I"D:\Final_WDG_AVR\safe_state" -I"D:\Final_WDG_AVR\flash_crc" -I"D:\Final_WDG_AVR\stack_mon" -I"D:\Final_WDG_AVR\crash_dump" -I"D:\Final_WDG_AVR\hb_mon" -Wall -Os -fpack-struct -fshort-enums -ffunction-sections -fdata-sections -std=gnu99 -funsigned-char -funsigned-bitfields -mmcu=atmega328p -DF_CPU=1000000UL -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -c -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
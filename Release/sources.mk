@@ -31,4 +31,22 @@ gpio \
 led_mrg \
 src \
 timer \
+shell \
+run_cfg \
+vcc_mon \
+tick_mon \
+crit_sec \
+win_cal \
+eeprom \
+telemetry \
+fault_inj \
+remote_mon \
+ext_wdg \
+limp_home \
+boot \
+safe_state \
+flash_crc \
+stack_mon \
+crash_dump \
+hb_mon \
 
@@ -11,16 +11,87 @@
 #include <util/delay.h>
 #include "timer.h"
 #include "Std_types.h"
+#include "HBMON.h"
+#include "RemoteMon.h"
+#include "VccMon.h"
+#include "StackMon.h"
+#include "SafeState.h"
+#include "FaultInj.h"
+#include "CritSec.h"
+#include "RunCfg.h"
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+// Statistics are kept for the count-supervised entities of the image only
+#define WDGM_STATS_ENTITIES		(1 + HBMON_ENABLED + REMOTEMON_ENABLED * REMOTEMON_NODE_COUNT)
+#define WDGM_STATS_NONE			0xFF
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
 
 
 /*******************************************************************************
  *************************   Global variables Start      ***********************
  *******************************************************************************/
-static vuint32_t WDGM_LEDM_CallCount = 0;
+static vuint8 WDGM_EntityCallCount[WDGM_ENTITY_COUNT];
+static vuint8 WDGM_EntityFailed[WDGM_ENTITY_COUNT];
 static vuint32_t last_time_checked = 0;
 
 vuint8 WDGM_MainFunction_Stuck = 0;
 volatile bool WDGM_LEDM_Alive = false;
+volatile WDGM_StatusType WDGM_EntityStatus[WDGM_ENTITY_COUNT];
+
+/**
+ * Supervision window of every entity, indexed by WDGM_EntityIdType. Copied into
+ * WDGM_EntityConfig by WDGM_Init, the windows can then be tightened (WinCal).
+ */
+static const WDGM_EntityConfigType WDGM_EntityConfigDefault[WDGM_ENTITY_COUNT] = {
+	/* WDGM_ENTITY_LEDM     */ { true,          LEDM_CALLS_OK_MIN,   LEDM_CALLS_OK_MAX   },
+	/* WDGM_ENTITY_HBMON    */ { HBMON_ENABLED, HBMON_PULSES_OK_MIN, HBMON_PULSES_OK_MAX },
+	/* WDGM_ENTITY_STACKMON */ { true,          0,                   0xFF                },	// Failures only
+	/* WDGM_ENTITY_FLASHCRC */ { true,          0,                   0xFF                },	// Failures only
+	/* WDGM_ENTITY_REMOTE_NODE1 */ { REMOTEMON_ENABLED, REMOTEMON_FRAMES_OK_MIN, REMOTEMON_FRAMES_OK_MAX },
+	/* WDGM_ENTITY_REMOTE_NODE2 */ { REMOTEMON_ENABLED, REMOTEMON_FRAMES_OK_MIN, REMOTEMON_FRAMES_OK_MAX },
+	/* WDGM_ENTITY_TICKMON  */ { true,          0,                   0xFF                },	// Failures only
+	/* WDGM_ENTITY_VCCMON   */ { VCCMON_ENABLED, 0,                  0xFF                },	// Failures only
+};
+
+/**
+ * Relaxed windows of the degraded profile (half the minimum, twice the maximum).
+ */
+static const WDGM_EntityConfigType WDGM_EntityConfigDegraded[WDGM_ENTITY_COUNT] = {
+	/* WDGM_ENTITY_LEDM     */ { true,          LEDM_CALLS_OK_MIN / 2,   LEDM_CALLS_OK_MAX * 2   },
+	/* WDGM_ENTITY_HBMON    */ { HBMON_ENABLED, HBMON_PULSES_OK_MIN / 2, HBMON_PULSES_OK_MAX * 2 },
+	/* WDGM_ENTITY_STACKMON */ { true,          0,                       0xFF                    },
+	/* WDGM_ENTITY_FLASHCRC */ { true,          0,                       0xFF                    },
+	/* WDGM_ENTITY_REMOTE_NODE1 */ { REMOTEMON_ENABLED, REMOTEMON_FRAMES_OK_MIN / 2, REMOTEMON_FRAMES_OK_MAX * 2 },
+	/* WDGM_ENTITY_REMOTE_NODE2 */ { REMOTEMON_ENABLED, REMOTEMON_FRAMES_OK_MIN / 2, REMOTEMON_FRAMES_OK_MAX * 2 },
+	/* WDGM_ENTITY_TICKMON  */ { true,          0,                       0xFF                    },
+	/* WDGM_ENTITY_VCCMON   */ { VCCMON_ENABLED, 0,                      0xFF                    },
+};
+
+static WDGM_EntityConfigType WDGM_EntityConfig[WDGM_ENTITY_COUNT];	// Normal profile
+static const WDGM_EntityConfigType *WDGM_ActiveConfig = WDGM_EntityConfig;
+static WDGM_ProfileType WDGM_Profile = WDGM_PROFILE_NORMAL;
+static bool WDGM_EntityEnabled[WDGM_ENTITY_COUNT];	// Run-time switch on top of the profile
+static WDGM_EntityStatsType WDGM_EntityStats[WDGM_STATS_ENTITIES];	// Written by WDGM_MainFunction only
+
+/**
+ * Slot of every entity in WDGM_EntityStats, WDGM_STATS_NONE for the failure-only entities
+ * (their window is 0..255, a histogram of their calls says nothing) and the disabled ones.
+ */
+static const uint8 WDGM_StatsSlot[WDGM_ENTITY_COUNT] = {
+	/* WDGM_ENTITY_LEDM     */ 0,
+	/* WDGM_ENTITY_HBMON    */ HBMON_ENABLED ? 1 : WDGM_STATS_NONE,
+	/* WDGM_ENTITY_STACKMON */ WDGM_STATS_NONE,
+	/* WDGM_ENTITY_FLASHCRC */ WDGM_STATS_NONE,
+	/* WDGM_ENTITY_REMOTE_NODE1 */ REMOTEMON_ENABLED ? 1 + HBMON_ENABLED : WDGM_STATS_NONE,
+	/* WDGM_ENTITY_REMOTE_NODE2 */ REMOTEMON_ENABLED ? 2 + HBMON_ENABLED : WDGM_STATS_NONE,
+	/* WDGM_ENTITY_TICKMON  */ WDGM_STATS_NONE,
+	/* WDGM_ENTITY_VCCMON   */ WDGM_STATS_NONE,
+};
 
 volatile  WDGM_StatusType status = OK;
 volatile  WDGM_StatusType providedStatus = OK;
@@ -31,58 +102,162 @@ volatile  WDGM_StatusType providedStatus = OK;
 /**
  * @brief Initializes the Watchdog Manager (WDGM).
  *
- * This function initializes the variables used by the WDGM. It sets the call count to zero,
- * marks the LED Manager as not alive, sets the status to OK, and records the current time.
+ * This function initializes the variables used by the WDGM. It sets the call count of every
+ * entity to zero, marks the LED Manager as not alive, sets the status to OK, and records
+ * the current time.
  *
  * @return None
  */
 void WDGM_Init(void) {
-	WDGM_LEDM_CallCount = 0;
+	uint8 entity;
+
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		WDGM_EntityCallCount[entity] = 0;
+		WDGM_EntityFailed[entity] = false;
+		WDGM_EntityStatus[entity] = OK;
+		WDGM_EntityEnabled[entity] = true;
+	}
+	WDGM_RestoreDefaultWindows();
+	WDGM_ActiveConfig = WDGM_EntityConfig;
+	WDGM_Profile = WDGM_PROFILE_NORMAL;
 	WDGM_LEDM_Alive = false;
 	status = OK;
+	WDGM_ResetStats();
+	StackMon_Init();
     last_time_checked = HAL_GetTick();
 }
 
 
 
+/**
+ * @brief Adds one closed window of an entity to its statistics, if it has any.
+ *
+ * @param Entity The supervised entity (enabled).
+ * @param CallCount Aliveness indications of the window.
+ * @return None
+ */
+static void WDGM_StatsUpdate(uint8 Entity, uint8 CallCount) {
+	uint8 slot = WDGM_StatsSlot[Entity];
+	WDGM_EntityStatsType *stats;
+	sint16 low = (sint16)CallCount - WDGM_ActiveConfig[Entity].MinCalls;
+	sint16 high = (sint16)WDGM_ActiveConfig[Entity].MaxCalls - CallCount;
+	uint8 bin = (CallCount < WDGM_STATS_BINS - 1) ? CallCount : (WDGM_STATS_BINS - 1);
+
+	if (slot == WDGM_STATS_NONE) {
+		return;
+	}
+	stats = &WDGM_EntityStats[slot];
+	if (stats->Windows == 0 || CallCount < stats->MinCount) {
+		stats->MinCount = CallCount;
+	}
+	if (stats->Windows == 0 || CallCount > stats->MaxCount) {
+		stats->MaxCount = CallCount;
+	}
+	// Margins saturate to the sint8 range: a wide window, or a runaway entity (CallCount 0xFF)
+	low = (low > 127) ? 127 : ((low < -128) ? -128 : low);
+	high = (high > 127) ? 127 : ((high < -128) ? -128 : high);
+	if (stats->Windows == 0 || low < stats->MinMarginLow) {
+		stats->MinMarginLow = (sint8)low;
+	}
+	if (stats->Windows == 0 || high < stats->MinMarginHigh) {
+		stats->MinMarginHigh = (sint8)high;
+	}
+	if (WDGM_EntityStatus[Entity] != OK) {
+		if (stats->Violations != 0xFFFF) {
+			stats->Violations++;
+		}
+	} else if ((low <= WDGM_STATS_NEAR_MISS || high <= WDGM_STATS_NEAR_MISS) &&
+			   stats->NearMisses != 0xFFFF) {
+		stats->NearMisses++;
+	}
+	if (stats->Histogram[bin] != 0xFFFF) {
+		stats->Histogram[bin]++;
+	}
+	stats->CallSum += CallCount;
+	stats->Windows++;
+}
+
+
 /**
  * @brief Main function of the Watchdog Manager (WDGM).
  *
- * This function checks the aliveness of the LED Manager. It is called periodically.
+ * This function checks the aliveness of the supervised entities. It is called periodically.
  * If the time elapsed since the last check exceeds the watchdog period, it evaluates
- * the call count of the LED Manager. If the call count is within the acceptable range,
- * it marks the status as OK and the LED Manager as alive. Otherwise, it marks the status as NOK
- * and the LED Manager as not alive. It then resets the call count and updates the last checked time.
+ * the call count of every enabled entity. If all call counts are within their acceptable
+ * range and no entity reported a failure, it marks the status as OK. Otherwise, it marks the
+ * status as NOK. It then resets the call counts and updates the last checked time.
  *
  * @return None
  */
 void WDGM_MainFunction(void) {
-	// The function is stuck until it end
-	WDGM_MainFunction_Stuck = OK;
+	FAULTINJ_POINT(FAULTINJ_POINT_WDGM_MAIN);
+
+	/**
+	 * The function counts as stuck until it ends. WDGDrv_IsrNotification sets the flag back
+	 * to OK after every notification, it is not cleared here: a notification preempting this
+	 * function must still see the run completed since the previous notification, else the
+	 * refresh is skipped and the next one comes after the 64ms timeout (found by
+	 * test/test_wdgm_schedules.c).
+	 */
 
 	// Check when the compiler execute this function
 	GPIO_Write(WDGM_LED, HIGH); //Ch.4 Ocs.1
 	// HAL_GetTick() -> function to get the milliseconds in the timer driver
     uint32_t currentTime = HAL_GetTick();
+    FAULTINJ_CORRUPT(FAULTINJ_POINT_WDGM_MAIN, last_time_checked);
+
+    // Bounded step of the stack high-water-mark scan
+    StackMon_MainFunction();
+
+    if ((currentTime - last_time_checked) >= RunCfg_Active.WdgmPeriodMs) {
+    	WDGM_StatusType windowStatus = OK;
+    	uint8 entity;
+
+    	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+    		uint8 callCount;
+    		uint8 failed;
+    		uint8 sreg;
 
-    if ((currentTime - last_time_checked) >= WDGM_PERIOD_MS) {
-    	/**
-    	 * If the number of calls is between 8 and 12 then the status is OK.
-    	 */
-        if (WDGM_LEDM_CallCount >= LEDM_CALLS_OK_MIN && WDGM_LEDM_CallCount <= LEDM_CALLS_OK_MAX) {
-        	status = OK;
-        	WDGM_LEDM_Alive = true;
-        } else {
-        	status = NOK;
-        	WDGM_LEDM_Alive = false;
-        }
-        WDGM_LEDM_CallCount = 0;			// Reset the call counter
+    		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+    		// Heartbeat indications arrive from ISRs, take the counters atomically
+    		CRITSEC_ENTER(CRITSEC_SITE_WDGM_COUNTERS, sreg);
+    		callCount = WDGM_EntityCallCount[entity];
+    		failed = WDGM_EntityFailed[entity];
+    		WDGM_EntityCallCount[entity] = 0;	// Reset the call counter
+    		WDGM_EntityFailed[entity] = false;
+    		CRITSEC_EXIT(CRITSEC_SITE_WDGM_COUNTERS, sreg);
+
+    		/**
+    		 * If the number of calls is inside the entity window (8..12 for LEDM)
+    		 * and no failure was reported then the entity is OK.
+    		 */
+    		if (!WDGM_ActiveConfig[entity].Enabled || !WDGM_EntityEnabled[entity]) {
+    			WDGM_EntityStatus[entity] = OK;
+    			continue;
+    		}
+    		if (!failed && callCount >= WDGM_ActiveConfig[entity].MinCalls
+    			        && callCount <= WDGM_ActiveConfig[entity].MaxCalls) {
+    			WDGM_EntityStatus[entity] = OK;
+    		} else {
+    			WDGM_EntityStatus[entity] = NOK;
+    			windowStatus = NOK;
+    		}
+    		WDGM_StatsUpdate(entity, callCount);
+    	}
+    	// Drive the actuators to their safe state now instead of waiting for the reset
+    	if (windowStatus == NOK && !SafeState_IsActive()) {
+    		SafeState_Apply();
+    	}
+    	status = windowStatus;
+    	WDGM_LEDM_Alive = (WDGM_EntityStatus[WDGM_ENTITY_LEDM] == OK);
         last_time_checked = currentTime;	// update the last checked time
     }
     // the function now is not stucked
     GPIO_Write(WDGM_LED, LOW); //Ch.4 Ocs.1
 
     WDGM_MainFunction_Stuck = NOK;
+    FAULTINJ_STUCK(FAULTINJ_POINT_WDGM_MAIN, WDGM_MainFunction_Stuck);
 }
 
 
@@ -109,6 +284,186 @@ WDGM_StatusType WDGM_ProvideSupervisionStatus(void) {
  * @return None
  */
 void WDGM_AlivenessIndication(void) {
+	FAULTINJ_POINT(FAULTINJ_POINT_WDGM_ALIVENESS);
+	FAULTINJ_CORRUPT(FAULTINJ_POINT_WDGM_ALIVENESS, WDGM_EntityCallCount[WDGM_ENTITY_LEDM]);
+
 	// increment the call count variable to check if it's between 8 and 12
-	WDGM_LEDM_CallCount++;
+	WDGM_EntityAlivenessIndication(WDGM_ENTITY_LEDM);
+}
+
+
+/**
+ * @brief Indicates the aliveness of a supervised entity.
+ *
+ * Increments the call count of the entity for the current supervision window. The counter
+ * saturates so that a runaway caller can never wrap back into the valid window.
+ * Safe to call from interrupt context (a single byte read-modify-write).
+ *
+ * @param EntityId The supervised entity.
+ * @return None
+ */
+void WDGM_EntityAlivenessIndication(WDGM_EntityIdType EntityId) {
+	if (WDGM_EntityCallCount[EntityId] != 0xFF) {
+		WDGM_EntityCallCount[EntityId]++;
+	}
+}
+
+
+/**
+ * @brief Reports a failed check of a supervised entity.
+ *
+ * Used by supervision sources that measure more than plain aliveness (e.g. the heartbeat
+ * period bounds of HBMON). The entity is reported NOK when the current window is closed.
+ *
+ * @param EntityId The supervised entity.
+ * @return None
+ */
+void WDGM_EntityFailureIndication(WDGM_EntityIdType EntityId) {
+	WDGM_EntityFailed[EntityId] = true;
+}
+
+
+/**
+ * @brief Returns the supervision result of one entity for the last closed window.
+ *
+ * @param EntityId The supervised entity.
+ * @return OK or NOK.
+ */
+WDGM_StatusType WDGM_GetEntityStatus(WDGM_EntityIdType EntityId) {
+	return WDGM_EntityStatus[EntityId];
+}
+
+
+/**
+ * @brief Selects the supervision windows (normal or degraded profile).
+ *
+ * Takes effect from the next closed window. Called from the super loop context only.
+ *
+ * @param Profile WDGM_PROFILE_NORMAL or WDGM_PROFILE_DEGRADED.
+ * @return None
+ */
+void WDGM_SetProfile(WDGM_ProfileType Profile) {
+	WDGM_Profile = Profile;
+	WDGM_ActiveConfig = (Profile == WDGM_PROFILE_DEGRADED) ? WDGM_EntityConfigDegraded : WDGM_EntityConfig;
+}
+
+
+/**
+ * @brief Returns the active supervision profile.
+ */
+WDGM_ProfileType WDGM_GetProfile(void) {
+	return WDGM_Profile;
+}
+
+
+/**
+ * @brief Enables or disables the supervision of one entity at run time.
+ *
+ * A disabled entity is always reported OK (used by the limp-home mode to drop the
+ * entity that keeps resetting the MCU).
+ *
+ * @param EntityId The supervised entity.
+ * @param Enabled false to stop supervising the entity.
+ * @return None
+ */
+void WDGM_SetEntityEnabled(WDGM_EntityIdType EntityId, bool Enabled) {
+	WDGM_EntityEnabled[EntityId] = Enabled;
+}
+
+
+/**
+ * @brief Returns the window of one entity in the normal profile (default or tightened).
+ *
+ * @param EntityId The supervised entity.
+ * @param Config Receives the window.
+ * @return None
+ */
+void WDGM_GetEntityConfig(WDGM_EntityIdType EntityId, WDGM_EntityConfigType *Config) {
+	*Config = WDGM_EntityConfig[EntityId];
+}
+
+
+/**
+ * @brief Replaces the window of one entity in the normal profile.
+ *
+ * Takes effect from the next closed window. The degraded profile keeps its relaxed
+ * windows. Called from the super loop context only.
+ *
+ * @param EntityId The supervised entity.
+ * @param MinCalls Minimum aliveness indications per window.
+ * @param MaxCalls Maximum aliveness indications per window.
+ * @return None
+ */
+void WDGM_SetEntityWindow(WDGM_EntityIdType EntityId, uint8 MinCalls, uint8 MaxCalls) {
+	WDGM_EntityConfig[EntityId].MinCalls = MinCalls;
+	WDGM_EntityConfig[EntityId].MaxCalls = MaxCalls;
+}
+
+
+/**
+ * @brief Puts the windows of the normal profile back to the build-time defaults, the
+ * LEDM window of the runtime configuration (RunCfg_Active).
+ *
+ * @return None
+ */
+void WDGM_RestoreDefaultWindows(void) {
+	uint8 entity;
+
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		WDGM_EntityConfig[entity] = WDGM_EntityConfigDefault[entity];
+	}
+	WDGM_EntityConfig[WDGM_ENTITY_LEDM].MinCalls = RunCfg_Active.LedmCallsMin;
+	WDGM_EntityConfig[WDGM_ENTITY_LEDM].MaxCalls = RunCfg_Active.LedmCallsMax;
+}
+
+
+/**
+ * @brief Copies the supervision statistics of one entity.
+ *
+ * The statistics are written by WDGM_MainFunction only: called from the super loop
+ * context, the copy is consistent without disabling the interrupts.
+ *
+ * @param EntityId The supervised entity.
+ * @param Stats Receives the statistics, untouched for an entity without statistics.
+ * @return false if the entity has no statistics (failure-only or disabled module).
+ */
+bool WDGM_GetEntityStats(WDGM_EntityIdType EntityId, WDGM_EntityStatsType *Stats) {
+	uint8 slot = WDGM_StatsSlot[EntityId];
+
+	if (slot == WDGM_STATS_NONE) {
+		return false;
+	}
+	*Stats = WDGM_EntityStats[slot];
+	return true;
+}
+
+
+/**
+ * @brief Clears the supervision statistics of all the entities (e.g. after retuning
+ * the windows). Called from the super loop context only.
+ *
+ * @return None
+ */
+void WDGM_ResetStats(void) {
+	uint8 slot;
+	uint8 bin;
+
+	for (slot = 0; slot < WDGM_STATS_ENTITIES; slot++) {
+		WDGM_EntityStatsType *stats = &WDGM_EntityStats[slot];
+
+		WCET_LOOP_BOUND(WDGM_STATS_ENTITIES);
+		stats->Windows = 0;
+		stats->CallSum = 0;
+		stats->MinCount = 0;
+		stats->MaxCount = 0;
+		stats->MinMarginLow = 0;
+		stats->MinMarginHigh = 0;
+		stats->NearMisses = 0;
+		stats->Violations = 0;
+		for (bin = 0; bin < WDGM_STATS_BINS; bin++) {
+			WCET_LOOP_BOUND(WDGM_STATS_BINS);
+			stats->Histogram[bin] = 0;
+		}
+	}
 }
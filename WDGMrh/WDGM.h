@@ -2,6 +2,7 @@
 #define WDGM_H
 
 #include "Std_types.h"
+#include <stdbool.h>
 
 /*******************************************************************************
  ******************************   Macros Start      ****************************
@@ -9,6 +10,12 @@
 #define WDGM_PERIOD_MS 			 100
 #define LEDM_CALLS_OK_MIN		 8
 #define LEDM_CALLS_OK_MAX 		 12
+
+// Supervision statistics: histogram bins (call counts 0..BINS-2, last bin: BINS-1 and more)
+#define WDGM_STATS_BINS			 16
+// An OK window whose margin to a bound is this or less is a near miss (0: on the bound;
+// 9 or 11 calls are the normal jitter of the 10ms LEDM task against the window)
+#define WDGM_STATS_NEAR_MISS	 0
 /*******************************************************************************
  ******************************   Macros End        ****************************
  *******************************************************************************/
@@ -19,6 +26,57 @@ typedef enum {
 } WDGM_StatusType;
 
 
+/**
+ * Supervised entities. Every entity owns one aliveness counter that is checked
+ * against its [MinCalls, MaxCalls] window each WDGM_PERIOD_MS.
+ */
+typedef enum {
+    WDGM_ENTITY_LEDM = 0,		/* LEDM_Manage, local function calls       */
+    WDGM_ENTITY_HBMON,			/* External heartbeat on ICP1 (companion)  */
+    WDGM_ENTITY_STACKMON,		/* Stack margin, failure indications only  */
+    WDGM_ENTITY_FLASHCRC,		/* Flash image CRC, failure indications only */
+    WDGM_ENTITY_REMOTE_NODE1,	/* Serial heartbeat frames of remote node 1 */
+    WDGM_ENTITY_REMOTE_NODE2,	/* Serial heartbeat frames of remote node 2 */
+    WDGM_ENTITY_TICKMON,		/* Late or lost 1ms ticks, failure indications only */
+    WDGM_ENTITY_VCCMON,			/* Supply voltage sag, failure indications only */
+    WDGM_ENTITY_COUNT
+} WDGM_EntityIdType;
+
+typedef struct {
+    bool  Enabled;				/* Disabled entities are always reported OK */
+    uint8 MinCalls;				/* Minimum aliveness indications per window */
+    uint8 MaxCalls;				/* Maximum aliveness indications per window */
+} WDGM_EntityConfigType;
+
+/**
+ * Statistics of one entity over the closed windows since WDGM_Init / WDGM_ResetStats.
+ *
+ * The margins are the distances of the call count to the bounds of the active profile
+ * (MinCalls..MaxCalls), negative for a violated bound. Mean calls: CallSum / Windows.
+ * Only the count-supervised entities of the image have statistics (LEDM, and HBMON and
+ * the remote nodes when their module is enabled); the failure-only entities have none.
+ */
+typedef struct {
+    uint32 Windows;							/* Closed windows                          */
+    uint32 CallSum;							/* Sum of the call counts                  */
+    uint8  MinCount;						/* Lowest call count of a window           */
+    uint8  MaxCount;						/* Highest call count of a window          */
+    sint8  MinMarginLow;					/* Lowest count - MinCalls                 */
+    sint8  MinMarginHigh;					/* Lowest MaxCalls - count                 */
+    uint16 NearMisses;						/* OK windows within WDGM_STATS_NEAR_MISS  */
+    uint16 Violations;						/* NOK windows (count or failure)          */
+    uint16 Histogram[WDGM_STATS_BINS];		/* Windows per call count, saturating      */
+} WDGM_EntityStatsType;
+
+/**
+ * Supervision profiles: the degraded profile (limp-home mode) uses relaxed windows.
+ */
+typedef enum {
+    WDGM_PROFILE_NORMAL = 0,
+    WDGM_PROFILE_DEGRADED
+} WDGM_ProfileType;
+
+
 /*******************************************************************************
  ******************************   Function Prototype Start      ****************
  *******************************************************************************/
@@ -29,6 +87,28 @@ void WDGM_MainFunction(void);
 WDGM_StatusType WDGM_ProvideSupervisionStatus(void);
 
 void WDGM_AlivenessIndication(void);
+
+void WDGM_EntityAlivenessIndication(WDGM_EntityIdType EntityId);
+
+void WDGM_EntityFailureIndication(WDGM_EntityIdType EntityId);
+
+WDGM_StatusType WDGM_GetEntityStatus(WDGM_EntityIdType EntityId);
+
+void WDGM_SetProfile(WDGM_ProfileType Profile);
+
+WDGM_ProfileType WDGM_GetProfile(void);
+
+void WDGM_SetEntityEnabled(WDGM_EntityIdType EntityId, bool Enabled);
+
+void WDGM_GetEntityConfig(WDGM_EntityIdType EntityId, WDGM_EntityConfigType *Config);
+
+void WDGM_SetEntityWindow(WDGM_EntityIdType EntityId, uint8 MinCalls, uint8 MaxCalls);
+
+void WDGM_RestoreDefaultWindows(void);
+
+bool WDGM_GetEntityStats(WDGM_EntityIdType EntityId, WDGM_EntityStatsType *Stats);
+
+void WDGM_ResetStats(void);
 /*******************************************************************************
  ******************************   Function Prototype End      ******************
  *******************************************************************************/
@@ -5,8 +5,28 @@
  *      Author: Mahmoud
  */
 
-#include "WDGDrv.h"
+#include "WDGDRV.h"
+#include "Boot.h"
+#include "FaultInj.h"
+#include "CritSec.h"
+#include "RunCfg.h"
 
+#if (WDGDRV_REFRESH_PERIOD_MS >= WDGDRV_TIMEOUT_MS(WDGDRV_DEFAULT_TIMEOUT))
+#error "The WDG refresh period (Timer1) must be shorter than the WDT timeout"
+#endif
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static uint8 WDGDrv_Timeout = WDGDRV_DEFAULT_TIMEOUT;
+static WDGDrv_ModeType WDGDrv_Mode = WDGDRV_DEFAULT_MODE;
+
+static uint16 WDGDrv_LastRefreshMs = 0;		// Low 16 bits of millis at the last refresh request
+static uint8 WDGDrv_RefreshSeen = 0;
+vuint8 WDGDrv_WindowViolation = 0;			// Latched: refresh requested before the window opened
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
 
 
 /**
@@ -14,23 +34,14 @@
  * Enable Global Interrupt: The enable_global_interrupt function sets
  * the global interrupt enable bit (I-bit) in the Status Register (SREG).
  * By setting this bit, the microcontroller is allowed to process interrupts.
+ * Only for the end of the initialization: critical sections use CRITSEC_ENTER/CRITSEC_EXIT,
+ * which restore the flag instead of setting it.
  */
 void enable_global_interrupt(void){
 	SREG |= (1 << 7);		// Enable interrupts back
 }
 
 
-/**
- * @brief:
- * Disable Global Interrupt: The disable_global_interrupt function clears the I-bit in the SREG.
- * This effectively prevents the microcontroller from processing any interrupts,
- * which can be useful to ensure critical code sections are not interrupted.
- */
-void disable_global_interrupt(void){
-	SREG &= ~(1 << 7);			// Disable interrupts temporarily
-}
-
-
 
 /**
  * Steps of enabling the WDT in ATMega328P:
@@ -38,27 +49,38 @@ void disable_global_interrupt(void){
 	2) Reset the Watchdog Timer to ensure it starts in a known state = Zero.
 	3) Clear the Watchdog System Reset Flag (WDRF) to acknowledge any previous resets.
 	4) Reset the Watchdog Control Register (WDTCSR) to initial state (0x00) to avoid any garbage values in any register.
-	5) Enable the Watchdog Timer by initiating a timed sequence (WDCE and WDE bits set).
-	6) Within the timed sequence, set the WDE bit to enable the Watchdog Timer.
-	7) Set WDIE bit to enable Watchdog Interrupt Enable mode.
-	8) Set WDP1 bit to configure the prescaler for a 64-milliseconds timeout from data sheet.
-	9) Re-enable interrupts to resume normal operation.
+	5) Configure the timeout of the runtime configuration (RunCfg_Active.WdtTimeout, by
+	   default WDGDRV_DEFAULT_TIMEOUT) and the default mode (WDGDrv_Configure): WDIE + WDE
+	   with the WDP1 prescaler -> 64-milliseconds timeout from data sheet.
+	6) Restore SREG, then enable the interrupts to resume normal operation.
+ * Fast boot (BOOT_FAST_MODE): the interrupts are still disabled here (main enables them once)
+ * and WDGDrv_Configure writes the whole WDTCSR in its timed sequence, so steps 1, 4 and 6 are skipped.
  * */
 void WDGDrv_Init(void) {
 	GPIO_Write(WDT_COUNTER_RESET_LED, HIGH);
-    disable_global_interrupt(); 	// Disable interrupts
+#if (BOOT_FAST_MODE == 1)
+    wdt_reset();
+    WDGDrv_RefreshSeen = 0;
+    WDGDrv_WindowViolation = 0;
+    MCUSR &= ~(1 << WDRF);
+    WDGDrv_Configure(RunCfg_Active.WdtTimeout, WDGDRV_DEFAULT_MODE);
+#else
+    uint8 sreg;
+
+    CRITSEC_ENTER(CRITSEC_SITE_WDGDRV_INIT, sreg); 	// Disable interrupts
     wdt_reset();
+    WDGDrv_RefreshSeen = 0;
+    WDGDrv_WindowViolation = 0;
     // Clear watchdog reset flag
     MCUSR &= ~(1 << WDRF);
     // clear the register to avoid any garbage values
     WDTCSR = 0x00;
-    // Enable watchdog timer (change enable bit must be set in a timed sequence)
-    WDTCSR |= (1 << WDCE) | (1 << WDE);
     // Enable interrupt mode, watchdog enable, and pre-scaler "WDP1 -> 64ms"
-    WDTCSR = (1 << WDIE) | (1 << WDE) | (1 << WDP1); // 0b01001010
-    sei();
-    GPIO_Write(WDT_COUNTER_RESET_LED, LOW);
+    WDGDrv_Configure(RunCfg_Active.WdtTimeout, WDGDRV_DEFAULT_MODE);
+    CRITSEC_EXIT(CRITSEC_SITE_WDGDRV_INIT, sreg);
     enable_global_interrupt();		// Enable interrupts
+#endif
+    GPIO_Write(WDT_COUNTER_RESET_LED, LOW);
 }
 
 
@@ -67,25 +89,131 @@ void WDGDrv_Init(void) {
  * if the function not stacked and the status of the WDT is ok so the 64ms
  * the WDG counter/timeout will reset and start from the first point
  * and also check the providedState of the WDG
+ *
+ * Window mode: every call is time stamped with the 1ms tick (Timer2). A call earlier than
+ * WDGDRV_WINDOW_OPEN_MS after the previous one (runaway code re-entering the refresh path)
+ * latches WDGDrv_WindowViolation and the dog is never refreshed again. Called from the
+ * Timer1 ISR so millis is read atomically; the 16-bit difference costs a few cycles and
+ * stays correct over the wrap of millis.
+ *
+ * WDGM_MainFunction_Stuck is consumed here: it is set back to OK (not completed) after
+ * every notification, WDGM_MainFunction (every 20ms) sets it to NOK when it completes.
+ * A notification preempting WDGM_MainFunction still refreshes on the previous run.
  */
 void WDGDrv_IsrNotification(void) {
+	FAULTINJ_POINT(FAULTINJ_POINT_WDGDRV_NOTIFICATION);
+
+#if (WDGDRV_WINDOW_MODE_ENABLED == 1)
+	uint16 now = (uint16)millis;
+
+	if (WDGDrv_RefreshSeen && (uint16)(now - WDGDrv_LastRefreshMs) < WDGDRV_WINDOW_OPEN_MS) {
+		WDGDrv_WindowViolation = 1;
+	}
+	WDGDrv_LastRefreshMs = now;
+	FAULTINJ_CORRUPT(FAULTINJ_POINT_WDGDRV_NOTIFICATION, WDGDrv_LastRefreshMs);
+	WDGDrv_RefreshSeen = 1;
+#endif
+
 	providedStatus = WDGM_ProvideSupervisionStatus();
 
-    if (status == OK && (!providedStatus) &&  WDGM_MainFunction_Stuck) {
-    	GPIO_Write(WDT_COUNTER_RESET_LED, HIGH);
+    if (status == OK && (!providedStatus) &&  WDGM_MainFunction_Stuck && !WDGDrv_WindowViolation) {
+    	GPIO_WRITE_CONST(WDT_COUNTER_RESET_LED, HIGH);
         wdt_reset();
     }
+    /**
+     * Every refresh needs a new complete run of WDGM_MainFunction: without it a main loop
+     * that hangs outside WDGM_MainFunction (or stops calling it) left the flag at its
+     * last value and was refreshed forever (see the fault campaign, make campaign).
+     */
+    WDGM_MainFunction_Stuck = OK;
+    FAULTINJ_STUCK(FAULTINJ_POINT_WDGM_MAIN, WDGM_MainFunction_Stuck);
+}
+
+
+/**
+ * Steps of changing the WDT configuration (timeout and/or mode):
+	1) Compute the new WDTCSR value first, the timed sequence allows only 4 cycles
+	   between the two writes. WDP3 (bit 5) selects the 4s/8s timeouts.
+	2) Save SREG and disable interrupts so no ISR can stretch the timed sequence.
+	3) Refresh the dog: the new (possibly shorter) timeout starts from zero.
+	4) WDRF overrides WDE, it must be cleared before a mode without reset can be set.
+	5) Set WDCE and WDE keeping the current bits: WDE stays set, the dog is never disarmed
+	   while it is being reconfigured.
+	6) Write the new value with WDCE cleared.
+	7) Restore SREG (interrupts are re-enabled only if they were enabled before).
+ * */
+void WDGDrv_Configure(uint8 Timeout, WDGDrv_ModeType Mode) {
+	uint8 value;
+	uint8 sreg;
+
+	if (Timeout > WDTO_8S) {
+		return;		// Not a valid WDTO_xx value, keep the current configuration
+	}
+
+	value = WDGDRV_PRESCALER_BITS(Timeout);
+	if (Mode != WDGDRV_MODE_RESET) {
+		value |= (1 << WDIE);
+	}
+	if (Mode != WDGDRV_MODE_INTERRUPT) {
+		value |= (1 << WDE);
+	}
+
+	CRITSEC_ENTER(CRITSEC_SITE_WDGDRV_CONFIGURE, sreg);
+	wdt_reset();
+	if (!(value & (1 << WDE))) {
+		MCUSR &= ~(1 << WDRF);
+	}
+	WDTCSR |= (1 << WDCE) | (1 << WDE);	// Start timed sequence
+	WDTCSR = value;							// New timeout and mode
+	CRITSEC_EXIT(CRITSEC_SITE_WDGDRV_CONFIGURE, sreg);
+
+	WDGDrv_Timeout = Timeout;
+	WDGDrv_Mode = Mode;
+}
+
+
+/**
+ * @brief:
+ * Change only the timeout and keep the current mode, e.g.
+ * WDGDrv_SetTimeout(WDTO_2S) before a slow EEPROM phase and
+ * WDGDrv_SetTimeout(RunCfg_Active.WdtTimeout) when it is done.
+ */
+void WDGDrv_SetTimeout(uint8 Timeout) {
+	WDGDrv_Configure(Timeout, WDGDrv_Mode);
+}
+
+
+/**
+ * @brief:
+ * Return the configured timeout (WDTO_xx value)
+ */
+uint8 WDGDrv_GetTimeout(void) {
+	return WDGDrv_Timeout;
+}
+
+
+/**
+ * @brief:
+ * Return the configured mode
+ */
+WDGDrv_ModeType WDGDrv_GetMode(void) {
+	return WDGDrv_Mode;
 }
 
 
 /** TO disable the WDG timer steps:
- * 1) Set bit 3 and bit 4 in the same line
- * 2) Clear Bit 3
+ * 1) Clear WDRF, it overrides WDE
+ * 2) Set bit 3 and bit 4 in the same line
+ * 3) Clear Bit 3
  * */
 void WDGDrv_Disable(void) {
-    cli(); // Disable interrupts temporarily
+    uint8 sreg;
 
+    CRITSEC_ENTER(CRITSEC_SITE_WDGDRV_DISABLE, sreg); // Disable interrupts temporarily
+
+    wdt_reset();
+    MCUSR &= ~(1 << WDRF);
     WDTCSR |= (1 << WDCE) | (1 << WDE); // Start timed sequence, disable watchdog
     WDTCSR = 0x00; // Turn off watchdog timer
-    sei(); // Enable interrupts back
+    CRITSEC_EXIT(CRITSEC_SITE_WDGDRV_DISABLE, sreg); // Restore the global interrupt flag
 }
@@ -4,7 +4,7 @@
 /*******************************************************************************
  ******************************   includes Start    ****************************
  *******************************************************************************/
-#include "Std_Types.h"
+#include "Std_types.h"
 #include "WDGM.h"
 #include "stdint.h"
 #include "GPIO.h"
@@ -24,9 +24,6 @@
 /*******************************************************************************
  ******************************   Macros Start      ****************************
  *******************************************************************************/
-// WDG reset Macro
-#define wdt_reset()   __asm__ __volatile__ ("wdr")
-
 #define WDTO_15MS    0
 #define WDTO_30MS    1
 #define WDTO_60MS    2
@@ -38,8 +35,28 @@
 #define WDTO_4S      8
 #define WDTO_8S      9
 
+// Nominal timeout of a WDTO_xx value: 2K WDT oscillator cycles (16ms) doubled per step
+#define WDGDRV_TIMEOUT_MS(timeout)		(16UL << (timeout))
+
+// WDP3 is bit 5, WDP2..WDP0 are bits 2..0 of WDTCSR
+#define WDGDRV_PRESCALER_BITS(timeout)	((((timeout) & 0x08) << 2) | ((timeout) & 0x07))
+
+// Configuration applied by WDGDrv_Init
+#define WDGDRV_DEFAULT_TIMEOUT		WDTO_60MS
+#define WDGDRV_DEFAULT_MODE			WDGDRV_MODE_INTERRUPT_RESET
+
+/**
+ * Software window: WDGDrv_IsrNotification is expected once per Timer1 period (~52.2ms).
+ * A refresh request earlier than WDGDRV_WINDOW_OPEN_MS after the previous one is a fault,
+ * the dog is not refreshed anymore and resets the system. The window closes with the WDT
+ * timeout itself.
+ */
+#define WDGDRV_WINDOW_MODE_ENABLED	1
+#define WDGDRV_REFRESH_PERIOD_MS	(((TIMER1_COMPARE_VALUE + 1UL) * TIMER1_PRESCALER) / (F_CPU / 1000UL))
+#define WDGDRV_WINDOW_OPEN_MS		((WDGDRV_REFRESH_PERIOD_MS * 3UL) / 4UL)
+
 // Define Watchdog Timer Control and Status Register (WDTCSR) address and bits
-#define WDTCSR_ADDR (*(volatile uint8_t *)(0x60))
+#define WDTCSR_ADDR WDTCSR
 #define WDIF 7
 #define WDIE 6
 #define WDP3 5
@@ -59,12 +76,23 @@
  *******************************************************************************/
 
 
+/**
+ * WDT operating modes (WDIE / WDE combination of WDTCSR)
+ */
+typedef enum {
+	WDGDRV_MODE_INTERRUPT = 0,		/* WDIE      : early interrupt on every timeout, never resets   */
+	WDGDRV_MODE_RESET,				/* WDE       : system reset on timeout                          */
+	WDGDRV_MODE_INTERRUPT_RESET		/* WDIE + WDE: interrupt on the first timeout, reset on the next */
+} WDGDrv_ModeType;
+
+
 /*******************************************************************************
  *************************   Global variables Start      ***********************
  *******************************************************************************/
 extern volatile WDGM_StatusType status;
 extern volatile WDGM_StatusType providedStatus;
 extern vuint8 WDGM_MainFunction_Stuck;
+extern vuint8 WDGDrv_WindowViolation;
 /*******************************************************************************
  *************************   Global variables end      ***********************
  *******************************************************************************/
@@ -75,13 +103,22 @@ extern vuint8 WDGM_MainFunction_Stuck;
  *******************************************************************************/
 // Global interrupt registers setting functions
 void enable_global_interrupt(void);
-void disable_global_interrupt(void);
 
 
 // WDG driver functions
 void WDGDrv_Init(void);
 void WDGDrv_IsrNotification(void);
 void WDGDrv_Disable(void);
+
+/**
+ * Select the timeout (WDTO_15MS .. WDTO_8S) and the mode. Safe to call at runtime, e.g. a
+ * long timeout around slow boot/EEPROM phases and the tight default one in steady state:
+ * the dog is refreshed and stays armed during the whole timed sequence.
+ */
+void WDGDrv_Configure(uint8 Timeout, WDGDrv_ModeType Mode);
+void WDGDrv_SetTimeout(uint8 Timeout);
+uint8 WDGDrv_GetTimeout(void);
+WDGDrv_ModeType WDGDrv_GetMode(void);
 /*******************************************************************************
  *************************   Functions prototype start   ***********************
  *******************************************************************************/
@@ -0,0 +1,212 @@
+/*
+ * bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Cycle benchmark of the periodic firmware functions, linked with the firmware modules
+ * instead of src/main.c. Every case is timed with Timer1 counting CPU cycles, the worst of
+ * BENCH_RUNS runs minus the cost of an empty call is reported. Results go out on USART0 TX
+ * (9600 baud 8N1) as "BENCH <name> <cycles>" lines, then the CPU sleeps with interrupts off
+ * (simavr stops there). On the host simulator the numbers follow its register access
+ * timing model, not the compiled code.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "Std_types.h"
+#include "timer.h"
+#include "WDGM.h"
+#include "LEDM.h"
+#include "FlashCrc.h"
+#include "StackMon.h"
+#include "SafeState.h"
+#include "CrashDump.h"
+#include "RunCfg.h"
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define BENCH_BAUD				9600UL
+#define BENCH_UBRR				((F_CPU + 4UL * BENCH_BAUD) / (8UL * BENCH_BAUD) - 1)
+#define BENCH_RUNS				8
+#define BENCH_FLASH_BYTES		64			// Bytes per FlashCrc_Update case
+#define BENCH_SATURATED			0xFFFF		// Timer1 overflowed during the case
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+typedef void (*Bench_FunctionType)(void);
+
+typedef struct {
+	const char *Name;
+	Bench_FunctionType Setup;		/* Not timed, may be NULL */
+	Bench_FunctionType Function;
+} Bench_CaseType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static volatile uint16 Bench_Sink;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+static void Bench_Empty(void) {
+}
+
+static void Bench_HalGetTick(void) {
+	Bench_Sink = (uint16)HAL_GetTick();
+}
+
+static void Bench_WindowSetup(void) {
+	uint8 i;
+
+	// Close a window on the next call, with a healthy LEDM entity
+	millis += WDGM_PERIOD_MS;
+	for (i = 0; i < (LEDM_CALLS_OK_MIN + LEDM_CALLS_OK_MAX) / 2; i++) {
+		WDGM_AlivenessIndication();
+	}
+}
+
+static void Bench_FlashCrc(void) {
+	uint16 crc = FLASHCRC_INIT;
+	uint16 address;
+
+	for (address = 0; address < BENCH_FLASH_BYTES; address++) {
+		crc = FlashCrc_Update(crc, pgm_read_byte(address));
+	}
+	Bench_Sink = crc;
+}
+
+
+static const Bench_CaseType Bench_Cases[] = {
+	{ "HAL_GetTick",             NULL,              Bench_HalGetTick      },
+	{ "WDGM_MainFunction",       NULL,              WDGM_MainFunction     },
+	{ "WDGM_MainFunction_window", Bench_WindowSetup, WDGM_MainFunction    },
+	{ "LEDM_Manage",             NULL,              LEDM_Manage           },
+	{ "StackMon_MainFunction",   NULL,              StackMon_MainFunction },
+	{ "FlashCrc_Update_64",      NULL,              Bench_FlashCrc        },
+	{ "SafeState_Apply",         NULL,              SafeState_Apply       },
+	{ "CrashDump_Capture",       NULL,              CrashDump_Capture     },
+};
+
+
+/**
+ * @brief CPU cycles of one call, Timer1 runs without prescaler.
+ */
+static uint16 Bench_Measure(Bench_FunctionType Function) {
+	uint16 start;
+	uint16 end;
+
+	TIFR1 = (1 << TOV1);
+	TCNT1 = 0;
+	start = TCNT1;
+	Function();
+	end = TCNT1;
+	if (TIFR1 & (1 << TOV1)) {
+		return BENCH_SATURATED;
+	}
+	return end - start;
+}
+
+
+static void Bench_PutChar(char Data) {
+	while (!(UCSR0A & (1 << UDRE0))) {
+	}
+	UDR0 = Data;
+}
+
+
+static void Bench_PutString(const char *String) {
+	while (*String) {
+		Bench_PutChar(*String++);
+	}
+}
+
+
+static void Bench_PutNumber(uint16 Value) {
+	char digits[5];
+	uint8 count = 0;
+
+	do {
+		digits[count++] = (char)('0' + Value % 10);
+		Value /= 10;
+	} while (Value);
+	while (count) {
+		Bench_PutChar(digits[--count]);
+	}
+}
+
+
+int main(void) {
+	uint16 overhead = 0xFFFF;
+	uint8 i;
+	uint8 run;
+
+	cli();
+	RunCfg_Init();
+	LEDM_Init();
+	WDGM_Init();
+	CrashDump_Init();
+
+	// Timer1 normal mode, clk/1: TCNT1 counts CPU cycles
+	TIMSK1 = 0;
+	TCCR1A = 0;
+	TCCR1B = (1 << CS10);
+
+	UBRR0 = BENCH_UBRR;
+	UCSR0A = (1 << U2X0);
+	UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+	UCSR0B = (1 << TXEN0);
+
+	for (run = 0; run < BENCH_RUNS; run++) {
+		uint16 cycles = Bench_Measure(Bench_Empty);
+		if (cycles < overhead) {
+			overhead = cycles;
+		}
+	}
+
+	for (i = 0; i < sizeof(Bench_Cases) / sizeof(Bench_Cases[0]); i++) {
+		uint16 worst = 0;
+
+		for (run = 0; run < BENCH_RUNS; run++) {
+			uint16 cycles;
+
+			if (Bench_Cases[i].Setup) {
+				Bench_Cases[i].Setup();
+			}
+			cycles = Bench_Measure(Bench_Cases[i].Function);
+			if (cycles != BENCH_SATURATED) {
+				cycles -= overhead;
+			}
+			if (cycles > worst) {
+				worst = cycles;
+			}
+		}
+		Bench_PutString("BENCH ");
+		Bench_PutString(Bench_Cases[i].Name);
+		Bench_PutChar(' ');
+		Bench_PutNumber(worst);
+		Bench_PutString("\r\n");
+	}
+
+	// Let the last byte leave the shift register
+	UCSR0A = (1 << U2X0) | (1 << TXC0);
+	Bench_PutChar('\n');
+	while (!(UCSR0A & (1 << TXC0))) {
+	}
+
+#if defined(__AVR__)
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+	sleep_cpu();
+#endif
+	return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Boot.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "Boot.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// Written in .init3, before .bss is cleared
+static uint8 Boot_ResetFlags NOINIT;
+
+static uint32 Boot_PhaseUs[BOOT_PHASE_COUNT];
+static uint16 Boot_Timer1Overflows = 0;		// Timer1 overflows while counting CPU cycles
+static uint32 Boot_HandOverUs = 0;			// Boot time when timers_init took Timer1 over
+static uint8  Boot_TimerReleased = 0;
+static uint8  Boot_Operational = 0;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+#define BOOT_CYCLES_PER_US		(F_CPU / 1000000UL)
+#define BOOT_TIMER2_TICK_US		((TIMER2_PRESCALER * 1000UL) / (F_CPU / 1000UL))
+
+
+/**
+ * @brief Startup hook, runs from .init3 right after the stack pointer is set up.
+ *
+ * Saves the reset cause and clears MCUSR (avr-libc get_mcusr idiom): the flags are only
+ * cleared by software, a later brown-out would otherwise still show this boot's PORF.
+ * Starts Timer1 without prescaler (normal mode) so TCNT1 counts CPU cycles from here until
+ * timers_init takes the timer over. Only the few cycles of .init0..2 before it are not
+ * measured. The dog is refreshed: after a watchdog reset it runs
+ * with the 16ms reset value of the prescaler until WDGDrv_Init.
+ */
+#if defined(__AVR__)
+void Boot_EarlyInit(void) __attribute__((naked, used, section(".init3")));
+#endif
+void Boot_EarlyInit(void) {
+	Boot_ResetFlags = MCUSR;
+	MCUSR = 0;					// The flags add up across resets until cleared
+	wdt_reset();
+	TCCR1B = (1 << CS10);
+}
+
+
+/**
+ * @brief Microseconds since Boot_EarlyInit.
+ *
+ * Before Boot_ReleaseTimer: TCNT1 (CPU cycles) extended with its overflows.
+ * After: hand-over time plus the 1ms tick (millis) and TCNT2 for the fraction of a tick.
+ */
+static uint32 Boot_NowUs(void) {
+	uint32 now;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_BOOT_NOW, sreg);
+	if (!Boot_TimerReleased) {
+		uint16 cycles = TCNT1;
+		if (TIFR1 & (1 << TOV1)) {
+			TIFR1 = (1 << TOV1);
+			Boot_Timer1Overflows++;
+			cycles = TCNT1;
+		}
+		now = (((uint32)Boot_Timer1Overflows << 16) + cycles) / BOOT_CYCLES_PER_US;
+	} else {
+		uint8 ticks = TCNT2;
+		uint32 ms = millis;
+		// Compare match already happened but TIMER2_COMPA_vect did not run yet
+		if ((TIFR2 & (1 << OCF2A)) && ticks < (TIMER2_COMPARE_VALUE / 2)) {
+			ms++;
+		}
+		now = Boot_HandOverUs + (ms * TIMER2_PERIOD_US) + ((uint32)ticks * BOOT_TIMER2_TICK_US);
+	}
+	CRITSEC_EXIT(CRITSEC_SITE_BOOT_NOW, sreg);
+	return now;
+}
+
+
+/**
+ * @brief Time stamps a boot phase.
+ */
+void Boot_MarkPhase(Boot_PhaseType Phase) {
+	Boot_PhaseUs[Phase] = Boot_NowUs();
+}
+
+
+/**
+ * @brief Stops the cycle counter and gives Timer1 back in its reset state to timers_init.
+ *
+ * Marks BOOT_PHASE_TIMERS. Must be called right before timers_init, a running TCNT1 above
+ * TIMER1_COMPARE_VALUE would otherwise delay the first compare match (WDG refresh).
+ */
+void Boot_ReleaseTimer(void) {
+	Boot_MarkPhase(BOOT_PHASE_TIMERS);
+	Boot_HandOverUs = Boot_PhaseUs[BOOT_PHASE_TIMERS];
+	TCCR1B = 0;
+	TCNT1 = 0;
+	TIFR1 = (1 << TOV1);
+	Boot_TimerReleased = 1;
+}
+
+
+/**
+ * @brief Marks the first supervised LEDM_Manage call, later calls return immediately.
+ */
+void Boot_MarkOperational(void) {
+	if (!Boot_Operational) {
+		Boot_MarkPhase(BOOT_PHASE_OPERATIONAL);
+		Boot_Operational = 1;
+	}
+}
+
+
+/**
+ * @brief Reset-to-operational time (recovery time after a watchdog reset), 0 until known.
+ */
+uint32 Boot_GetTimeToOperationalUs(void) {
+	return Boot_Operational ? Boot_PhaseUs[BOOT_PHASE_OPERATIONAL] : 0;
+}
+
+
+/**
+ * @brief Copies all the boot phase time stamps and the reset cause.
+ */
+void Boot_GetReport(Boot_ReportType *Report) {
+	uint8 i;
+
+	for (i = 0; i < BOOT_PHASE_COUNT; i++) {
+		WCET_LOOP_BOUND(BOOT_PHASE_COUNT);
+		Report->PhaseUs[i] = Boot_PhaseUs[i];
+	}
+	Report->ResetFlags = Boot_ResetFlags;
+}
+
+
+/**
+ * @brief MCUSR as it was at reset, the causes of this reset only (Boot_EarlyInit clears it).
+ */
+uint8 Boot_GetResetFlags(void) {
+	return Boot_ResetFlags;
+}
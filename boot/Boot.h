@@ -0,0 +1,73 @@
+/*
+ * Boot.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef BOOT_H_
+#define BOOT_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/wdt.h>
+#include "Std_types.h"
+#include "timer.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> fast-boot init path: GPIO_Init/timers_init/WDGDrv_Init write their registers once
+ * instead of read-modify-write sequences, Buzzer_Init is skipped (GPIO_Init covers the
+ * buzzer pin), interrupts are enabled once by main() after all the init functions and the
+ * first supervised LEDM_Manage call runs without waiting for its first period.
+ * 0 -> the original init path (built by the os-fast-boot variant and test_reset_timing_fastboot
+ * for the fast one).
+ */
+#ifndef BOOT_FAST_MODE
+#define BOOT_FAST_MODE			0
+#endif
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Boot phases, time stamped in microseconds since the .init3 startup hook
+ */
+typedef enum {
+	BOOT_PHASE_MAIN = 0,		/* main() entered: .data/.bss initialized          */
+	BOOT_PHASE_DRIVERS,			/* Buzzer/CrashDump/LEDM/GPIO initialized          */
+	BOOT_PHASE_TIMERS,			/* Timer1 handed over to timers_init               */
+	BOOT_PHASE_SUPERVISION,		/* Timers, WDG driver and WDGM initialized         */
+	BOOT_PHASE_OPERATIONAL,		/* First supervised LEDM_Manage call done          */
+	BOOT_PHASE_COUNT
+} Boot_PhaseType;
+
+typedef struct {
+	uint32 PhaseUs[BOOT_PHASE_COUNT];
+	uint8  ResetFlags;			/* MCUSR at startup (WDRF, BORF, EXTRF, PORF) */
+} Boot_ReportType;
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void Boot_MarkPhase(Boot_PhaseType Phase);
+void Boot_ReleaseTimer(void);
+void Boot_MarkOperational(void);
+uint32 Boot_GetTimeToOperationalUs(void);
+void Boot_GetReport(Boot_ReportType *Report);
+uint8 Boot_GetResetFlags(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* BOOT_H_ */
@@ -10,7 +10,7 @@
 /*******************************************************************************
  ******************************   includes Start    ****************************
  *******************************************************************************/
-#include "Std_Types.h"
+#include "Std_types.h"
 #include "GPIO.h"
 /*******************************************************************************
  ******************************   includes End      ****************************
@@ -0,0 +1,254 @@
+/*
+ * fault_campaign.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Fault-injection campaign on the host simulator. The firmware is built with
+ * FAULTINJ_ENABLED=1 and every fault class (fault x injection point, see FaultInj.h) is
+ * armed at several instants of a running system, spread over a few Timer1 periods and
+ * WDGM windows so that every phase between the fault and the supervision is covered.
+ *
+ * For every run the time from the injection to the safe state is measured: the first
+ * SafeState_Apply (WDGM window NOK or WDT early-warning interrupt) or the watchdog reset
+ * when no interrupt could apply it (e.g. a stalled ISR). The report gives the latency
+ * distribution of every fault class and the worst case over all classes:
+ *
+ *   fault_campaign [injections]     markdown report on stdout (make campaign)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "FaultInj.h"
+#include "WDGM.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define WDT_VECTOR					6
+
+// First injection after the system is up, then one every INJECT_STEP_US
+#define INJECT_FIRST_US				500000UL
+#define INJECT_STEP_US				13100UL		// Not a divisor of 52.2ms nor 100ms
+#define INJECTIONS_DEFAULT			16
+#define INJECTIONS_MAX				64
+
+// A fault not brought to the safe state within this time counts as not detected
+#define DETECTION_LIMIT_US			1000000UL
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+typedef struct {
+	const char *Name;
+	FaultInj_PointType Point;
+	FaultInj_FaultType Fault;
+	uint16 Param;
+} FaultClassType;
+
+typedef struct {
+	uint64_t InjectUs;
+	uint64_t SafeStateUs;	// First SafeState_Apply after the injection, 0: none
+	uint64_t ExpiryUs;		// First WDT interrupt after the injection, 0: none
+} ObservedType;
+
+typedef struct {
+	uint32_t Detected;
+	uint64_t SafeUs[INJECTIONS_MAX];		// Injection to safe state
+	uint64_t ResetUs[INJECTIONS_MAX];		// Injection to watchdog reset, 0: none
+} ClassResultType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static const FaultClassType Campaign_Classes[] = {
+	{ "LEDM_Manage stall",              FAULTINJ_POINT_LEDM_MANAGE,         FAULTINJ_FAULT_STALL,      0    },
+	{ "LEDM_Manage skip",               FAULTINJ_POINT_LEDM_MANAGE,         FAULTINJ_FAULT_SKIP,       0    },
+	{ "LEDM_Manage delay 30ms",         FAULTINJ_POINT_LEDM_MANAGE,         FAULTINJ_FAULT_DELAY,      30   },
+	{ "LEDM_Manage timeToggle +250",    FAULTINJ_POINT_LEDM_MANAGE,         FAULTINJ_FAULT_CORRUPT,    250  },
+	{ "WDGM_MainFunction stall",        FAULTINJ_POINT_WDGM_MAIN,           FAULTINJ_FAULT_STALL,      0    },
+	{ "WDGM_MainFunction skip",         FAULTINJ_POINT_WDGM_MAIN,           FAULTINJ_FAULT_SKIP,       0    },
+	{ "WDGM_MainFunction delay 30ms",   FAULTINJ_POINT_WDGM_MAIN,           FAULTINJ_FAULT_DELAY,      30   },
+	{ "WDGM last_time_checked +1000",   FAULTINJ_POINT_WDGM_MAIN,           FAULTINJ_FAULT_CORRUPT,    1000 },
+	{ "WDGM_MainFunction_Stuck at 0",   FAULTINJ_POINT_WDGM_MAIN,           FAULTINJ_FAULT_STUCK_FLAG, OK   },
+	{ "WDGM_MainFunction_Stuck at 1",   FAULTINJ_POINT_WDGM_MAIN,           FAULTINJ_FAULT_STUCK_FLAG, NOK  },
+	{ "WDGM_AlivenessIndication stall", FAULTINJ_POINT_WDGM_ALIVENESS,      FAULTINJ_FAULT_STALL,      0    },
+	{ "WDGM_AlivenessIndication skip",  FAULTINJ_POINT_WDGM_ALIVENESS,      FAULTINJ_FAULT_SKIP,       0    },
+	{ "WDGM_AlivenessIndication delay 30ms", FAULTINJ_POINT_WDGM_ALIVENESS, FAULTINJ_FAULT_DELAY,      30   },
+	{ "LEDM call count +20",            FAULTINJ_POINT_WDGM_ALIVENESS,      FAULTINJ_FAULT_CORRUPT,    20   },
+	{ "Timer1 ISR stall",               FAULTINJ_POINT_TIMER1_ISR,          FAULTINJ_FAULT_STALL,      0    },
+	{ "Timer1 ISR skip",                FAULTINJ_POINT_TIMER1_ISR,          FAULTINJ_FAULT_SKIP,       0    },
+	{ "Timer1 ISR delay 30ms",          FAULTINJ_POINT_TIMER1_ISR,          FAULTINJ_FAULT_DELAY,      30   },
+	{ "Timer1 timer1Wraps +1",          FAULTINJ_POINT_TIMER1_ISR,          FAULTINJ_FAULT_CORRUPT,    1    },
+	{ "Timer2 ISR stall",               FAULTINJ_POINT_TIMER2_ISR,          FAULTINJ_FAULT_STALL,      0    },
+	{ "Timer2 ISR skip",                FAULTINJ_POINT_TIMER2_ISR,          FAULTINJ_FAULT_SKIP,       0    },
+	{ "Timer2 ISR delay 30ms",          FAULTINJ_POINT_TIMER2_ISR,          FAULTINJ_FAULT_DELAY,      30   },
+	{ "Timer2 millis +1000",            FAULTINJ_POINT_TIMER2_ISR,          FAULTINJ_FAULT_CORRUPT,    1000 },
+	{ "WDGDrv_IsrNotification stall",   FAULTINJ_POINT_WDGDRV_NOTIFICATION, FAULTINJ_FAULT_STALL,      0    },
+	{ "WDGDrv_IsrNotification skip",    FAULTINJ_POINT_WDGDRV_NOTIFICATION, FAULTINJ_FAULT_SKIP,       0    },
+	{ "WDGDrv_IsrNotification delay 30ms", FAULTINJ_POINT_WDGDRV_NOTIFICATION, FAULTINJ_FAULT_DELAY,   30   },
+	{ "WDGDrv last refresh +40",        FAULTINJ_POINT_WDGDRV_NOTIFICATION, FAULTINJ_FAULT_CORRUPT,    40   },
+};
+
+#define CAMPAIGN_CLASS_COUNT		(sizeof(Campaign_Classes) / sizeof(Campaign_Classes[0]))
+
+static const FaultClassType *Campaign_Class;	// Class of the running boot (inherited by the fork)
+static ObservedType *Observed;
+static ClassResultType Campaign_Results[CAMPAIGN_CLASS_COUNT];
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_SafeState_Apply(void);
+
+void __wrap_SafeState_Apply(void) {
+	if (Observed->InjectUs && !Observed->SafeStateUs) {
+		Observed->SafeStateUs = sim_now_us();
+	}
+	__real_SafeState_Apply();
+}
+
+
+static void Vector_Hook(uint8_t Vector) {
+	if (Vector == WDT_VECTOR && Observed->InjectUs && !Observed->ExpiryUs) {
+		Observed->ExpiryUs = sim_now_us();
+	}
+}
+
+
+static void Inject_Hook(void) {
+	if (!Observed->InjectUs) {
+		Observed->InjectUs = sim_now_us();
+		FaultInj_Arm(Campaign_Class->Point, Campaign_Class->Fault, Campaign_Class->Param);
+	}
+}
+
+
+/**
+ * @brief One boot from power-on with the fault armed at InjectUs.
+ *
+ * @return The boot exit, Result holds the end of the boot.
+ */
+static SimExitType Campaign_Run(const FaultClassType *Class, uint32_t InjectUs, SimBootResultType *Result) {
+	Campaign_Class = Class;
+	Observed->InjectUs = 0;
+	Observed->SafeStateUs = 0;
+	Observed->ExpiryUs = 0;
+	sim_set_vector_hook(Vector_Hook);
+	sim_set_hook(Class ? Inject_Hook : NULL, InjectUs);
+	return sim_boot(SIM_RESET_POWER_ON, (uint64_t)InjectUs + DETECTION_LIMIT_US, Result);
+}
+
+
+static int Compare_Us(const void *A, const void *B) {
+	uint64_t a = *(const uint64_t *)A;
+	uint64_t b = *(const uint64_t *)B;
+
+	return (a > b) - (a < b);
+}
+
+
+/**
+ * @brief Percentile (nearest rank) of a sorted set of latencies.
+ */
+static uint64_t Percentile(const uint64_t *Sorted, uint32_t Count, uint32_t Percent) {
+	uint32_t rank = (Count * Percent + 99) / 100;
+
+	return Sorted[rank ? rank - 1 : 0];
+}
+
+
+static void Print_Ms(uint64_t Us) {
+	printf(" %7.1f |", Us / 1000.0);
+}
+
+
+int main(int argc, char **argv) {
+	uint32_t injections = (argc > 1) ? (uint32_t)atoi(argv[1]) : INJECTIONS_DEFAULT;
+	uint64_t worstUs = 0;
+	uint32_t undetected = 0;
+	const char *worstClass = "-";
+	SimBootResultType result;
+	SimExitType exit;
+	uint32_t c, i;
+
+	if (injections == 0 || injections > INJECTIONS_MAX) {
+		injections = INJECTIONS_DEFAULT;
+	}
+	Observed = (ObservedType *)sim_shared();
+
+	// Reference run: the supervision must stay quiet without a fault
+	exit = Campaign_Run(NULL, INJECT_FIRST_US, &result);
+	if (exit != SIM_EXIT_STOPPED || Observed->SafeStateUs || Observed->ExpiryUs) {
+		printf("reference run without fault is not clean (exit %d)\n", exit);
+		return 1;
+	}
+
+	for (c = 0; c < CAMPAIGN_CLASS_COUNT; c++) {
+		ClassResultType *res = &Campaign_Results[c];
+
+		for (i = 0; i < injections; i++) {
+			uint32_t injectUs = INJECT_FIRST_US + i * INJECT_STEP_US;
+			uint64_t safeUs = 0;
+
+			exit = Campaign_Run(&Campaign_Classes[c], injectUs, &result);
+			res->ResetUs[i] = (exit == SIM_EXIT_WATCHDOG_RESET) ? result.EndUs - Observed->InjectUs : 0;
+			if (Observed->SafeStateUs) {
+				safeUs = Observed->SafeStateUs - Observed->InjectUs;
+			} else if (res->ResetUs[i]) {
+				safeUs = res->ResetUs[i];		// No interrupt could apply it, the reset did
+			}
+			if (safeUs) {
+				res->SafeUs[res->Detected++] = safeUs;
+			}
+		}
+	}
+
+	printf("# Fault campaign: injection to safe state\n\n");
+	printf("%u injections per class, from %lu ms every %.1f ms, limit %lu ms.\n"
+		   "Latencies in ms over the detected runs.\n\n",
+		   (unsigned)injections, INJECT_FIRST_US / 1000UL, INJECT_STEP_US / 1000.0,
+		   DETECTION_LIMIT_US / 1000UL);
+	printf("| Fault class | Detected | min | median | p90 | max | max to reset |\n");
+	printf("|---|---|---|---|---|---|---|\n");
+	for (c = 0; c < CAMPAIGN_CLASS_COUNT; c++) {
+		ClassResultType *res = &Campaign_Results[c];
+		uint64_t sorted[INJECTIONS_MAX];	// The results are packed, sort an aligned copy
+		uint64_t resetMax = 0;
+
+		for (i = 0; i < injections; i++) {
+			if (res->ResetUs[i] > resetMax) {
+				resetMax = res->ResetUs[i];
+			}
+		}
+		printf("| %s | %u/%u |", Campaign_Classes[c].Name, (unsigned)res->Detected, (unsigned)injections);
+		if (res->Detected) {
+			memcpy(sorted, res->SafeUs, res->Detected * sizeof(sorted[0]));
+			qsort(sorted, res->Detected, sizeof(sorted[0]), Compare_Us);
+			Print_Ms(sorted[0]);
+			Print_Ms(Percentile(sorted, res->Detected, 50));
+			Print_Ms(Percentile(sorted, res->Detected, 90));
+			Print_Ms(sorted[res->Detected - 1]);
+			if (sorted[res->Detected - 1] > worstUs) {
+				worstUs = sorted[res->Detected - 1];
+				worstClass = Campaign_Classes[c].Name;
+			}
+		} else {
+			printf("   - |   - |   - |   - |");
+		}
+		if (resetMax) {
+			Print_Ms(resetMax);
+		} else {
+			printf("   - |");
+		}
+		printf("\n");
+		undetected += injections - res->Detected;
+	}
+	printf("\nWorst-case time to safe state: %.1f ms (%s)\n", worstUs / 1000.0, worstClass);
+	printf("Runs not brought to the safe state: %u of %u\n", (unsigned)undetected,
+		   (unsigned)(injections * CAMPAIGN_CLASS_COUNT));
+	return 0;
+}
@@ -0,0 +1,218 @@
+/*
+ * CrashDump.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "CrashDump.h"
+#include <stddef.h>
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// Written by the WDT early-warning ISR, kept over the watchdog reset
+static CrashDump_RecordType CrashDump_Record NOINIT;
+
+// Copy of a valid record found at boot
+static CrashDump_RecordType CrashDump_LastRecord;
+static uint8 CrashDump_Available = 0;
+
+static uint8 CrashDump_TraceBuffer[CRASHDUMP_TRACE_LEN];
+static uint8 CrashDump_TraceIndex = 0;
+static volatile uint8 CrashDump_ActiveTask = CRASHDUMP_TASK_IDLE;
+
+// Filled by the naked WDT_vect entry stub before anything touches SREG or the stack. Only
+// the stub's inline asm names them: "used" keeps LTO from renaming or dropping them
+volatile uint8 CrashDump_EntrySreg __attribute__((used));
+volatile uint16 CrashDump_EntrySp __attribute__((used));
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+/**
+ * Bytes pushed by the entry stub (r0 and SREG) on top of the return address.
+ * The return address is stored high byte first: [SP + 3] = PC high, [SP + 4] = PC low.
+ */
+#define CRASHDUMP_STUB_PUSHES	2
+
+// Called by name from the WDT_vect stub only, LTO does not see that reference
+void CrashDump_Capture(void) __attribute__((used));
+
+
+/**
+ * @brief CRC16-CCITT of the record without its Crc field.
+ */
+static uint16 CrashDump_Crc(const CrashDump_RecordType *Record) {
+	const uint8 *data = (const uint8 *)Record;
+	uint16 crc = 0xFFFF;
+	uint8 i;
+
+	for (i = 0; i < offsetof(CrashDump_RecordType, Crc); i++) {
+		WCET_LOOP_BOUND(offsetof(CrashDump_RecordType, Crc));
+		crc = _crc_ccitt_update(crc, data[i]);
+	}
+	return crc;
+}
+
+
+/**
+ * @brief Looks for a post-mortem left by the previous run.
+ *
+ * Must be called at boot before the WDT early-warning interrupt can fire again. A record
+ * with a valid magic and CRC is published (CrashDump_GetLastRecord) and then consumed, so
+ * the same crash is never reported twice. After a power-on the .noinit content is random
+ * and fails the check.
+ *
+ * @return None
+ */
+void CrashDump_Init(void) {
+	CrashDump_Available = 0;
+	if (CrashDump_Record.Magic == CRASHDUMP_MAGIC &&
+		CrashDump_Record.Crc == CrashDump_Crc(&CrashDump_Record)) {
+		CrashDump_LastRecord = CrashDump_Record;
+		CrashDump_Available = 1;
+	}
+	CrashDump_Record.Magic = 0;
+	CrashDump_TraceIndex = 0;
+	CrashDump_ActiveTask = CRASHDUMP_TASK_IDLE;
+}
+
+
+/**
+ * @brief Copies the post-mortem found at boot.
+ *
+ * @param Record Destination of the copy.
+ * @return 1 if the previous run left a valid record, 0 otherwise.
+ */
+uint8 CrashDump_GetLastRecord(CrashDump_RecordType *Record) {
+	if (CrashDump_Available) {
+		*Record = CrashDump_LastRecord;
+	}
+	return CrashDump_Available;
+}
+
+
+/**
+ * @brief Appends one event to the trace ring (superloop context).
+ */
+void CrashDump_Trace(uint8 Event) {
+	CrashDump_TraceBuffer[CrashDump_TraceIndex] = Event;
+	CrashDump_TraceIndex = (CrashDump_TraceIndex + 1) & (CRASHDUMP_TRACE_LEN - 1);
+}
+
+
+/**
+ * @brief Marks the start of a superloop task, the task is also traced.
+ */
+void CrashDump_EnterTask(uint8 Task) {
+	CrashDump_ActiveTask = Task;
+	CrashDump_Trace(Task);
+}
+
+
+/**
+ * @brief Marks the end of the running superloop task.
+ */
+void CrashDump_LeaveTask(void) {
+	CrashDump_ActiveTask = CRASHDUMP_TASK_IDLE;
+}
+
+
+/**
+ * @brief Fills the .noinit record, called from the WDT_vect stub only.
+ *
+ * In interrupt-then-reset mode the reset follows one more WDT timeout after this interrupt
+ * (at least ~16ms with WDTO_15MS). The capture is a few hundred cycles, its measured cost is
+ * stored in the record (Timer1 resolution: TIMER1_PRESCALER cycles). MCU_reset_LED is high
+ * for the duration of the capture.
+ *
+ * @return None
+ */
+void CrashDump_Capture(void) {
+	uint16 start = TCNT1;
+	uint16 end;
+#if defined(__AVR__)
+	const uint8 *frame = (const uint8 *)CrashDump_EntrySp;
+#endif
+	uint8 i;
+	uint8 index;
+
+	// Actuators first, the snapshot can wait a few microseconds
+	SafeState_Apply();
+	GPIO_Write(MCU_reset_LED, HIGH);
+
+	CrashDump_Record.Magic = CRASHDUMP_MAGIC;
+#if defined(__AVR__)
+	CrashDump_Record.Pc = ((((uint16)frame[CRASHDUMP_STUB_PUSHES + 1]) << 8)
+							| frame[CRASHDUMP_STUB_PUSHES + 2]) << 1;
+#else
+	CrashDump_Record.Pc = 0;			// No interrupted program counter on the host
+#endif
+	CrashDump_Record.Sp = CrashDump_EntrySp + CRASHDUMP_STUB_PUSHES + 2;
+	// The I-bit is cleared by the interrupt entry, it was set in the interrupted context
+	CrashDump_Record.Sreg = CrashDump_EntrySreg | (1 << 7);
+	CrashDump_Record.ActiveTask = CrashDump_ActiveTask;
+	for (i = 0; i < WDGM_ENTITY_COUNT; i++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		CrashDump_Record.EntityStatus[i] = WDGM_GetEntityStatus(i);
+	}
+	CrashDump_Record.GlobalStatus = status;
+	index = CrashDump_TraceIndex;
+	for (i = 0; i < CRASHDUMP_TRACE_LEN; i++) {
+		WCET_LOOP_BOUND(CRASHDUMP_TRACE_LEN);
+		CrashDump_Record.Trace[i] = CrashDump_TraceBuffer[index];
+		index = (index + 1) & (CRASHDUMP_TRACE_LEN - 1);
+	}
+
+	end = TCNT1;
+	if (end < start) {
+		end += TIMER1_COMPARE_VALUE + 1;	// Timer1 restarted (CTC) during the capture
+	}
+	CrashDump_Record.CaptureCycles = (end - start) * TIMER1_PRESCALER;
+	CrashDump_Record.Crc = CrashDump_Crc(&CrashDump_Record);
+
+	GPIO_Write(MCU_reset_LED, LOW);
+}
+
+
+/**
+ * @brief WDT early-warning interrupt (interrupt-then-reset mode).
+ *
+ * Naked entry: SREG and SP are sampled before any prologue modifies them, then the
+ * call-clobbered registers are saved by hand around CrashDump_Capture.
+ */
+#if defined(__AVR__)
+ISR(WDT_vect, ISR_NAKED) {
+	__asm__ __volatile__ (
+		"push __tmp_reg__                   \n\t"
+		"in   __tmp_reg__, __SREG__         \n\t"
+		"push __tmp_reg__                   \n\t"
+		"sts  CrashDump_EntrySreg, __tmp_reg__ \n\t"
+		"in   __tmp_reg__, __SP_L__         \n\t"
+		"sts  CrashDump_EntrySp, __tmp_reg__   \n\t"
+		"in   __tmp_reg__, __SP_H__         \n\t"
+		"sts  CrashDump_EntrySp+1, __tmp_reg__ \n\t"
+		"push __zero_reg__                  \n\t"
+		"clr  __zero_reg__                  \n\t"
+		"push r18 \n\t push r19 \n\t push r20 \n\t push r21 \n\t"
+		"push r22 \n\t push r23 \n\t push r24 \n\t push r25 \n\t"
+		"push r26 \n\t push r27 \n\t push r30 \n\t push r31 \n\t"
+		"call CrashDump_Capture             \n\t"
+		"pop  r31 \n\t pop  r30 \n\t pop  r27 \n\t pop  r26 \n\t"
+		"pop  r25 \n\t pop  r24 \n\t pop  r23 \n\t pop  r22 \n\t"
+		"pop  r21 \n\t pop  r20 \n\t pop  r19 \n\t pop  r18 \n\t"
+		"pop  __zero_reg__                  \n\t"
+		"pop  __tmp_reg__                   \n\t"
+		"out  __SREG__, __tmp_reg__         \n\t"
+		"pop  __tmp_reg__                   \n\t"
+		"reti                               \n\t"
+		::);
+}
+#else
+ISR(WDT_vect) {
+	CrashDump_EntrySreg = SREG;
+	CrashDump_EntrySp = SP;
+	CrashDump_Capture();
+}
+#endif
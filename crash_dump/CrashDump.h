@@ -0,0 +1,77 @@
+/*
+ * CrashDump.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef CRASHDUMP_H_
+#define CRASHDUMP_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include "Std_types.h"
+#include "GPIO.h"
+#include "timer.h"
+#include "WDGM.h"
+#include "SafeState.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define CRASHDUMP_MAGIC			0xC4A5
+#define CRASHDUMP_TRACE_LEN		8		/* Trace events kept in the snapshot */
+
+// Superloop tasks, recorded as active task and as trace events
+#define CRASHDUMP_TASK_IDLE		0x00
+#define CRASHDUMP_TASK_LEDM		0x01
+#define CRASHDUMP_TASK_WDGM		0x02
+#define CRASHDUMP_TASK_FLASHCRC	0x03
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Post-mortem written by the WDT early-warning interrupt into .noinit, it survives the
+ * watchdog reset and is validated with a CRC16-CCITT by CrashDump_Init on the next boot.
+ */
+typedef struct {
+	uint16 Magic;
+	uint16 Pc;								/* Interrupted program counter (byte address) */
+	uint16 Sp;								/* Stack pointer of the interrupted context   */
+	uint8  Sreg;							/* SREG of the interrupted context            */
+	uint8  ActiveTask;						/* CRASHDUMP_TASK_xx running at the time      */
+	uint8  EntityStatus[WDGM_ENTITY_COUNT];	/* WDGM result of the last closed window      */
+	uint8  GlobalStatus;					/* WDGM global status                         */
+	uint8  Trace[CRASHDUMP_TRACE_LEN];		/* Last trace events, oldest first            */
+	uint16 CaptureCycles;					/* Cost of the capture (Timer1 resolution)    */
+	uint16 Crc;
+} CrashDump_RecordType;
+
+// .noinit layout of the AVR build (the host simulator is built with the same data layout)
+_Static_assert(sizeof(CrashDump_RecordType) == 9 + WDGM_ENTITY_COUNT + CRASHDUMP_TRACE_LEN + 4,
+			   "CrashDump_RecordType layout");
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void CrashDump_Init(void);
+uint8 CrashDump_GetLastRecord(CrashDump_RecordType *Record);
+void CrashDump_Trace(uint8 Event);
+void CrashDump_EnterTask(uint8 Task);
+void CrashDump_LeaveTask(void);
+void CrashDump_Capture(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* CRASHDUMP_H_ */
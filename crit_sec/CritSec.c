@@ -0,0 +1,121 @@
+/*
+ * CritSec.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "CritSec.h"
+
+#if (CRITSEC_INSTRUMENTED == 1)
+#include <string.h>
+#include "timer.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define CRITSEC_TICK_US			((TIMER2_PRESCALER * 1000UL) / (F_CPU / 1000UL))
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// TCNT2 at the entry of the open outermost section (a pending tick counts one period)
+static uint8 CritSec_StartTicks;
+// Written with the interrupts disabled only
+static CritSec_StatsType CritSec_Stats[CRITSEC_SITE_COUNT];
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief TCNT2 extended with the pending compare match (0..63).
+ *
+ * The interrupts are disabled: a compare match during the section sets OCF2A and the
+ * counter starts again from 0. A set flag with a counter in the upper half was already
+ * there at the previous read, same test as Boot_NowUs.
+ */
+static uint8 CritSec_Ticks(void) {
+	uint8 ticks = TCNT2;
+
+	if ((TIFR2 & (1 << OCF2A)) && ticks < (TIMER2_COMPARE_VALUE / 2)) {
+		ticks += TIMER2_COMPARE_VALUE + 1;
+	}
+	return ticks;
+}
+
+
+static uint16 CritSec_Saturate(uint16 Counter) {
+	return (Counter != 0xFFFF) ? (uint16)(Counter + 1) : Counter;
+}
+
+
+/**
+ * @brief Entry of an outermost critical section (CRITSEC_ENTER), interrupts disabled.
+ */
+void CritSec_Start(void) {
+	CritSec_StartTicks = CritSec_Ticks();
+}
+
+
+/**
+ * @brief Exit of an outermost critical section (CRITSEC_EXIT), before SREG is restored.
+ *
+ * Exact as long as at most one compare match happened in the section, i.e. no 1ms tick was
+ * lost: always below one tick period (1024us). A section losing a tick is counted one
+ * period short, the tick latency is what shows it.
+ *
+ * @param Site The call site of the section.
+ */
+void CritSec_Stop(CritSec_SiteType Site) {
+	CritSec_StatsType *stats = &CritSec_Stats[Site];
+	uint8 ticks = (uint8)(CritSec_Ticks() - CritSec_StartTicks);
+	uint16 us = (uint16)(ticks * CRITSEC_TICK_US);
+	uint8 bin = 0;
+
+	while (ticks && bin < CRITSEC_BINS - 1) {
+		WCET_LOOP_BOUND(CRITSEC_BINS - 1);
+		bin++;
+		ticks >>= 1;
+	}
+	stats->Count = CritSec_Saturate(stats->Count);
+	stats->Histogram[bin] = CritSec_Saturate(stats->Histogram[bin]);
+	if (us > stats->MaxUs) {
+		stats->MaxUs = us;
+	}
+}
+
+
+/**
+ * @brief Copies the interrupt-disabled time statistics of one call site.
+ */
+void CritSec_GetSiteStats(CritSec_SiteType Site, CritSec_StatsType *Stats) {
+	uint8 sreg = SREG;
+
+	if (Site >= CRITSEC_SITE_COUNT) {
+		memset(Stats, 0, sizeof(*Stats));
+		return;
+	}
+	// Not measured itself: no site of its own
+	cli();
+	*Stats = CritSec_Stats[Site];
+	SREG = sreg;
+}
+
+
+/**
+ * @brief Clears the statistics of every call site.
+ */
+void CritSec_ResetStats(void) {
+	uint8 sreg = SREG;
+
+	cli();
+	memset(CritSec_Stats, 0, sizeof(CritSec_Stats));
+	SREG = sreg;
+}
+
+#endif /* CRITSEC_INSTRUMENTED */
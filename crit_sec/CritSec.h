@@ -0,0 +1,108 @@
+/*
+ * CritSec.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef CRITSEC_H_
+#define CRITSEC_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Std_types.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> the interrupt-disabled time of every outermost critical section is measured with
+ * TCNT2 (32us resolution) and kept per call site (test and integration builds).
+ * 0 -> CRITSEC_ENTER/CRITSEC_EXIT are the bare SREG save/cli/restore and CritSec.c is empty.
+ */
+#ifndef CRITSEC_INSTRUMENTED
+#define CRITSEC_INSTRUMENTED	0
+#endif
+
+/**
+ * Critical section of one call site, nestable: SREG is saved into Sreg (uint8) and
+ * restored by CRITSEC_EXIT, so the interrupts are enabled again only when they were
+ * enabled at CRITSEC_ENTER (never inside an ISR or during the fast boot).
+ */
+#define CRITSEC_ENTER(Site, Sreg)	do { (Sreg) = SREG; cli(); CRITSEC_START(Sreg); } while (0)
+/**
+ * The memory clobber keeps the compiler from moving accesses of the section past the
+ * restore of SREG (cli() already is a barrier at the entry).
+ */
+#define CRITSEC_EXIT(Site, Sreg)	do { CRITSEC_STOP(Site, Sreg); __asm__ __volatile__ ("" ::: "memory"); SREG = (Sreg); } while (0)
+
+#if (CRITSEC_INSTRUMENTED == 1)
+// Only the outermost section (interrupts were enabled) is measured
+#define CRITSEC_START(Sreg)			do { if ((Sreg) & (1 << SREG_I)) { CritSec_Start(); } } while (0)
+#define CRITSEC_STOP(Site, Sreg)	do { if ((Sreg) & (1 << SREG_I)) { CritSec_Stop(Site); } } while (0)
+#else
+#define CRITSEC_START(Sreg)			do { } while (0)
+#define CRITSEC_STOP(Site, Sreg)	do { } while (0)
+#endif
+
+/**
+ * log2 bins of the disabled time in TCNT2 ticks: 0, 1, 2..3, 4..7, 8..15, 16..31, 32..63
+ * (the measure wraps with a lost 1ms tick, see CritSec_Stop).
+ */
+#define CRITSEC_BINS			7
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Call sites, one per critical section of the firmware.
+ */
+typedef enum {
+	CRITSEC_SITE_HAL_GETTICK = 0,		/* HAL_GetTick: millis                         */
+	CRITSEC_SITE_WDGDRV_INIT,			/* WDGDrv_Init: WDTCSR cleared and configured  */
+	CRITSEC_SITE_WDGDRV_CONFIGURE,		/* WDGDrv_Configure: WDT timed sequence        */
+	CRITSEC_SITE_WDGDRV_DISABLE,		/* WDGDrv_Disable: WDT timed sequence          */
+	CRITSEC_SITE_WDGM_COUNTERS,			/* WDGM_MainFunction: entity call counters     */
+	CRITSEC_SITE_HBMON_READ,			/* HBMon_GetPeriodUs / HBMon_GetPulseWidthUs   */
+	CRITSEC_SITE_REMOTEMON_STATS,		/* RemoteMon_GetNodeStats / GetBusStats        */
+	CRITSEC_SITE_TELEMETRY_SEND,		/* Telemetry frame published to the UDRE ISR   */
+	CRITSEC_SITE_SAFESTATE_APPLY,		/* SafeState_Apply: port writes                */
+	CRITSEC_SITE_EXTWDG,				/* ExtWdg pattern and counters                 */
+	CRITSEC_SITE_BOOT_NOW,				/* Boot_NowUs: timer and its overflow flag     */
+	CRITSEC_SITE_FAULTINJ_ARM,			/* FaultInj_Arm                                */
+	CRITSEC_SITE_EXTI_INIT,				/* Exti_Init: EICRA                            */
+	CRITSEC_SITE_GICR_INIT,				/* Gicr_Init: EICRA and INTx pin direction     */
+	CRITSEC_SITE_TICKMON_STATS,			/* TickMon_GetStats / TickMon_ResetStats       */
+	CRITSEC_SITE_VCCMON_READ,			/* VccMon_GetVccMv / VccMon_GetStats           */
+	CRITSEC_SITE_COUNT
+} CritSec_SiteType;
+
+/**
+ * Interrupt-disabled time of the outermost sections of one call site (saturating counters).
+ */
+typedef struct {
+	uint16 Count;							/* Measured sections                      */
+	uint16 MaxUs;							/* Longest one, TCNT2 resolution (32us)   */
+	uint16 Histogram[CRITSEC_BINS];			/* See CRITSEC_BINS                       */
+} CritSec_StatsType;
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void CritSec_Start(void);
+void CritSec_Stop(CritSec_SiteType Site);
+void CritSec_GetSiteStats(CritSec_SiteType Site, CritSec_StatsType *Stats);
+void CritSec_ResetStats(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* CRITSEC_H_ */
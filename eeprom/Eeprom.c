@@ -0,0 +1,110 @@
+/*
+ * Eeprom.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "Eeprom.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static const uint8 *Eeprom_WriteData;		// Caller's buffer, kept until the job is done
+static uint16 Eeprom_WriteAddress;
+static volatile uint8 Eeprom_WriteLeft;		// Bytes not written yet, 0: idle
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Reads a block of the EEPROM.
+ *
+ * A read is 4 cycles per byte, but waits for a byte write in progress (up to 3.4ms).
+ * Meant for the init functions; must not be called while an Eeprom_Write job is running.
+ *
+ * @param Address First EEPROM address.
+ * @param Data Receives Length bytes.
+ * @param Length Bytes to read.
+ * @return None
+ */
+void Eeprom_Read(uint16 Address, uint8 *Data, uint8 Length) {
+	while (Length--) {
+		while (EECR & (1 << EEPE)) {
+		}
+		EEAR = Address++;
+		EECR |= (1 << EERE);
+		*Data++ = EEDR;
+	}
+}
+
+
+/**
+ * @brief Starts writing a block to the EEPROM in the background.
+ *
+ * The EEPROM ready interrupt writes one byte per 3.4ms and skips the bytes that already
+ * hold their value, the super loop never waits. The bytes are written in address order,
+ * so a record whose check field comes last is only valid once the write is complete.
+ * Data must stay unchanged until Eeprom_IsBusy returns false.
+ *
+ * @param Address First EEPROM address.
+ * @param Data Bytes to write.
+ * @param Length Bytes to write.
+ * @return false if a write job is already running (nothing started).
+ */
+bool Eeprom_Write(uint16 Address, const uint8 *Data, uint8 Length) {
+	if (Eeprom_WriteLeft != 0) {
+		return false;
+	}
+	Eeprom_WriteData = Data;
+	Eeprom_WriteAddress = Address;
+	Eeprom_WriteLeft = Length;
+	if (Length != 0) {
+		EECR |= (1 << EERIE);
+	}
+	return true;
+}
+
+
+/**
+ * @brief Returns true while an Eeprom_Write job is running.
+ */
+bool Eeprom_IsBusy(void) {
+	return Eeprom_WriteLeft != 0;
+}
+
+
+/**
+ * @brief EEPROM ready interrupt service routine.
+ *
+ * Runs whenever no byte write is in progress while a job is active: writes the next byte
+ * that differs from the EEPROM content (erase and write, 3.4ms), the interrupt is switched
+ * off after the last byte. At most EEPROM_COMPARES_PER_IRQ unchanged bytes are skipped per
+ * interrupt to bound its duration. The EEMPE/EEPE sequence needs no cli: interrupts are disabled
+ * inside the ISR.
+ *
+ * @return None
+ */
+ISR(EE_READY_vect) {
+	uint8 compared = 0;
+
+	while (Eeprom_WriteLeft != 0) {
+		uint8 data = *Eeprom_WriteData++;
+
+		WCET_LOOP_BOUND(EEPROM_COMPARES_PER_IRQ);
+		EEAR = Eeprom_WriteAddress++;
+		Eeprom_WriteLeft--;
+		EECR |= (1 << EERE);
+		if (EEDR != data) {
+			EEDR = data;
+			EECR |= (1 << EEMPE);
+			EECR |= (1 << EEPE);
+			return;
+		}
+		if (++compared == EEPROM_COMPARES_PER_IRQ) {
+			return;		// Pending again at once, the main code gets one instruction
+		}
+	}
+	EECR &= ~(1 << EERIE);
+}
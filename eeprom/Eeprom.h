@@ -0,0 +1,42 @@
+/*
+ * Eeprom.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdbool.h>
+#include "Std_types.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define EEPROM_SIZE				1024		/* ATmega328P                                 */
+#define EEPROM_COMPARES_PER_IRQ	8			/* Unchanged bytes skipped per interrupt      */
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void Eeprom_Read(uint16 Address, uint8 *Data, uint8 Length);
+bool Eeprom_Write(uint16 Address, const uint8 *Data, uint8 Length);
+bool Eeprom_IsBusy(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* EEPROM_H_ */
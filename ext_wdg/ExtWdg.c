@@ -0,0 +1,148 @@
+/*
+ * ExtWdg.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "ExtWdg.h"
+#include "CritSec.h"
+
+#if (EXTWDG_MS_TO_TICKS(EXTWDG_PULSE_MS) < 1) || \
+	(EXTWDG_MS_TO_TICKS(EXTWDG_PERIOD_MS) - EXTWDG_MS_TO_TICKS(EXTWDG_PULSE_MS) < 1) || \
+	(EXTWDG_MS_TO_TICKS(EXTWDG_PULSE_MS) > 256) || \
+	(EXTWDG_MS_TO_TICKS(EXTWDG_PERIOD_MS) - EXTWDG_MS_TO_TICKS(EXTWDG_PULSE_MS) > 256)
+#error "EXTWDG pulse and low time must be 1..256 Timer0 ticks"
+#endif
+
+// Timer0 CTC mode, OC0A cleared / set on compare match
+#define EXTWDG_TCCR0A_CLEAR		((1 << COM0A1) | (1 << WGM01))
+#define EXTWDG_TCCR0A_SET		((1 << COM0A1) | (1 << COM0A0) | (1 << WGM01))
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static volatile uint8 ExtWdg_PulseTicks = EXTWDG_MS_TO_TICKS(EXTWDG_PULSE_MS) - 1;
+static volatile uint8 ExtWdg_LowTicks = EXTWDG_MS_TO_TICKS(EXTWDG_PERIOD_MS) - EXTWDG_MS_TO_TICKS(EXTWDG_PULSE_MS) - 1;
+static volatile uint8 ExtWdg_High = 0;		// 1: the pending compare match sets OC0A (rising edge)
+static volatile uint8 ExtWdg_Kicked = 0;	// WDGM_MainFunction ran since the last pulse
+static volatile uint16 ExtWdg_PulseCount = 0;
+static volatile uint16 ExtWdg_MissedCount = 0;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Starts the heartbeat output.
+ *
+ * Both edges of the heartbeat are generated by the Timer0 compare unit, so they do not
+ * depend on the interrupt latency. The compare ISR only programs the action of the next
+ * match (set or clear OC0A) and its distance. The pin starts low; the first pulse is sent
+ * one low time after the first ExtWdg_Kick while WDGM reports OK.
+ *
+ * If the software stops (no ISR, interrupts disabled) the compare unit repeats the last
+ * programmed action, the pin keeps its level and the external supervisor sees no edge.
+ *
+ * @return None
+ */
+void ExtWdg_Init(void) {
+#if (EXTWDG_ENABLED == 1)
+	EXTWDG_PORT &= ~(1 << EXTWDG_PIN);
+	EXTWDG_DDR |= (1 << EXTWDG_PIN);
+
+	TCCR0B = 0;
+	TCNT0 = 0;
+	OCR0A = ExtWdg_LowTicks;
+	ExtWdg_High = 0;
+	TCCR0A = EXTWDG_TCCR0A_CLEAR;
+	TIFR0 = (1 << OCF0A);
+	TIMSK0 = (1 << OCIE0A);
+	TCCR0B = (1 << CS02) | (1 << CS00);		// Prescaler = 1024
+#endif
+}
+
+
+/**
+ * @brief Allows the next heartbeat pulse, called after every WDGM_MainFunction.
+ */
+void ExtWdg_Kick(void) {
+	ExtWdg_Kicked = 1;
+}
+
+
+/**
+ * @brief Changes the heartbeat pattern, from the next pulse on.
+ *
+ * @param PulseMs High time of the pulse.
+ * @param PeriodMs Distance between two rising edges.
+ * @return 1 if the pattern fits Timer0 (every phase 1..256 ticks), 0 otherwise (unchanged).
+ */
+uint8 ExtWdg_SetPattern(uint16 PulseMs, uint16 PeriodMs) {
+	uint32 pulse = EXTWDG_MS_TO_TICKS((uint32)PulseMs);
+	uint32 period = EXTWDG_MS_TO_TICKS((uint32)PeriodMs);
+	uint8 sreg;
+
+	if (pulse < 1 || pulse > 256 || period <= pulse || (period - pulse) > 256) {
+		return 0;
+	}
+	CRITSEC_ENTER(CRITSEC_SITE_EXTWDG, sreg);
+	ExtWdg_PulseTicks = (uint8)(pulse - 1);
+	ExtWdg_LowTicks = (uint8)(period - pulse - 1);
+	CRITSEC_EXIT(CRITSEC_SITE_EXTWDG, sreg);
+	return 1;
+}
+
+
+/**
+ * @brief Pulses sent since the boot.
+ */
+uint16 ExtWdg_GetPulseCount(void) {
+	uint16 count;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_EXTWDG, sreg);
+	count = ExtWdg_PulseCount;
+	CRITSEC_EXIT(CRITSEC_SITE_EXTWDG, sreg);
+	return count;
+}
+
+
+/**
+ * @brief Pulses withheld since the boot (WDGM NOK or no ExtWdg_Kick in the period).
+ */
+uint16 ExtWdg_GetMissedCount(void) {
+	uint16 count;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_EXTWDG, sreg);
+	count = ExtWdg_MissedCount;
+	CRITSEC_EXIT(CRITSEC_SITE_EXTWDG, sreg);
+	return count;
+}
+
+
+/**
+ * @brief Timer0 compare match A interrupt service routine.
+ *
+ * Runs right after the edge generated by the hardware and programs the next one:
+ * after a rising edge the falling edge follows one pulse width later, after a falling edge
+ * (or a withheld pulse) the next rising edge is armed only if WDGM reports OK and was
+ * executed since the last pulse. Otherwise the pin stays low for one more low time.
+ */
+ISR(TIMER0_COMPA_vect) {
+	if (ExtWdg_High) {
+		OCR0A = ExtWdg_PulseTicks;
+		TCCR0A = EXTWDG_TCCR0A_CLEAR;
+		ExtWdg_High = 0;
+	} else if (ExtWdg_Kicked && WDGM_ProvideSupervisionStatus() == OK) {
+		OCR0A = ExtWdg_LowTicks;
+		TCCR0A = EXTWDG_TCCR0A_SET;
+		ExtWdg_High = 1;
+		ExtWdg_Kicked = 0;
+		ExtWdg_PulseCount++;
+	} else {
+		OCR0A = ExtWdg_LowTicks;
+		ExtWdg_MissedCount++;
+	}
+}
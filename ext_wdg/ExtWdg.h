@@ -0,0 +1,59 @@
+/*
+ * ExtWdg.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef EXTWDG_H_
+#define EXTWDG_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Std_types.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * Heartbeat output for an external supervisor IC on OC0A (PD6), driven by Timer0
+ * output compare. 1 -> enabled
+ */
+#define EXTWDG_ENABLED			1
+#define EXTWDG_PIN				PD6
+#define EXTWDG_PORT				PORTD
+#define EXTWDG_DDR				DDRD
+
+// Default pattern: high pulse of EXTWDG_PULSE_MS every EXTWDG_PERIOD_MS
+#define EXTWDG_PERIOD_MS		100
+#define EXTWDG_PULSE_MS			10
+
+// Timer0 prescaler 1024 -> 1.024ms per tick at 1MHz, longest phase 256 ticks
+#define EXTWDG_PRESCALER		1024
+#define EXTWDG_TICK_US			((EXTWDG_PRESCALER * 1000UL) / (F_CPU / 1000UL))
+#define EXTWDG_MS_TO_TICKS(ms)	((((ms) * 1000UL) + (EXTWDG_TICK_US / 2)) / EXTWDG_TICK_US)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void ExtWdg_Init(void);
+void ExtWdg_Kick(void);
+uint8 ExtWdg_SetPattern(uint16 PulseMs, uint16 PeriodMs);
+uint16 ExtWdg_GetPulseCount(void);
+uint16 ExtWdg_GetMissedCount(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* EXTWDG_H_ */
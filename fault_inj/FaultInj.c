@@ -0,0 +1,109 @@
+/*
+ * FaultInj.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "FaultInj.h"
+
+#if (FAULTINJ_ENABLED == 1)
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+#include "CritSec.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// One armed fault at a time, read by the injection points (main loop and ISRs)
+volatile FaultInj_PointType FaultInj_Point = FAULTINJ_POINT_COUNT;
+volatile FaultInj_FaultType FaultInj_Fault = FAULTINJ_FAULT_NONE;
+volatile uint16 FaultInj_Param = 0;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Arms one fault: it is active from the next call of the point on.
+ *
+ * STALL, SKIP, DELAY and STUCK_FLAG stay active until FaultInj_Disarm, CORRUPT is a single
+ * event. Safe to call from the main loop or from an ISR.
+ *
+ * @param Point The instrumented function.
+ * @param Fault The fault class.
+ * @param Param DELAY: ms per call, CORRUPT: value added to the counter,
+ *              STUCK_FLAG: value of the flag.
+ * @return None
+ */
+void FaultInj_Arm(FaultInj_PointType Point, FaultInj_FaultType Fault, uint16 Param) {
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_FAULTINJ_ARM, sreg);
+	FaultInj_Param = Param;
+	FaultInj_Fault = Fault;
+	FaultInj_Point = Point;
+	CRITSEC_EXIT(CRITSEC_SITE_FAULTINJ_ARM, sreg);
+}
+
+
+/**
+ * @brief Removes the armed fault.
+ */
+void FaultInj_Disarm(void) {
+	FaultInj_Arm(FAULTINJ_POINT_COUNT, FAULTINJ_FAULT_NONE, 0);
+}
+
+
+/**
+ * @brief Applies the execution faults at the entry of a point (FAULTINJ_POINT).
+ *
+ * The stall keeps the interrupts in the state of the caller: a stalled ISR blocks every
+ * other interrupt, a stalled task is still preempted by them.
+ *
+ * @param Point The instrumented function.
+ * @return 1 when the body of the point must be skipped.
+ */
+uint8 FaultInj_Hit(FaultInj_PointType Point) {
+	uint32 steps;
+
+	if (FaultInj_Point != Point) {
+		return 0;
+	}
+	switch (FaultInj_Fault) {
+	case FAULTINJ_FAULT_STALL:
+		for (;;) {
+			_delay_us(FAULTINJ_STEP_US);
+		}
+		break;
+	case FAULTINJ_FAULT_SKIP:
+		return 1;
+	case FAULTINJ_FAULT_DELAY:
+		for (steps = (uint32)FaultInj_Param * (1000 / FAULTINJ_STEP_US); steps != 0; steps--) {
+			_delay_us(FAULTINJ_STEP_US);
+		}
+		break;
+	default:
+		break;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Consumes a single-event fault armed on the point (FAULTINJ_CORRUPT).
+ *
+ * @param Point The instrumented function.
+ * @param Fault The single-event fault class.
+ * @return 1 once when the fault is armed on the point, then it is disarmed.
+ */
+uint8 FaultInj_Take(FaultInj_PointType Point, FaultInj_FaultType Fault) {
+	if (!FAULTINJ_ARMED(Point, Fault)) {
+		return 0;
+	}
+	FaultInj_Fault = FAULTINJ_FAULT_NONE;
+	return 1;
+}
+
+#endif /* FAULTINJ_ENABLED */
@@ -0,0 +1,108 @@
+/*
+ * FaultInj.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef FAULTINJ_H_
+#define FAULTINJ_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include "Std_types.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> fault-injection points are compiled into the supervision chain (test builds only,
+ * e.g. the host fault campaign). 0 -> every FAULTINJ_xx macro expands to nothing and
+ * FaultInj.c is empty: production images are identical to a build without the hooks.
+ */
+#ifndef FAULTINJ_ENABLED
+#define FAULTINJ_ENABLED		0
+#endif
+
+#if (FAULTINJ_ENABLED == 1)
+/**
+ * At the entry of an instrumented function (or ISR): stall, delay or skip the rest of it.
+ */
+#define FAULTINJ_POINT(Point)					do { if (FaultInj_Hit(Point)) { return; } } while (0)
+/**
+ * Adds the fault parameter to Counter once (single event upset of a counter).
+ */
+#define FAULTINJ_CORRUPT(Point, Counter)		do { if (FaultInj_Take(Point, FAULTINJ_FAULT_CORRUPT)) { (Counter) += FaultInj_Param; } } while (0)
+/**
+ * After every write of Flag: the flag stays at the fault parameter (stuck-at fault).
+ */
+#define FAULTINJ_STUCK(Point, Flag)				do { if (FAULTINJ_ARMED(Point, FAULTINJ_FAULT_STUCK_FLAG)) { (Flag) = (uint8)FaultInj_Param; } } while (0)
+#else
+#define FAULTINJ_POINT(Point)					do { } while (0)
+#define FAULTINJ_CORRUPT(Point, Counter)		do { } while (0)
+#define FAULTINJ_STUCK(Point, Flag)				do { } while (0)
+#endif
+
+#define FAULTINJ_ARMED(Point, Fault)			(FaultInj_Point == (Point) && FaultInj_Fault == (Fault))
+
+// Granularity of the stall loop and of the delay fault
+#define FAULTINJ_STEP_US		100
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Injection points, one per instrumented function.
+ */
+typedef enum {
+	FAULTINJ_POINT_LEDM_MANAGE = 0,		/* LEDM_Manage                     */
+	FAULTINJ_POINT_WDGM_MAIN,			/* WDGM_MainFunction               */
+	FAULTINJ_POINT_WDGM_ALIVENESS,		/* WDGM_AlivenessIndication        */
+	FAULTINJ_POINT_TIMER1_ISR,			/* ISR(TIMER1_COMPA_vect), ~52.2ms */
+	FAULTINJ_POINT_TIMER2_ISR,			/* ISR(TIMER2_COMPA_vect), 1ms     */
+	FAULTINJ_POINT_WDGDRV_NOTIFICATION,	/* WDGDrv_IsrNotification          */
+	FAULTINJ_POINT_COUNT
+} FaultInj_PointType;
+
+/**
+ * Fault classes. Param is the fault parameter given to FaultInj_Arm.
+ */
+typedef enum {
+	FAULTINJ_FAULT_NONE = 0,
+	FAULTINJ_FAULT_STALL,		/* The point never returns (endless loop)                */
+	FAULTINJ_FAULT_SKIP,		/* The body of the point is skipped at every call        */
+	FAULTINJ_FAULT_DELAY,		/* Every call is delayed by Param ms                     */
+	FAULTINJ_FAULT_CORRUPT,		/* Param is added once to the counter of the point       */
+	FAULTINJ_FAULT_STUCK_FLAG,	/* WDGM_MainFunction_Stuck stuck at Param (WDGM_MAIN)    */
+	FAULTINJ_FAULT_COUNT
+} FaultInj_FaultType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+extern volatile FaultInj_PointType FaultInj_Point;
+extern volatile FaultInj_FaultType FaultInj_Fault;
+extern volatile uint16 FaultInj_Param;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void FaultInj_Arm(FaultInj_PointType Point, FaultInj_FaultType Fault, uint16 Param);
+void FaultInj_Disarm(void);
+uint8 FaultInj_Hit(FaultInj_PointType Point);
+uint8 FaultInj_Take(FaultInj_PointType Point, FaultInj_FaultType Fault);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* FAULTINJ_H_ */
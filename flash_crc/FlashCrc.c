@@ -0,0 +1,149 @@
+/*
+ * FlashCrc.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "FlashCrc.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+#if defined(__AVR__)
+// End of the flash image (code + .data initializers), from the linker script
+extern uint8 __data_load_end;
+
+const uint16 FlashCrc_Expected PROGMEM = 0x0000;	// Patched after the link
+
+#define FLASHCRC_IMAGE_END		((uint16)&__data_load_end)
+#define FLASHCRC_EXPECTED_ADDR	((uint16)&FlashCrc_Expected)
+#else
+// Host simulator: image and CRC word of the simulated flash
+#include "sim.h"
+#define FLASHCRC_IMAGE_END		((uint16)SIM_FLASH_IMAGE_END)
+#define FLASHCRC_EXPECTED_ADDR	((uint16)SIM_FLASH_CRC_ADDR)
+#endif
+
+/**
+ * CRC-16/CCITT-FALSE of one nibble: 16 words instead of the 512 bytes of a byte table.
+ */
+static const uint16 FlashCrc_NibbleTable[16] PROGMEM = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+static uint16 FlashCrc_Address = 0;			// Next flash byte of the running pass
+static uint16 FlashCrc_Crc = FLASHCRC_INIT;
+static uint8  FlashCrc_Running = 0;
+static uint32 FlashCrc_LastStart = 0;		// HAL_GetTick() at the start of the last pass
+static uint8  FlashCrc_PassCount = 0;		// Completed passes (wraps)
+
+static uint16 FlashCrc_PassTicks = 0;		// Timer1 ticks spent in the running pass
+static uint16 FlashCrc_BytesPerMs = 0;		// Throughput measured over the last pass
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Feeds one byte into a CRC-16/CCITT-FALSE, high nibble first.
+ */
+uint16 FlashCrc_Update(uint16 Crc, uint8 Data) {
+	Crc = (Crc << 4) ^ pgm_read_word(&FlashCrc_NibbleTable[((Crc >> 12) ^ (Data >> 4)) & 0x0F]);
+	Crc = (Crc << 4) ^ pgm_read_word(&FlashCrc_NibbleTable[((Crc >> 12) ^ Data) & 0x0F]);
+	return Crc;
+}
+
+
+/**
+ * @brief Initializes the background integrity check, the first pass starts right away.
+ *
+ * @return None
+ */
+void FlashCrc_Init(void) {
+	FlashCrc_Address = 0;
+	FlashCrc_Crc = FLASHCRC_INIT;
+	FlashCrc_PassTicks = 0;
+	FlashCrc_Running = 1;
+	FlashCrc_LastStart = HAL_GetTick();
+}
+
+
+/**
+ * @brief One time-sliced step of the flash integrity check.
+ *
+ * Called from the superloop every FLASHCRC_STEP_PERIOD_MS. Bytes are read with pgm_read_byte
+ * in groups of FLASHCRC_BYTES_PER_CHECK until FLASHCRC_STEP_BUDGET_US is used (Timer1 time
+ * base), so a step never blocks the superloop for longer than the budget plus one group.
+ * The expected CRC word itself is skipped. At the end of a pass the result is compared with
+ * FlashCrc_Expected, a mismatch is a failure of WDGM_ENTITY_FLASHCRC. A new pass is started
+ * every FLASHCRC_PERIOD_MS.
+ *
+ * @return None
+ */
+void FlashCrc_MainFunction(void) {
+	const uint16 end = FLASHCRC_IMAGE_END;
+	const uint16 skip = FLASHCRC_EXPECTED_ADDR;
+	uint16 start;
+	uint16 elapsed;
+	uint16 crc;
+	uint16 address;
+	uint8 count;
+
+	if (!FlashCrc_Running) {
+		if ((HAL_GetTick() - FlashCrc_LastStart) < FLASHCRC_PERIOD_MS) {
+			return;
+		}
+		FlashCrc_Init();
+	}
+
+	crc = FlashCrc_Crc;
+	address = FlashCrc_Address;
+	start = TCNT1;
+	do {
+		WCET_LOOP_BOUND(FLASHCRC_STEP_BUDGET_TICKS);
+		for (count = 0; count < FLASHCRC_BYTES_PER_CHECK && address < end; count++, address++) {
+			WCET_LOOP_BOUND(FLASHCRC_BYTES_PER_CHECK);
+			if ((uint16)(address - skip) > 1) {
+				crc = FlashCrc_Update(crc, pgm_read_byte(address));
+			}
+		}
+		elapsed = TCNT1;
+		if (elapsed < start) {
+			elapsed += TIMER1_COMPARE_VALUE + 1;	// Timer1 restarted (CTC)
+		}
+		elapsed -= start;
+	} while (elapsed < FLASHCRC_STEP_BUDGET_TICKS && address < end);
+
+	FlashCrc_Crc = crc;
+	FlashCrc_Address = address;
+	FlashCrc_PassTicks += elapsed;
+
+	if (address >= end) {
+		FlashCrc_Running = 0;
+		FlashCrc_PassCount++;
+		if (FlashCrc_PassTicks != 0) {
+			FlashCrc_BytesPerMs = (uint16)(((uint32)end * 1000UL) / ((uint32)FlashCrc_PassTicks * FLASHCRC_TICK_US));
+		}
+		if (crc != pgm_read_word(FLASHCRC_EXPECTED_ADDR)) {
+			WDGM_EntityFailureIndication(WDGM_ENTITY_FLASHCRC);
+		}
+	}
+}
+
+
+/**
+ * @brief Throughput of the last complete pass in bytes per millisecond of CPU time.
+ */
+uint16 FlashCrc_GetBytesPerMs(void) {
+	return FlashCrc_BytesPerMs;
+}
+
+
+/**
+ * @brief Number of completed passes (wraps at 255).
+ */
+uint8 FlashCrc_GetPassCount(void) {
+	return FlashCrc_PassCount;
+}
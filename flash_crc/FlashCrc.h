@@ -0,0 +1,66 @@
+/*
+ * FlashCrc.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef FLASHCRC_H_
+#define FLASHCRC_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "Std_types.h"
+#include "timer.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define FLASHCRC_PERIOD_MS			10000	/* A full image pass is started every N ms        */
+#define FLASHCRC_STEP_BUDGET_US		500		/* CPU time of one FlashCrc_MainFunction step     */
+#define FLASHCRC_BYTES_PER_CHECK	8		/* Bytes processed between two budget checks      */
+#define FLASHCRC_STEP_PERIOD_MS		5		/* Superloop period of FlashCrc_MainFunction      */
+
+#define FLASHCRC_INIT				0xFFFF	/* CRC-16/CCITT-FALSE: poly 0x1021, no reflection */
+
+// Budget in Timer1 ticks (TIMER1_PRESCALER cycles each)
+#define FLASHCRC_TICK_US			((TIMER1_PRESCALER * 1000UL) / (F_CPU / 1000UL))
+#define FLASHCRC_STEP_BUDGET_TICKS	((FLASHCRC_STEP_BUDGET_US + FLASHCRC_TICK_US - 1) / FLASHCRC_TICK_US)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+/**
+ * Expected CRC of the application image [0, __data_load_end) without these two bytes.
+ * Written into the .hex after the link by tools/flash_crc.py.
+ */
+extern const uint16 FlashCrc_Expected;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void FlashCrc_Init(void);
+void FlashCrc_MainFunction(void);
+uint16 FlashCrc_Update(uint16 Crc, uint8 Data);
+uint16 FlashCrc_GetBytesPerMs(void);
+uint8 FlashCrc_GetPassCount(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* FLASHCRC_H_ */
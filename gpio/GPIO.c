@@ -6,6 +6,7 @@
  */
 
 #include "GPIO.h"
+#include "Boot.h"
 
 
 /**
@@ -20,11 +21,22 @@
  *
  * This function configures specific GPIO pins (LED_PIN_0 and LED_PIN_5) on port GPIO_B
  * as output pins with push-pull configuration.
+ * In fast-boot mode (BOOT_FAST_MODE) the same end state (all PORTB pins driven low and the
+ * buzzer pin as a low output, see Gpio_ConfigPin) is written with one access per register
+ * instead of eight read-modify-write sequences.
  *
  * @return None
  */
 void GPIO_Init(void)
 {
+#if (BOOT_FAST_MODE == 1)
+    LED_PORT = 0x00;
+    LED_DDR = (1 << MCU_reset_LED) | (1 << WDT_COUNTER_RESET_LED) | (1 << LED_MANAGE_LED) |
+              (1 << WDGM_LED) | (1 << PROJECT_START_LED) | (1 << LED_TOGGLE_LED) |
+              (1 << TIMER50MS_LED) | (1 << TIMER1MS_LED);
+    BUZZER_PORT &= ~(1 << BUZZER_PIN);
+    BUZZER_DDR |= (1 << BUZZER_PIN);
+#else
     Gpio_ConfigPin(GPIO_B, MCU_reset_LED, GPIO_OUTPUT, GPIO_PUSH_PULL);
     Gpio_ConfigPin(GPIO_B, WDT_COUNTER_RESET_LED, GPIO_OUTPUT, GPIO_PUSH_PULL);
     Gpio_ConfigPin(GPIO_B, LED_MANAGE_LED, GPIO_OUTPUT, GPIO_PUSH_PULL);
@@ -33,6 +45,7 @@ void GPIO_Init(void)
     Gpio_ConfigPin(GPIO_B, LED_TOGGLE_LED, GPIO_OUTPUT, GPIO_PUSH_PULL);
     Gpio_ConfigPin(GPIO_B, TIMER50MS_LED, GPIO_OUTPUT, GPIO_PUSH_PULL);
     Gpio_ConfigPin(GPIO_B, TIMER1MS_LED, GPIO_OUTPUT, GPIO_PUSH_PULL);
+#endif
 }
 
 
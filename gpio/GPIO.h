@@ -28,8 +28,8 @@
 #define HIGH   0x01
 
 
-#define LED_PORT (*(volatile uint8_t*)0x25)  // PORTB address
-#define LED_DDR  (*(volatile uint8_t*)0x24)  // DDRB address
+#define LED_PORT PORTB  // PORTB address 0x25
+#define LED_DDR  DDRB   // DDRB address 0x24
 #define LED_PIN  5                           // Pin number for PB5
 
 
@@ -45,6 +45,16 @@
 #define BUZZER_PORT PORTD
 #define BUZZER_PIN  PB1
 #define BUZZER_DDR 	DDRD
+
+/**
+ * GPIO_Write for a pin known at compile time, used by the interrupt handlers: the mask is a
+ * constant (sbi/cbi) instead of the shift loop of GPIO_Write, 64 cycles per call with the
+ * call itself in the Release image. Same port writes as GPIO_Write.
+ */
+#define GPIO_WRITE_CONST(PinId, PinData)	do { \
+		if (PinData) { LED_PORT |= (1 << (PinId)); BUZZER_PORT |= (1 << BUZZER_PIN); } \
+		else { LED_PORT &= ~(1 << (PinId)); } \
+	} while (0)
 /*******************************************************************************
  ******************************   Macros End      ****************************
  *******************************************************************************/
@@ -0,0 +1,144 @@
+/*
+ * HBMON.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "HBMON.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static uint16 HBMon_RiseWraps = 0;			// Timestamp of the last rising edge
+static uint16 HBMon_RiseCapture = 0;
+static uint8  HBMon_RiseSeen = 0;			// A rising edge was captured since init
+static volatile uint32 HBMon_PeriodTicks = 0;	// Last measured period
+static volatile uint32 HBMon_PulseTicks = 0;	// Last measured high time
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Initializes the heartbeat monitor on the Timer1 input capture unit.
+ *
+ * ICP1 (PB0) is configured as input and the capture unit is armed for a rising edge with
+ * the noise canceler enabled. Timer1 itself is already running from timers_init(), so this
+ * function must be called after it. Every edge is time stamped by the hardware in ICR1,
+ * the interrupt latency does not affect the measured period or pulse width.
+ *
+ * @return None
+ */
+void HBMon_Init(void) {
+#if (HBMON_ENABLED == 1)
+	// ICP1 as input without pull-up
+	DDRB &= ~(1 << DDB0);
+	PORTB &= ~(1 << PB0);
+
+	HBMon_RiseSeen = 0;
+	// Noise canceler on, first capture on the rising edge
+	TCCR1B |= (1 << ICNC1) | (1 << ICES1);
+	TIFR1 = (1 << ICF1);
+	// Enable Timer1 input capture interrupt
+	TIMSK1 |= (1 << ICIE1);
+#endif
+}
+
+
+/**
+ * @brief Ticks elapsed between two extended Timer1 timestamps.
+ *
+ * A timestamp is the number of counter restarts (timer1Wraps) plus the captured counter
+ * value. The wrap difference is taken modulo 2^16 so the wrap counter may overflow freely.
+ */
+static uint32 HBMon_Elapsed(uint16 wraps, uint16 capture, uint16 prevWraps, uint16 prevCapture) {
+	return ((uint32)(uint16)(wraps - prevWraps) * (TIMER1_COMPARE_VALUE + 1UL)) + capture - prevCapture;
+}
+
+
+/**
+ * @brief Returns the last measured heartbeat period in microseconds.
+ */
+uint32 HBMon_GetPeriodUs(void) {
+	uint32 ticks;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_HBMON_READ, sreg);
+	ticks = HBMon_PeriodTicks;
+	CRITSEC_EXIT(CRITSEC_SITE_HBMON_READ, sreg);
+	return ticks * HBMON_TICK_US;
+}
+
+
+/**
+ * @brief Returns the last measured heartbeat pulse width (high time) in microseconds.
+ */
+uint32 HBMon_GetPulseWidthUs(void) {
+	uint32 ticks;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_HBMON_READ, sreg);
+	ticks = HBMon_PulseTicks;
+	CRITSEC_EXIT(CRITSEC_SITE_HBMON_READ, sreg);
+	return ticks * HBMON_TICK_US;
+}
+
+
+/**
+ * @brief Timer1 input capture interrupt service routine.
+ *
+ * Rising edge : the period since the previous rising edge is checked against
+ *               [HBMON_PERIOD_MIN_MS, HBMON_PERIOD_MAX_MS] and an aliveness indication
+ *               (or a failure) is given to WDGM. The capture switches to the falling edge.
+ * Falling edge: the pulse width is checked against [HBMON_PULSE_MIN_MS, HBMON_PULSE_MAX_MS].
+ *               The capture switches back to the rising edge.
+ *
+ * A missing heartbeat gives no indications at all, WDGM then reports the entity NOK when
+ * the supervision window closes.
+ *
+ * @return None
+ */
+ISR(TIMER1_CAPT_vect) {
+	uint16 capture = ICR1;
+	uint16 wraps = timer1Wraps;
+
+	/**
+	 * The counter may have restarted just before the capture while TIMER1_COMPA_vect
+	 * (lower priority) is still pending: the captured value then belongs to the next cycle.
+	 */
+	if ((TIFR1 & (1 << OCF1A)) && (capture < ((TIMER1_COMPARE_VALUE + 1) / 2))) {
+		wraps++;
+	}
+
+	if (TCCR1B & (1 << ICES1)) {
+		if (HBMon_RiseSeen) {
+			uint32 period = HBMon_Elapsed(wraps, capture, HBMon_RiseWraps, HBMon_RiseCapture);
+			HBMon_PeriodTicks = period;
+			if (period >= HBMON_MS_TO_TICKS(HBMON_PERIOD_MIN_MS) &&
+				period <= HBMON_MS_TO_TICKS(HBMON_PERIOD_MAX_MS)) {
+				WDGM_EntityAlivenessIndication(WDGM_ENTITY_HBMON);
+			} else {
+				WDGM_EntityFailureIndication(WDGM_ENTITY_HBMON);
+			}
+		}
+		HBMon_RiseWraps = wraps;
+		HBMon_RiseCapture = capture;
+		HBMon_RiseSeen = 1;
+		TCCR1B &= ~(1 << ICES1);	// Next capture on the falling edge
+	} else {
+		if (HBMon_RiseSeen) {
+			uint32 pulse = HBMon_Elapsed(wraps, capture, HBMon_RiseWraps, HBMon_RiseCapture);
+			HBMon_PulseTicks = pulse;
+			if (pulse < HBMON_MS_TO_TICKS(HBMON_PULSE_MIN_MS) ||
+				pulse > HBMON_MS_TO_TICKS(HBMON_PULSE_MAX_MS)) {
+				WDGM_EntityFailureIndication(WDGM_ENTITY_HBMON);
+			}
+		}
+		TCCR1B |= (1 << ICES1);		// Next capture on the rising edge
+	}
+
+	// Changing the edge may raise a spurious capture flag (datasheet 16.6.3)
+	TIFR1 = (1 << ICF1);
+}
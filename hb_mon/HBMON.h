@@ -0,0 +1,60 @@
+/*
+ * HBMON.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef HBMON_H_
+#define HBMON_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Std_types.h"
+#include "timer.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> the heartbeat of the companion processor on ICP1 (PB0) is supervised by WDGM.
+ * PB0 is then an input and the MCU_reset_LED debug strobe is not available.
+ */
+#define HBMON_ENABLED			0
+
+// Accepted heartbeat period (rising edge to rising edge) and pulse width (high time)
+#define HBMON_PERIOD_MIN_MS		15
+#define HBMON_PERIOD_MAX_MS		25
+#define HBMON_PULSE_MIN_MS		1
+#define HBMON_PULSE_MAX_MS		10
+
+// Valid heartbeats expected in one WDGM_PERIOD_MS supervision window
+#define HBMON_PULSES_OK_MIN		(WDGM_PERIOD_MS / HBMON_PERIOD_MAX_MS)
+#define HBMON_PULSES_OK_MAX		((WDGM_PERIOD_MS + HBMON_PERIOD_MAX_MS) / HBMON_PERIOD_MIN_MS)
+
+// One Timer1 tick is TIMER1_PRESCALER CPU cycles (64us at 1MHz)
+#define HBMON_TICK_US			((TIMER1_PRESCALER * 1000UL) / (F_CPU / 1000UL))
+#define HBMON_MS_TO_TICKS(ms)	((uint32)(ms) * 1000UL / HBMON_TICK_US)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void HBMon_Init(void);
+uint32 HBMon_GetPeriodUs(void);
+uint32 HBMon_GetPulseWidthUs(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* HBMON_H_ */
@@ -6,6 +6,7 @@
  */
 
 #include "LEDM.h"
+#include "FaultInj.h"
 
 /*******************************************************************************
  *************************   Global variables Start      ***********************
@@ -36,20 +37,26 @@ void LEDM_Init(void)
  */
 void LEDM_Manage(void)
 {
+	FAULTINJ_POINT(FAULTINJ_POINT_LEDM_MANAGE);
+
 	GPIO_Write(LED_MANAGE_LED, HIGH);
 	uint32_t currentTime = HAL_GetTick();
+	FAULTINJ_CORRUPT(FAULTINJ_POINT_LEDM_MANAGE, timeToggle);
 	/**
 	 * the LED blinking periodicity to be 500ms for each stage
 	 */
 	if (currentTime - timeToggle >= 500) {
 		togglingState = ~togglingState & 1;
-		GPIO_Write(LED_TOGGLE_LED, togglingState);
+		// Once the safe state is applied the LED keeps its safe level until the reset
+		if (!SafeState_IsActive()) {
+			GPIO_Write(LED_TOGGLE_LED, togglingState);
+		}
 		timeToggle = currentTime;
 	}
 	// Increment the call count of the main WDG
 	/**
 	 * @if we commenting WDGM_AlivenessIndication the WDG reset( system reset )
-	 * after  ~ 114ms
+	 * after  ~ 117ms
 	 */
 	GPIO_Write(LED_MANAGE_LED, LOW);
 	WDGM_AlivenessIndication();
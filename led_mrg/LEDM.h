@@ -10,6 +10,7 @@
 #include "WDGM.h"
 #include <avr/io.h>
 #include "GPIO.h"
+#include "SafeState.h"
 
 /*******************************************************************************
  ******************************   includes end    ****************************
@@ -21,8 +22,16 @@
  ******************************   Macros Start      ****************************
  *******************************************************************************/
 // Define LED-related macros with specific register addresses
-#define LED_Dir  (*(volatile uint8_t *)(GPIOB_BASE_ADDR - GPIO_DDR_OFFSET))  /* Define LED port direction */
-#define LED_Port (*(volatile uint8_t *)(GPIOB_BASE_ADDR))                    /* Define LED port */
+#define LED_Dir  DDRB   /* Define LED port direction */
+#define LED_Port PORTB  /* Define LED port */
+
+/**
+ * Period of the LEDM_Manage task in main.c. 5ms instead of 10ms gives 20 aliveness
+ * indications per WDGM window (max LEDM_CALLS_OK_MAX) and a reset after ~114ms.
+ */
+#ifndef LEDM_PERIOD_MS
+#define LEDM_PERIOD_MS 10
+#endif
 
 /*******************************************************************************
  ******************************   Macros end        ****************************
@@ -13,14 +13,19 @@ typedef signed char         	sint8;          /*        -128 .. +127            *
 typedef unsigned char       	uint8;          /*           0 .. 255             */
 typedef signed short        	sint16;         /*      -32768 .. +32767          */
 typedef unsigned short      	uint16;         /*           0 .. 65535           */
+#if (__SIZEOF_LONG__ == 4)
 typedef signed long         	sint32;         /* -2147483648 .. +2147483647     */
 typedef unsigned long      		uint32;         /*           0 .. 4294967295      */
+#else	/* 64-bit host simulator */
+typedef signed int          	sint32;         /* -2147483648 .. +2147483647     */
+typedef unsigned int       		uint32;         /*           0 .. 4294967295      */
+#endif
 typedef unsigned long long  	uint64;         /*       0..18446744073709551615  */
 typedef signed long long    	sint64;         /*       0..18446744073709551615  */
 typedef float               	float32;        /* 1.1754943635e-38 to 3.4028235e+38 */
 typedef double              	float64;        /* 2.2250738585072015e-308 to 1.7976931348623158e+308 */
-typedef volatile unsigned int   vuint32_t;
-typedef volatile signed int     vsint32_t;
+typedef volatile uint32          vuint32_t;
+typedef volatile sint32          vsint32_t;
 typedef volatile unsigned char  vuint8;
 typedef volatile signed char    vsint8_t;
 typedef unsigned char       	boolean;        /* for use with TRUE/FALSE        */
@@ -29,6 +34,33 @@ typedef uint32              	return_status ;
 
 typedef uint8 Rcc_PeripheralIdType;
 
+
+/* The host simulator build must give the types their AVR widths (see the Makefile) */
+_Static_assert(sizeof(uint8) == 1 && sizeof(sint8) == 1, "8-bit types");
+_Static_assert(sizeof(uint16) == 2 && sizeof(sint16) == 2, "16-bit types");
+_Static_assert(sizeof(uint32) == 4 && sizeof(sint32) == 4, "32-bit types");
+_Static_assert(sizeof(uint64) == 8 && sizeof(sint64) == 8, "64-bit types");
+_Static_assert(sizeof(float32) == 4, "float32");
+
+
+/* Variables not cleared by the C startup code, they keep their value across resets */
+#if defined(__AVR__)
+#define NOINIT							__attribute__((section(".noinit")))
+#else
+#define NOINIT							__attribute__((section("sim_noinit")))	/* Host simulator */
+#endif
+
+/*
+ * Iteration bound of the enclosing loop for tools/wcet_stack.py, first statement of the
+ * loop body. Emits a local label "__wcet_loop_<n>_<bound>" and no instruction; the label
+ * follows the loop through inlining and unrolling. The bound is a constant expression.
+ */
+#if defined(__AVR__)
+#define WCET_LOOP_BOUND(bound)			__asm__ __volatile__("__wcet_loop_%=_%0:" :: "n" (bound))
+#else
+#define WCET_LOOP_BOUND(bound)			((void)0)						/* Host simulator */
+#endif
+
 typedef int 					*IntPtr;        /* Pointer to an integer */
 typedef char 					*CharPtr;       /* Pointer to a character */
 typedef float 					*FloatPtr;      /* Pointer to a float */
@@ -7,7 +7,7 @@
 #ifndef UTILS_H
 #define UTILS_H
 
-#include "Std_Types.h"
+#include "Std_types.h"
 #define REG32(BASE_ADDR, OFFSET)  (*(uint32 *)((BASE_ADDR) + (OFFSET)))
 
 #define OK    (return_status)0x01
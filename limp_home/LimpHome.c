@@ -0,0 +1,170 @@
+/*
+ * LimpHome.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "LimpHome.h"
+#include "timer.h"
+#include "Boot.h"
+#include "CrashDump.h"
+#include "SafeState.h"
+#include "RunCfg.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// Survives the watchdog reset, validated with Magic and Check
+static LimpHome_RecordType LimpHome_Record NOINIT;
+
+static uint8 LimpHome_Active = 0;
+static uint16 LimpHome_DisabledEntities = 0;
+static uint32 LimpHome_CleanSince = 0;		// Start of the current run of OK windows
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+static uint8 LimpHome_Check(void) {
+	return (uint8)(LimpHome_Record.ConsecutiveResets ^ LimpHome_Record.FailedEntities ^
+	               (LimpHome_Record.FailedEntities >> 8) ^ 0xA5);
+}
+
+
+static void LimpHome_Store(void) {
+	LimpHome_Record.Magic = LIMPHOME_MAGIC;
+	LimpHome_Record.Check = LimpHome_Check();
+}
+
+
+/**
+ * @brief Degraded profile: relaxed supervision windows and WDT timeout, the entities that
+ * failed before the resets are no longer supervised and the outputs are held in their
+ * safe state.
+ */
+static void LimpHome_Enter(void) {
+	uint8 entity;
+
+	LimpHome_DisabledEntities = LimpHome_Record.FailedEntities;
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		if (LimpHome_DisabledEntities & (1U << entity)) {
+			WDGM_SetEntityEnabled((WDGM_EntityIdType)entity, false);
+		}
+	}
+	WDGM_SetProfile(WDGM_PROFILE_DEGRADED);
+	WDGDrv_SetTimeout(LIMPHOME_WDG_TIMEOUT);
+	SafeState_Apply();
+	LimpHome_Active = 1;
+}
+
+
+/**
+ * @brief Back to the normal profile after a clean uptime period.
+ */
+static void LimpHome_Leave(void) {
+	uint8 entity;
+
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		WDGM_SetEntityEnabled((WDGM_EntityIdType)entity, true);
+	}
+	WDGM_SetProfile(WDGM_PROFILE_NORMAL);
+	WDGDrv_SetTimeout(RunCfg_Active.WdtTimeout);
+	SafeState_Release();
+	LimpHome_DisabledEntities = 0;
+	LimpHome_Active = 0;
+}
+
+
+/**
+ * @brief Counts the watchdog resets and escalates into the limp-home mode.
+ *
+ * Must be called after CrashDump_Init, WDGDrv_Init and WDGM_Init. The reset cause comes
+ * from the MCUSR copy taken at startup (WDGDrv_Init clears WDRF). A watchdog reset increments
+ * the counter and adds the entities reported NOK by the crash dump, any other reset cause
+ * (power-on, external, brown-out) starts from zero. After LIMPHOME_RESET_THRESHOLD
+ * consecutive watchdog resets the MCU boots into the degraded profile instead of restarting
+ * into the same fault forever.
+ *
+ * @return None
+ */
+void LimpHome_Init(void) {
+	CrashDump_RecordType dump;
+	uint8 entity;
+
+	if (LimpHome_Record.Magic != LIMPHOME_MAGIC || LimpHome_Record.Check != LimpHome_Check() ||
+		!(Boot_GetResetFlags() & (1 << WDRF))) {
+		LimpHome_Record.ConsecutiveResets = 0;
+		LimpHome_Record.FailedEntities = 0;
+	} else {
+		if (LimpHome_Record.ConsecutiveResets != 0xFF) {
+			LimpHome_Record.ConsecutiveResets++;
+		}
+		if (CrashDump_GetLastRecord(&dump)) {
+			for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+				WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+				if (dump.EntityStatus[entity] == NOK) {
+					LimpHome_Record.FailedEntities |= (1U << entity);
+				}
+			}
+		}
+	}
+	LimpHome_Store();
+
+	if (LimpHome_Record.ConsecutiveResets >= LIMPHOME_RESET_THRESHOLD) {
+		LimpHome_Enter();
+	}
+	LimpHome_CleanSince = HAL_GetTick();
+}
+
+
+/**
+ * @brief Clears the reset-loop counter after a clean uptime period.
+ *
+ * Called after WDGM_MainFunction. Once WDGM reported OK for LIMPHOME_CLEAN_UPTIME_MS the
+ * counter and the failed entities are cleared and the limp-home mode (if active) returns
+ * to the normal profile.
+ *
+ * @return None
+ */
+void LimpHome_MainFunction(void) {
+	uint32 now = HAL_GetTick();
+
+	if (WDGM_ProvideSupervisionStatus() == NOK) {
+		LimpHome_CleanSince = now;
+	} else if ((LimpHome_Record.ConsecutiveResets != 0 || LimpHome_Active) &&
+			   (now - LimpHome_CleanSince) >= LIMPHOME_CLEAN_UPTIME_MS) {
+		if (LimpHome_Active) {
+			LimpHome_Leave();
+		}
+		LimpHome_Record.ConsecutiveResets = 0;
+		LimpHome_Record.FailedEntities = 0;
+		LimpHome_Store();
+	}
+}
+
+
+/**
+ * @brief Returns 1 while the degraded profile is active.
+ */
+uint8 LimpHome_IsActive(void) {
+	return LimpHome_Active;
+}
+
+
+/**
+ * @brief Consecutive watchdog resets counted so far (0 after a clean uptime period).
+ */
+uint8 LimpHome_GetResetCount(void) {
+	return LimpHome_Record.ConsecutiveResets;
+}
+
+
+/**
+ * @brief Entities not supervised in the limp-home mode (bit per WDGM_EntityIdType).
+ */
+uint16 LimpHome_GetDisabledEntities(void) {
+	return LimpHome_DisabledEntities;
+}
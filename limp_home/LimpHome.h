@@ -0,0 +1,61 @@
+/*
+ * LimpHome.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef LIMPHOME_H_
+#define LIMPHOME_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include "Std_types.h"
+#include "WDGM.h"
+#include "WDGDRV.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define LIMPHOME_MAGIC				0x4C48
+#define LIMPHOME_RESET_THRESHOLD	3			/* Consecutive WDT resets before limp-home    */
+#define LIMPHOME_CLEAN_UPTIME_MS	30000UL		/* Uptime with WDGM OK that clears the count  */
+#define LIMPHOME_WDG_TIMEOUT		WDTO_120MS	/* Relaxed WDT timeout of the degraded profile */
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Reset-loop bookkeeping kept in .noinit across watchdog resets. A reset counts as
+ * consecutive when the previous run did not reach LIMPHOME_CLEAN_UPTIME_MS with WDGM OK.
+ */
+typedef struct {
+	uint16 Magic;
+	uint8  ConsecutiveResets;
+	uint16 FailedEntities;		/* Bit per WDGM_EntityIdType, NOK in the crash dumps */
+	uint8  Check;
+} LimpHome_RecordType;
+
+// .noinit layout of the AVR build (the host simulator is built with the same data layout)
+_Static_assert(sizeof(LimpHome_RecordType) == 6, "LimpHome_RecordType layout");
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void LimpHome_Init(void);
+void LimpHome_MainFunction(void);
+uint8 LimpHome_IsActive(void);
+uint8 LimpHome_GetResetCount(void);
+uint16 LimpHome_GetDisabledEntities(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* LIMPHOME_H_ */
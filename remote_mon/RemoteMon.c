@@ -0,0 +1,237 @@
+/*
+ * RemoteMon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "RemoteMon.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// Receive state machine, one step per received byte
+typedef enum {
+	REMOTEMON_RX_SOF = 0,
+	REMOTEMON_RX_NODE,
+	REMOTEMON_RX_SEQ,
+	REMOTEMON_RX_STATUS,
+	REMOTEMON_RX_CRC
+} RemoteMon_RxStateType;
+
+static RemoteMon_RxStateType RemoteMon_RxState = REMOTEMON_RX_SOF;
+static uint8 RemoteMon_RxCrc;				// Running CRC of the frame being received
+static uint8 RemoteMon_RxNode;
+static uint8 RemoteMon_RxSeq;
+static uint8 RemoteMon_RxStatus;
+static uint8 RemoteMon_RxTick;				// Low byte of millis at the previous byte
+
+static uint8 RemoteMon_Synced[REMOTEMON_NODE_COUNT];	// A frame was received since init
+static uint8 RemoteMon_BehindRun[REMOTEMON_NODE_COUNT];	// Consecutive frames behind LastSeq
+static uint8 RemoteMon_BehindSeq[REMOTEMON_NODE_COUNT];	// Sequence number of the last of them
+static RemoteMon_NodeStatsType RemoteMon_Nodes[REMOTEMON_NODE_COUNT];
+static RemoteMon_BusStatsType RemoteMon_Bus;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Initializes USART0 as receiver of the remote node heartbeat frames.
+ *
+ * 9600 baud 8N1 in double speed mode, the receive complete interrupt parses the frames.
+ * The transmitter is left off, TXD (PD1) stays a general purpose pin.
+ *
+ * @return None
+ */
+void RemoteMon_Init(void) {
+	uint8 node;
+
+	RemoteMon_RxState = REMOTEMON_RX_SOF;
+	for (node = 0; node < REMOTEMON_NODE_COUNT; node++) {
+		WCET_LOOP_BOUND(REMOTEMON_NODE_COUNT);
+		RemoteMon_Synced[node] = 0;
+		RemoteMon_BehindRun[node] = 0;
+	}
+#if (REMOTEMON_ENABLED == 1)
+	UBRR0 = REMOTEMON_UBRR;
+	UCSR0A = (1 << U2X0);
+	UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+	UCSR0B = (1 << RXEN0) | (1 << RXCIE0);
+#endif
+}
+
+
+/**
+ * @brief CRC-8 of a frame (NodeId, Seq, Status), also used by the node side and the tests.
+ */
+uint8 RemoteMon_FrameCrc(uint8 NodeId, uint8 Seq, uint8 Status) {
+	uint8 crc = REMOTEMON_CRC_INIT;
+	crc = _crc8_ccitt_update(crc, NodeId);
+	crc = _crc8_ccitt_update(crc, Seq);
+	crc = _crc8_ccitt_update(crc, Status);
+	return crc;
+}
+
+
+/**
+ * @brief Copies the counters of one node (node id 1..REMOTEMON_NODE_COUNT).
+ */
+void RemoteMon_GetNodeStats(uint8 NodeId, RemoteMon_NodeStatsType *Stats) {
+	if (NodeId >= 1 && NodeId <= REMOTEMON_NODE_COUNT) {
+		uint8 sreg;
+
+		CRITSEC_ENTER(CRITSEC_SITE_REMOTEMON_STATS, sreg);
+		*Stats = RemoteMon_Nodes[NodeId - 1];
+		CRITSEC_EXIT(CRITSEC_SITE_REMOTEMON_STATS, sreg);
+	}
+}
+
+
+/**
+ * @brief Copies the bus level counters.
+ */
+void RemoteMon_GetBusStats(RemoteMon_BusStatsType *Stats) {
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_REMOTEMON_STATS, sreg);
+	*Stats = RemoteMon_Bus;
+	CRITSEC_EXIT(CRITSEC_SITE_REMOTEMON_STATS, sreg);
+}
+
+
+/**
+ * @brief Supervision of one frame with a valid CRC (interrupt context).
+ *
+ * The sequence number is what proves the node alive, a frame repeating an old number is
+ * not an aliveness indication:
+ *   Seq == Last + 1 : aliveness indication
+ *   Seq == Last     : duplicate, failure
+ *   Seq behind Last : out of order (half the sequence space), failure, Last is kept
+ *   Seq ahead Last+1: frames lost, failure, the node is followed from this frame on
+ * The first frame after init only synchronizes. A non-zero Status is a failure too.
+ *
+ * A node that restarted sends its sequence from 0 again, every frame is then behind Last.
+ * Only the first frame of such a run is a failure; after REMOTEMON_RESYNC_FRAMES
+ * consecutive numbers behind Last the node is followed from the last of them on.
+ */
+static void RemoteMon_Frame(uint8 NodeId, uint8 Seq, uint8 Status) {
+	RemoteMon_NodeStatsType *node;
+	WDGM_EntityIdType entity;
+	uint8 inSequence = 0;
+
+	if (NodeId < 1 || NodeId > REMOTEMON_NODE_COUNT) {
+		RemoteMon_Bus.UnknownNodes++;
+		return;
+	}
+	node = &RemoteMon_Nodes[NodeId - 1];
+	entity = REMOTEMON_ENTITY(NodeId);
+	node->Frames++;
+
+	if (!RemoteMon_Synced[NodeId - 1]) {
+		RemoteMon_Synced[NodeId - 1] = 1;
+		inSequence = 1;
+	} else {
+		uint8 diff = (uint8)(Seq - node->LastSeq);
+		uint8 run = RemoteMon_BehindRun[NodeId - 1];
+
+		RemoteMon_BehindRun[NodeId - 1] = 0;
+		if (diff == 1) {
+			inSequence = 1;
+		} else if (diff == 0) {
+			node->Duplicates++;
+			WDGM_EntityFailureIndication(entity);
+			return;
+		} else if (diff >= 0x80) {
+			if (run == 0 || Seq != (uint8)(RemoteMon_BehindSeq[NodeId - 1] + 1)) {
+				node->OutOfOrder++;
+				WDGM_EntityFailureIndication(entity);
+				run = 0;
+			}
+			run++;
+			if (run < REMOTEMON_RESYNC_FRAMES) {
+				RemoteMon_BehindRun[NodeId - 1] = run;
+				RemoteMon_BehindSeq[NodeId - 1] = Seq;
+				return;
+			}
+			node->Resyncs++;
+			inSequence = 1;
+		} else {
+			node->Gaps++;
+			WDGM_EntityFailureIndication(entity);
+		}
+	}
+	node->LastSeq = Seq;
+	node->LastStatus = Status;
+
+	if (Status != REMOTEMON_STATUS_OK) {
+		node->StatusErrors++;
+		WDGM_EntityFailureIndication(entity);
+	} else if (inSequence) {
+		WDGM_EntityAlivenessIndication(entity);
+	}
+}
+
+
+/**
+ * @brief USART0 receive complete interrupt service routine.
+ *
+ * Frames are parsed byte by byte, only the decoded fields and the running CRC are kept.
+ * A line error (framing, overrun, parity) or an inter-byte gap above
+ * REMOTEMON_BYTE_TIMEOUT_MS drops the frame being received; the parser then looks for the
+ * next SOF. A missing node gives no indications at all, WDGM reports it NOK when the
+ * supervision window closes.
+ *
+ * @return None
+ */
+ISR(USART_RX_vect) {
+	// The error flags belong to the byte in UDR0, read them first
+	uint8 flags = UCSR0A;
+	uint8 data = UDR0;
+	uint8 tick = (uint8)millis;
+
+	if (flags & ((1 << FE0) | (1 << DOR0) | (1 << UPE0))) {
+		RemoteMon_Bus.LineErrors++;
+		RemoteMon_RxState = REMOTEMON_RX_SOF;
+		return;
+	}
+	if (RemoteMon_RxState != REMOTEMON_RX_SOF &&
+		(uint8)(tick - RemoteMon_RxTick) > REMOTEMON_BYTE_TIMEOUT_MS) {
+		RemoteMon_Bus.Truncated++;
+		RemoteMon_RxState = REMOTEMON_RX_SOF;
+	}
+	RemoteMon_RxTick = tick;
+
+	switch (RemoteMon_RxState) {
+	case REMOTEMON_RX_SOF:
+		if (data == REMOTEMON_SOF) {
+			RemoteMon_RxCrc = REMOTEMON_CRC_INIT;
+			RemoteMon_RxState = REMOTEMON_RX_NODE;
+		}
+		break;
+	case REMOTEMON_RX_NODE:
+		RemoteMon_RxNode = data;
+		RemoteMon_RxCrc = _crc8_ccitt_update(RemoteMon_RxCrc, data);
+		RemoteMon_RxState = REMOTEMON_RX_SEQ;
+		break;
+	case REMOTEMON_RX_SEQ:
+		RemoteMon_RxSeq = data;
+		RemoteMon_RxCrc = _crc8_ccitt_update(RemoteMon_RxCrc, data);
+		RemoteMon_RxState = REMOTEMON_RX_STATUS;
+		break;
+	case REMOTEMON_RX_STATUS:
+		RemoteMon_RxStatus = data;
+		RemoteMon_RxCrc = _crc8_ccitt_update(RemoteMon_RxCrc, data);
+		RemoteMon_RxState = REMOTEMON_RX_CRC;
+		break;
+	default:
+		if (data == RemoteMon_RxCrc) {
+			RemoteMon_Frame(RemoteMon_RxNode, RemoteMon_RxSeq, RemoteMon_RxStatus);
+		} else {
+			RemoteMon_Bus.CrcErrors++;
+		}
+		RemoteMon_RxState = REMOTEMON_RX_SOF;
+		break;
+	}
+}
@@ -0,0 +1,107 @@
+/*
+ * RemoteMon.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef REMOTEMON_H_
+#define REMOTEMON_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include "Std_types.h"
+#include "timer.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> the heartbeat frames of the remote nodes on RXD (PD0) are supervised by WDGM.
+ * PD0 is then the USART0 receiver.
+ */
+#ifndef REMOTEMON_ENABLED
+#define REMOTEMON_ENABLED		0
+#endif
+
+// Remote nodes, node id 1..REMOTEMON_NODE_COUNT (one WDGM entity each)
+#define REMOTEMON_NODE_COUNT	2
+
+// 9600 baud 8N1, double speed (U2X0): 0.2% error at 1MHz instead of 7% in normal mode
+#define REMOTEMON_BAUD			9600UL
+#define REMOTEMON_UBRR			((F_CPU + 4UL * REMOTEMON_BAUD) / (8UL * REMOTEMON_BAUD) - 1)
+
+/**
+ * Frame: [SOF][NodeId][Seq][Status][CRC8], CRC-8 (poly 0x07, init 0x00) over NodeId, Seq
+ * and Status. Seq increments by one per frame (modulo 256), Status 0 means healthy.
+ */
+#define REMOTEMON_SOF			0xA5
+#define REMOTEMON_CRC_INIT		0x00
+#define REMOTEMON_STATUS_OK		0x00
+
+// Consecutive sequence numbers behind the last one that resynchronize a restarted node
+#define REMOTEMON_RESYNC_FRAMES	3
+
+// A frame whose bytes are more than this apart is dropped (truncated frame)
+#define REMOTEMON_BYTE_TIMEOUT_MS	3
+
+// Accepted heartbeat frame period of a node
+#define REMOTEMON_PERIOD_MIN_MS	20
+#define REMOTEMON_PERIOD_MAX_MS	30
+
+// Valid frames expected from a node in one WDGM_PERIOD_MS supervision window
+#define REMOTEMON_FRAMES_OK_MIN	(WDGM_PERIOD_MS / REMOTEMON_PERIOD_MAX_MS)
+#define REMOTEMON_FRAMES_OK_MAX	((WDGM_PERIOD_MS + REMOTEMON_PERIOD_MAX_MS) / REMOTEMON_PERIOD_MIN_MS)
+
+// WDGM entity of a node id
+#define REMOTEMON_ENTITY(node)	((WDGM_EntityIdType)(WDGM_ENTITY_REMOTE_NODE1 + (node) - 1))
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Per-node counters, every counter except Frames is a supervision error.
+ */
+typedef struct {
+	uint16 Frames;			/* Frames with a valid CRC                          */
+	uint16 Duplicates;		/* Same sequence number as the previous frame       */
+	uint16 OutOfOrder;		/* Sequence number behind the previous frame        */
+	uint16 Gaps;			/* Frames missing before this one                   */
+	uint16 StatusErrors;	/* Frames reporting a non-zero node status          */
+	uint16 Resyncs;			/* Node followed again after a sequence restart     */
+	uint8  LastSeq;
+	uint8  LastStatus;
+} RemoteMon_NodeStatsType;
+
+/**
+ * Bus level counters (frames that cannot be attributed to a node).
+ */
+typedef struct {
+	uint16 CrcErrors;
+	uint16 LineErrors;		/* Framing error, data overrun or parity error      */
+	uint16 Truncated;		/* Inter-byte timeout inside a frame                */
+	uint16 UnknownNodes;
+} RemoteMon_BusStatsType;
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void RemoteMon_Init(void);
+void RemoteMon_GetNodeStats(uint8 NodeId, RemoteMon_NodeStatsType *Stats);
+void RemoteMon_GetBusStats(RemoteMon_BusStatsType *Stats);
+uint8 RemoteMon_FrameCrc(uint8 NodeId, uint8 Seq, uint8 Status);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* REMOTEMON_H_ */
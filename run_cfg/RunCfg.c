@@ -0,0 +1,322 @@
+/*
+ * RunCfg.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include <stddef.h>
+#include "RunCfg.h"
+#include "WDGM.h"
+#include "WDGDRV.h"
+#include "LEDM.h"
+#include "HBMON.h"
+#include "RemoteMon.h"
+#include "LimpHome.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+RunCfg_ParamsType RunCfg_Active;					// Loaded by RunCfg_Init, constant afterwards
+
+static RunCfg_ParamsType RunCfg_Staged;				// Edited by RunCfg_Set, written by RunCfg_Commit
+static RunCfg_BlockType RunCfg_Block;				// Read by RunCfg_Init, or being written (Eeprom_Write)
+static RunCfg_SourceType RunCfg_Source = RUNCFG_SOURCE_DEFAULTS;
+static uint16 RunCfg_Generation;					// Of the copy in use, 0 with the defaults
+static RunCfg_StateType RunCfg_State = RUNCFG_STATE_IDLE;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief CRC16-CCITT of the block without its Crc field.
+ */
+static uint16 RunCfg_Crc(const RunCfg_BlockType *Block) {
+	const uint8 *data = (const uint8 *)Block;
+	uint16 crc = 0xFFFF;
+	uint8 i;
+
+	for (i = 0; i < offsetof(RunCfg_BlockType, Crc); i++) {
+		WCET_LOOP_BOUND(offsetof(RunCfg_BlockType, Crc));
+		crc = _crc_ccitt_update(crc, data[i]);
+	}
+	return crc;
+}
+
+
+/**
+ * @brief Build-time configuration (flash defaults). They are used as they are, e.g. the
+ * LEDM_PERIOD_MS=5 build of test/test_reset_timing.c is inconsistent on purpose.
+ */
+static void RunCfg_GetDefaults(RunCfg_ParamsType *Params) {
+	Params->WdgmPeriodMs = WDGM_PERIOD_MS;
+	Params->WdgmTaskMs = RUNCFG_WDGM_TASK_MS;
+	Params->LedmPeriodMs = LEDM_PERIOD_MS;
+	Params->LedmCallsMin = LEDM_CALLS_OK_MIN;
+	Params->LedmCallsMax = LEDM_CALLS_OK_MAX;
+	Params->WdtTimeout = WDGDRV_DEFAULT_TIMEOUT;
+}
+
+
+/**
+ * @brief Range of one parameter.
+ *
+ * The WDGM task runs at least twice per WDG refresh period (WDGM_MainFunction_Stuck), the
+ * WDT timeout is longer than the refresh period and not longer than the limp-home one.
+ */
+static bool RunCfg_ParamValid(RunCfg_ParamIdType Param, uint16 Value) {
+	switch (Param) {
+	case RUNCFG_PARAM_WDGM_PERIOD_MS:
+		return Value >= RUNCFG_WINDOW_MS_MIN && Value <= RUNCFG_WINDOW_MS_MAX;
+	case RUNCFG_PARAM_WDGM_TASK_MS:
+		return Value >= 1 && Value <= WDGDRV_REFRESH_PERIOD_MS / 2;
+	case RUNCFG_PARAM_LEDM_PERIOD_MS:
+		return Value >= 1 && Value <= RUNCFG_LEDM_MS_MAX;
+	case RUNCFG_PARAM_LEDM_CALLS_MIN:
+		return Value >= 1 && Value <= RUNCFG_CALLS_MAX;
+	case RUNCFG_PARAM_LEDM_CALLS_MAX:
+		return Value >= 1 && Value <= RUNCFG_CALLS_MAX;
+	case RUNCFG_PARAM_WDT_TIMEOUT:
+		return Value <= LIMPHOME_WDG_TIMEOUT && WDGDRV_TIMEOUT_MS(Value) > WDGDRV_REFRESH_PERIOD_MS;
+	default:
+		return false;
+	}
+}
+
+
+static uint16 RunCfg_GetParam(const RunCfg_ParamsType *Params, RunCfg_ParamIdType Param) {
+	switch (Param) {
+	case RUNCFG_PARAM_WDGM_PERIOD_MS:
+		return Params->WdgmPeriodMs;
+	case RUNCFG_PARAM_WDGM_TASK_MS:
+		return Params->WdgmTaskMs;
+	case RUNCFG_PARAM_LEDM_PERIOD_MS:
+		return Params->LedmPeriodMs;
+	case RUNCFG_PARAM_LEDM_CALLS_MIN:
+		return Params->LedmCallsMin;
+	case RUNCFG_PARAM_LEDM_CALLS_MAX:
+		return Params->LedmCallsMax;
+	case RUNCFG_PARAM_WDT_TIMEOUT:
+		return Params->WdtTimeout;
+	default:
+		return 0;
+	}
+}
+
+
+/**
+ * @brief Checks a whole parameter set.
+ *
+ * Every parameter in its range, both tasks run at least once per window, the LEDM calls of
+ * one window (window / period) inside [LedmCallsMin, LedmCallsMax] with one call of room on
+ * each side for the +/-1 jitter of a task against the window, the LEDM window inside the
+ * window of the degraded profile (build-time, half the minimum and twice the maximum). The
+ * HBMon and RemoteMon windows are derived from WDGM_PERIOD_MS at build time: with them
+ * enabled the window cannot change.
+ */
+static bool RunCfg_ParamsValid(const RunCfg_ParamsType *Params) {
+	uint16 calls;
+	uint8 param;
+
+	for (param = 0; param < RUNCFG_PARAM_COUNT; param++) {
+		WCET_LOOP_BOUND(RUNCFG_PARAM_COUNT);
+		if (!RunCfg_ParamValid((RunCfg_ParamIdType)param, RunCfg_GetParam(Params, (RunCfg_ParamIdType)param))) {
+			return false;
+		}
+	}
+	if (Params->WdgmTaskMs > Params->WdgmPeriodMs || Params->LedmPeriodMs > Params->WdgmPeriodMs) {
+		return false;
+	}
+	calls = Params->WdgmPeriodMs / Params->LedmPeriodMs;
+	if (calls - 1 < Params->LedmCallsMin || calls + 1 > Params->LedmCallsMax ||
+		Params->LedmCallsMin < LEDM_CALLS_OK_MIN / 2 || Params->LedmCallsMax > LEDM_CALLS_OK_MAX * 2) {
+		return false;
+	}
+	if ((HBMON_ENABLED == 1 || REMOTEMON_ENABLED == 1) && Params->WdgmPeriodMs != WDGM_PERIOD_MS) {
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Reads one copy into RunCfg_Block.
+ *
+ * @return true if the copy is valid (version, length, CRC and parameters).
+ */
+static bool RunCfg_ReadCopy(uint16 Address) {
+	Eeprom_Read(Address, (uint8 *)&RunCfg_Block, sizeof(RunCfg_Block));
+	return RunCfg_Block.Version == RUNCFG_VERSION && RunCfg_Block.Length == sizeof(RunCfg_ParamsType) &&
+		   RunCfg_Block.Crc == RunCfg_Crc(&RunCfg_Block) && RunCfg_ParamsValid(&RunCfg_Block.Params);
+}
+
+
+/**
+ * @brief Loads the runtime configuration.
+ *
+ * Must be called first in main, before the init functions reading RunCfg_Active (LEDM,
+ * WDGDrv, WDGM, LimpHome, WinCal). Of the two EEPROM copies the valid one with the newer
+ * generation is loaded; without a valid copy the flash defaults are used.
+ *
+ * @return None
+ */
+void RunCfg_Init(void) {
+	RunCfg_ParamsType params;
+	uint16 generation = 0;
+
+	RunCfg_Source = RUNCFG_SOURCE_DEFAULTS;
+	RunCfg_State = RUNCFG_STATE_IDLE;
+	RunCfg_GetDefaults(&params);
+	if (RunCfg_ReadCopy(RUNCFG_EEPROM_ADDR_A)) {
+		params = RunCfg_Block.Params;
+		generation = RunCfg_Block.Generation;
+		RunCfg_Source = RUNCFG_SOURCE_COPY_A;
+	}
+	if (RunCfg_ReadCopy(RUNCFG_EEPROM_ADDR_B) &&
+		(RunCfg_Source == RUNCFG_SOURCE_DEFAULTS || (sint16)(RunCfg_Block.Generation - generation) > 0)) {
+		params = RunCfg_Block.Params;
+		generation = RunCfg_Block.Generation;
+		RunCfg_Source = RUNCFG_SOURCE_COPY_B;
+	}
+	RunCfg_Active = params;
+	RunCfg_Staged = params;
+	RunCfg_Generation = generation;
+}
+
+
+/**
+ * @brief Returns one parameter of the active configuration (RunCfg_Active).
+ */
+uint16 RunCfg_GetActive(RunCfg_ParamIdType Param) {
+	return RunCfg_GetParam(&RunCfg_Active, Param);
+}
+
+
+/**
+ * @brief Returns one parameter of the staged configuration (the next one committed).
+ */
+uint16 RunCfg_GetStaged(RunCfg_ParamIdType Param) {
+	return RunCfg_GetParam(&RunCfg_Staged, Param);
+}
+
+
+/**
+ * @brief Changes one parameter of the staged configuration.
+ *
+ * Called from the super loop context only. The active configuration is not affected, the
+ * staged one is checked as a whole by RunCfg_Commit.
+ *
+ * @return false if the value is out of the range of the parameter.
+ */
+bool RunCfg_Set(RunCfg_ParamIdType Param, uint16 Value) {
+	if (!RunCfg_ParamValid(Param, Value)) {
+		return false;
+	}
+	switch (Param) {
+	case RUNCFG_PARAM_WDGM_PERIOD_MS:
+		RunCfg_Staged.WdgmPeriodMs = Value;
+		break;
+	case RUNCFG_PARAM_WDGM_TASK_MS:
+		RunCfg_Staged.WdgmTaskMs = Value;
+		break;
+	case RUNCFG_PARAM_LEDM_PERIOD_MS:
+		RunCfg_Staged.LedmPeriodMs = Value;
+		break;
+	case RUNCFG_PARAM_LEDM_CALLS_MIN:
+		RunCfg_Staged.LedmCallsMin = (uint8)Value;
+		break;
+	case RUNCFG_PARAM_LEDM_CALLS_MAX:
+		RunCfg_Staged.LedmCallsMax = (uint8)Value;
+		break;
+	default:
+		RunCfg_Staged.WdtTimeout = (uint8)Value;
+		break;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Stages the flash defaults (committed like any other change).
+ */
+void RunCfg_RestoreDefaults(void) {
+	RunCfg_GetDefaults(&RunCfg_Staged);
+}
+
+
+/**
+ * @brief Stores the staged configuration, applied at the next boot.
+ *
+ * The block is prepared here, RunCfg_MainFunction writes it into the copy not in use once
+ * the EEPROM is free. Called from the super loop context only.
+ *
+ * @return false if the staged set is inconsistent or a commit is still in progress.
+ */
+bool RunCfg_Commit(void) {
+	if (RunCfg_State != RUNCFG_STATE_IDLE || !RunCfg_ParamsValid(&RunCfg_Staged)) {
+		return false;
+	}
+	RunCfg_Block.Version = RUNCFG_VERSION;
+	RunCfg_Block.Length = sizeof(RunCfg_ParamsType);
+	RunCfg_Block.Generation = RunCfg_Generation + 1;
+	RunCfg_Block.Params = RunCfg_Staged;
+	RunCfg_Block.Crc = RunCfg_Crc(&RunCfg_Block);
+	RunCfg_State = RUNCFG_STATE_PENDING;
+	return true;
+}
+
+
+/**
+ * @brief Periodic function of the runtime configuration, called in the WDGM slot.
+ *
+ * The write runs in the background (Eeprom_Write, one byte per EEPROM ready interrupt)
+ * and never blocks the super loop. The copy written becomes the one in use when the write
+ * is complete.
+ *
+ * @return None
+ */
+void RunCfg_MainFunction(void) {
+	uint16 address = (RunCfg_Source == RUNCFG_SOURCE_COPY_A) ? RUNCFG_EEPROM_ADDR_B : RUNCFG_EEPROM_ADDR_A;
+
+	switch (RunCfg_State) {
+	case RUNCFG_STATE_PENDING:
+		if (Eeprom_Write(address, (const uint8 *)&RunCfg_Block, sizeof(RunCfg_Block))) {
+			RunCfg_State = RUNCFG_STATE_WRITING;
+		}
+		break;
+	case RUNCFG_STATE_WRITING:
+		if (!Eeprom_IsBusy()) {
+			RunCfg_Source = (address == RUNCFG_EEPROM_ADDR_A) ? RUNCFG_SOURCE_COPY_A : RUNCFG_SOURCE_COPY_B;
+			RunCfg_Generation = RunCfg_Block.Generation;
+			RunCfg_State = RUNCFG_STATE_IDLE;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/**
+ * @brief Returns the copy in use (the last one written, not necessarily the one loaded).
+ */
+RunCfg_SourceType RunCfg_GetSource(void) {
+	return RunCfg_Source;
+}
+
+
+/**
+ * @brief Returns the generation of the copy in use, 0 with the flash defaults.
+ */
+uint16 RunCfg_GetGeneration(void) {
+	return RunCfg_Generation;
+}
+
+
+/**
+ * @brief Returns the state of the commit.
+ */
+RunCfg_StateType RunCfg_GetState(void) {
+	return RunCfg_State;
+}
@@ -0,0 +1,128 @@
+/*
+ * RunCfg.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef RUNCFG_H_
+#define RUNCFG_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <util/crc16.h>
+#include <stdbool.h>
+#include "Std_types.h"
+#include "Eeprom.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * Two copies of the configuration block (A/B). An update is written into the copy that is
+ * not in use, the other one stays valid until the new one is complete: a reset during the
+ * write boots with the previous configuration. After the WinCal record at 0x0000 (28 bytes,
+ * layout checked by the _Static_assert in WinCal.h).
+ */
+#define RUNCFG_EEPROM_ADDR_A	0x0040
+#define RUNCFG_EEPROM_ADDR_B	0x0060
+#define RUNCFG_VERSION			1
+
+// Period of WDGM_MainFunction in the super loop (flash default)
+#define RUNCFG_WDGM_TASK_MS		20
+
+// Ranges of the single parameters, the whole set is checked by RunCfg_Commit
+#define RUNCFG_WINDOW_MS_MIN	20
+#define RUNCFG_WINDOW_MS_MAX	1000
+#define RUNCFG_LEDM_MS_MAX		1000
+#define RUNCFG_CALLS_MAX		254
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Parameters read by the periodic functions. RunCfg_Active is loaded once by RunCfg_Init
+ * and does not change until the next boot, the hot paths read it like a constant.
+ */
+typedef struct {
+	uint16 WdgmPeriodMs;					/* Supervision window (WDGM_PERIOD_MS)        */
+	uint16 WdgmTaskMs;						/* WDGM_MainFunction period in the super loop */
+	uint16 LedmPeriodMs;					/* LEDM_Manage period (LEDM_PERIOD_MS)        */
+	uint8  LedmCallsMin;					/* LEDM window (LEDM_CALLS_OK_MIN/MAX)        */
+	uint8  LedmCallsMax;
+	uint8  WdtTimeout;						/* WDTO_xx of WDGDrv_Init                     */
+} RunCfg_ParamsType;
+
+typedef enum {
+	RUNCFG_PARAM_WDGM_PERIOD_MS = 0,
+	RUNCFG_PARAM_WDGM_TASK_MS,
+	RUNCFG_PARAM_LEDM_PERIOD_MS,
+	RUNCFG_PARAM_LEDM_CALLS_MIN,
+	RUNCFG_PARAM_LEDM_CALLS_MAX,
+	RUNCFG_PARAM_WDT_TIMEOUT,
+	RUNCFG_PARAM_COUNT
+} RunCfg_ParamIdType;
+
+typedef enum {
+	RUNCFG_SOURCE_DEFAULTS = 0,	/* No valid copy: flash defaults */
+	RUNCFG_SOURCE_COPY_A,
+	RUNCFG_SOURCE_COPY_B
+} RunCfg_SourceType;
+
+typedef enum {
+	RUNCFG_STATE_IDLE = 0,
+	RUNCFG_STATE_PENDING,		/* Committed, waits for the EEPROM                */
+	RUNCFG_STATE_WRITING		/* Being written into the copy not in use          */
+} RunCfg_StateType;
+
+/**
+ * One copy in the EEPROM. The copy with the newer generation wins; the CRC comes last and
+ * is written last, a copy cut by a reset does not pass the check.
+ */
+typedef struct {
+	uint8  Version;							/* RUNCFG_VERSION, 0xFF: erased             */
+	uint8  Length;							/* sizeof(RunCfg_ParamsType)                */
+	uint16 Generation;						/* Incremented by every commit, wraps       */
+	RunCfg_ParamsType Params;
+	uint16 Crc;								/* CRC16-CCITT of the fields above          */
+} RunCfg_BlockType;
+
+// EEPROM layout of the AVR build, one copy fits between RUNCFG_EEPROM_ADDR_A and _B
+_Static_assert(sizeof(RunCfg_ParamsType) == 9, "RunCfg_ParamsType layout");
+_Static_assert(sizeof(RunCfg_BlockType) == 6 + sizeof(RunCfg_ParamsType), "RunCfg_BlockType layout");
+_Static_assert(sizeof(RunCfg_BlockType) <= RUNCFG_EEPROM_ADDR_B - RUNCFG_EEPROM_ADDR_A, "RunCfg copies overlap");
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+extern RunCfg_ParamsType RunCfg_Active;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void RunCfg_Init(void);
+void RunCfg_MainFunction(void);
+uint16 RunCfg_GetActive(RunCfg_ParamIdType Param);
+uint16 RunCfg_GetStaged(RunCfg_ParamIdType Param);
+bool RunCfg_Set(RunCfg_ParamIdType Param, uint16 Value);
+bool RunCfg_Commit(void);
+void RunCfg_RestoreDefaults(void);
+RunCfg_SourceType RunCfg_GetSource(void);
+uint16 RunCfg_GetGeneration(void);
+RunCfg_StateType RunCfg_GetState(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* RUNCFG_H_ */
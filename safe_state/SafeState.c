@@ -0,0 +1,95 @@
+/*
+ * SafeState.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "SafeState.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+/**
+ * Safe state of the actuators, applied before a supervision reset.
+ * Several lines may use the same port, they are merged into one write.
+ */
+static const SafeState_EntryType SafeState_Table[] PROGMEM = {
+	/* Port    Mask                       Value */
+	{ GPIO_B, (1 << LED_TOGGLE_LED),     0x00 },		// Blinking LED off
+};
+
+#define SAFESTATE_TABLE_SIZE	(sizeof(SafeState_Table) / sizeof(SafeState_Table[0]))
+
+static volatile uint8 SafeState_Active = 0;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Drives the outputs of the safe-state table.
+ *
+ * Called as soon as WDGM reports NOK and again from the WDT early-warning interrupt. The
+ * table lines are merged per port first, then every port gets a single PORTx write (level)
+ * followed by its DDRx write (direction) with interrupts disabled, so all the pins of a
+ * port change together and no ISR can interleave. SREG is restored afterwards.
+ *
+ * @return None
+ */
+void SafeState_Apply(void) {
+	uint8 clearMask[3] = { 0, 0, 0 };	// B, C, D
+	uint8 setMask[3] = { 0, 0, 0 };
+	uint8 i;
+	uint8 sreg;
+
+	for (i = 0; i < SAFESTATE_TABLE_SIZE; i++) {
+		uint8 port = pgm_read_byte(&SafeState_Table[i].Port) - GPIO_B;
+		uint8 mask = pgm_read_byte(&SafeState_Table[i].Mask);
+		uint8 value = pgm_read_byte(&SafeState_Table[i].Value);
+
+		WCET_LOOP_BOUND(SAFESTATE_TABLE_SIZE);
+		if (port < 3) {
+			clearMask[port] |= mask & ~value;
+			setMask[port] |= mask & value;
+		}
+	}
+
+	CRITSEC_ENTER(CRITSEC_SITE_SAFESTATE_APPLY, sreg);
+	if (clearMask[0] | setMask[0]) {
+		PORTB = (PORTB & ~clearMask[0]) | setMask[0];
+		DDRB |= clearMask[0] | setMask[0];
+	}
+	if (clearMask[1] | setMask[1]) {
+		PORTC = (PORTC & ~clearMask[1]) | setMask[1];
+		DDRC |= clearMask[1] | setMask[1];
+	}
+	if (clearMask[2] | setMask[2]) {
+		PORTD = (PORTD & ~clearMask[2]) | setMask[2];
+		DDRD |= clearMask[2] | setMask[2];
+	}
+	SafeState_Active = 1;
+	CRITSEC_EXIT(CRITSEC_SITE_SAFESTATE_APPLY, sreg);
+}
+
+
+/**
+ * @brief Returns 1 once the safe state was applied (until the next reset or SafeState_Release).
+ *
+ * Output owners (LEDM) check it to keep the safe level instead of driving the pin again.
+ */
+uint8 SafeState_IsActive(void) {
+	return SafeState_Active;
+}
+
+
+/**
+ * @brief Hands the outputs back to their owners.
+ *
+ * The pins keep their safe level until the owners drive them again. Used when the
+ * limp-home mode returns to normal operation after a clean uptime period.
+ */
+void SafeState_Release(void) {
+	SafeState_Active = 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * SafeState.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef SAFESTATE_H_
+#define SAFESTATE_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include "Std_types.h"
+#include "GPIO.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/**
+ * One line of the safe-state table: the pins of Mask on Port (GPIO_B, GPIO_C or GPIO_D)
+ * are driven as outputs to the matching bits of Value.
+ */
+typedef struct {
+	uint8 Port;
+	uint8 Mask;
+	uint8 Value;
+} SafeState_EntryType;
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void SafeState_Apply(void);
+uint8 SafeState_IsActive(void);
+void SafeState_Release(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* SAFESTATE_H_ */
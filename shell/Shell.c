@@ -0,0 +1,541 @@
+/*
+ * Shell.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include <string.h>
+#include "Shell.h"
+#include "WDGM.h"
+#include "RunCfg.h"
+#include "CritSec.h"
+#include "TickMon.h"
+#include "VccMon.h"
+#include "StackMon.h"
+#include "CrashDump.h"
+#include "LimpHome.h"
+#include "Boot.h"
+#include "RemoteMon.h"
+#include "Telemetry.h"
+
+#if (SHELL_ENABLED == 1) && ((REMOTEMON_ENABLED == 1) || (TELEMETRY_ENABLED == 1))
+#error "The shell needs USART0 alone, disable RemoteMon and Telemetry"
+#endif
+#if ((WDGM_STATS_BINS % SHELL_VALUES) != 0)
+#error "The histogram lines hold SHELL_VALUES bins each"
+#endif
+
+#if (SHELL_ENABLED == 1)
+/**
+ * Commands, in the order of Shell_Commands.
+ */
+typedef enum {
+	SHELL_CMD_NONE = 0,
+	SHELL_CMD_HELP,				/* help                                           */
+	SHELL_CMD_WDGM,				/* wdgm: global and entity status, windows        */
+	SHELL_CMD_STATS,			/* stats <entity>: WDGM statistics of one entity  */
+	SHELL_CMD_PROF,				/* prof: tick, stack, VCC, critical sections      */
+	SHELL_CMD_RESETS,			/* resets: reset cause, limp-home, crash dump     */
+	SHELL_CMD_CFG,				/* cfg: runtime configuration                     */
+	SHELL_CMD_SET,				/* set <param> <value>: staged configuration      */
+	SHELL_CMD_COMMIT,			/* commit: staged configuration into the EEPROM   */
+	SHELL_CMD_DEFAULTS,			/* defaults: flash defaults staged                */
+	SHELL_CMD_REPLY				/* "ok" or "err" of the commands above            */
+} Shell_CommandType;
+
+#define SHELL_CMD_NAMES			(SHELL_CMD_DEFAULTS)
+#define SHELL_DIGITS			10			// uint32
+#define SHELL_MAX_ARGS			3
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static const char Shell_Commands[SHELL_CMD_NAMES][9] PROGMEM = {
+	"help", "wdgm", "stats", "prof", "resets", "cfg", "set", "commit", "defaults"
+};
+
+// Names of the RunCfg_ParamIdType parameters
+static const char Shell_ParamNames[RUNCFG_PARAM_COUNT][7] PROGMEM = {
+	"window", "task", "ledm", "min", "max", "wdto"
+};
+
+static const uint32 Shell_Powers[SHELL_DIGITS] PROGMEM = {
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL, 1000UL, 100UL, 10UL, 1UL
+};
+
+// Command line, filled one received byte per step
+static char Shell_Line[SHELL_LINE_SIZE];
+static uint8 Shell_LineLength;
+static uint8 Shell_LineError;				// Too long or line error, answered with "err"
+static uint8 Shell_LineReady;				// End of line received, waits for Shell_Execute
+static uint8 Shell_TypedAhead;				// Dropped while a line waits: the next one is "err"
+
+// Response: one line at a time, formatted one field per step while it is sent
+static Shell_CommandType Shell_Command = SHELL_CMD_NONE;
+static uint8 Shell_Row;						// Next line of the response
+static uint8 Shell_Arg;						// Entity of "stats", result of a reply
+static PGM_P Shell_Format;					// Rest of the line format, NULL: line complete
+static uint32 Shell_Values[SHELL_VALUES];
+static uint8 Shell_NextValue;
+static char Shell_Out[SHELL_OUT_SIZE];
+static uint8 Shell_OutLength;
+static uint8 Shell_OutSent;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+static void Shell_Put(char Char) {
+	if (Shell_OutLength < SHELL_OUT_SIZE) {
+		Shell_Out[Shell_OutLength++] = Char;
+	}
+}
+
+
+/**
+ * @brief Decimal digits by subtraction of the powers of ten: at most 9 subtractions per
+ * digit instead of a 32-bit division.
+ */
+static void Shell_PutNumber(uint32 Value) {
+	uint8 leading = 1;
+	uint8 i;
+
+	for (i = 0; i < SHELL_DIGITS; i++) {
+		uint32 power = pgm_read_dword(&Shell_Powers[i]);
+		char digit = '0';
+
+		WCET_LOOP_BOUND(SHELL_DIGITS);
+		while (Value >= power) {
+			WCET_LOOP_BOUND(9);
+			Value -= power;
+			digit++;
+		}
+		if (digit != '0' || !leading || i == SHELL_DIGITS - 1) {
+			Shell_Put(digit);
+			leading = 0;
+		}
+	}
+}
+
+
+/**
+ * @brief Appends the next chunk of the line: the text up to the next field and the field.
+ *
+ * Fields of the format: '#' unsigned value, '@' signed value, '$' name of the parameter
+ * whose id is the value (Shell_ParamNames).
+ */
+static void Shell_FormatChunk(void) {
+	char c = pgm_read_byte(Shell_Format);
+
+	while (c != '\0' && c != '#' && c != '@' && c != '$') {
+		WCET_LOOP_BOUND(SHELL_OUT_SIZE - 1);
+		Shell_Put(c);
+		c = pgm_read_byte(++Shell_Format);
+	}
+	if (c == '\0') {
+		Shell_Format = NULL;
+		return;
+	}
+	Shell_Format++;
+	if (c == '#') {
+		Shell_PutNumber(Shell_Values[Shell_NextValue]);
+	} else if (c == '@') {
+		sint32 value = (sint32)Shell_Values[Shell_NextValue];
+
+		if (value < 0) {
+			Shell_Put('-');
+			value = -value;
+		}
+		Shell_PutNumber((uint32)value);
+	} else {
+		PGM_P name = Shell_ParamNames[Shell_Values[Shell_NextValue]];
+
+		while ((c = pgm_read_byte(name++)) != '\0') {
+			WCET_LOOP_BOUND(sizeof(Shell_ParamNames[0]) - 1);
+			Shell_Put(c);
+		}
+	}
+	Shell_NextValue++;
+}
+
+
+/**
+ * @brief Snapshot of the next line of the response.
+ *
+ * @return Format of the line (flash), NULL when the response is complete.
+ */
+static PGM_P Shell_LoadRow(void) {
+	uint32 *v = Shell_Values;
+	uint8 row = Shell_Row;
+
+	switch (Shell_Command) {
+	case SHELL_CMD_HELP:
+		if (row == 0) {
+			return PSTR("wdgm | stats <entity> | prof | resets\r\n");
+		} else if (row == 1) {
+			return PSTR("cfg | set <param> <value> | commit | defaults\r\n");
+		} else if (row == 2) {
+			return PSTR("params: window task ledm min max wdto\r\n");
+		}
+		break;
+
+	case SHELL_CMD_WDGM:
+		if (row == 0) {
+			v[0] = WDGM_ProvideSupervisionStatus();
+			v[1] = WDGM_GetProfile();
+			return PSTR("wdgm status=# profile=#\r\n");
+		} else if (row <= WDGM_ENTITY_COUNT) {
+			WDGM_EntityConfigType config;
+
+			WDGM_GetEntityConfig((WDGM_EntityIdType)(row - 1), &config);
+			v[0] = row - 1;
+			v[1] = WDGM_GetEntityStatus((WDGM_EntityIdType)(row - 1));
+			v[2] = config.Enabled;
+			v[3] = config.MinCalls;
+			v[4] = config.MaxCalls;
+			return PSTR("ent=# nok=# en=# min=# max=#\r\n");
+		}
+		break;
+
+	case SHELL_CMD_STATS:
+		if (row < 2 + WDGM_STATS_BINS / SHELL_VALUES) {
+			WDGM_EntityStatsType stats;
+			uint8 i;
+
+			if (!WDGM_GetEntityStats((WDGM_EntityIdType)Shell_Arg, &stats)) {
+				v[0] = Shell_Arg;
+				return (row == 0) ? PSTR("ent=# none\r\n") : NULL;	// Failure-only entity
+			}
+			if (row == 0) {
+				v[0] = Shell_Arg;
+				v[1] = stats.Windows;
+				v[2] = stats.CallSum;
+				v[3] = stats.MinCount;
+				v[4] = stats.MaxCount;
+				return PSTR("ent=# win=# sum=# min=# max=#\r\n");
+			} else if (row == 1) {
+				v[0] = (uint32)(sint32)stats.MinMarginLow;
+				v[1] = (uint32)(sint32)stats.MinMarginHigh;
+				v[2] = stats.NearMisses;
+				v[3] = stats.Violations;
+				return PSTR("lo=@ hi=@ near=# viol=#\r\n");
+			}
+			for (i = 0; i < SHELL_VALUES; i++) {
+				WCET_LOOP_BOUND(SHELL_VALUES);
+				v[i] = stats.Histogram[(row - 2) * SHELL_VALUES + i];
+			}
+			return PSTR("hist # # # # # # # #\r\n");
+		}
+		break;
+
+	case SHELL_CMD_PROF:
+		if (row == 0) {
+			TickMon_StatsType tick;
+
+			TickMon_GetStats(&tick);
+			v[0] = tick.MaxUs;
+			v[1] = tick.Late;
+			v[2] = tick.Lost;
+			return PSTR("tick max=# late=# lost=#\r\n");
+		} else if (row == 1) {
+			v[0] = StackMon_GetFreeBytes();
+			v[1] = StackMon_GetPeakUsage();
+			return PSTR("stack free=# peak=#\r\n");
+		} else if (row == 2) {
+#if (VCCMON_ENABLED == 1)
+			VccMon_StatsType vcc;
+
+			VccMon_GetStats(&vcc);
+			v[0] = VccMon_GetVccMv();
+			v[1] = vcc.MinMv;
+			v[2] = vcc.Sags;
+			v[3] = vcc.Samples;
+			v[4] = vcc.SafeState;
+			return PSTR("vcc mv=# min=# sags=# n=# safe=#\r\n");
+#else
+			return PSTR("vcc off\r\n");
+#endif
+		}
+#if (CRITSEC_INSTRUMENTED == 1)
+		else if (row < 3 + CRITSEC_SITE_COUNT) {
+			CritSec_StatsType section;
+
+			CritSec_GetSiteStats((CritSec_SiteType)(row - 3), &section);
+			v[0] = row - 3;
+			v[1] = section.Count;
+			v[2] = section.MaxUs;
+			return PSTR("cs=# n=# max=#\r\n");
+		}
+#else
+		else if (row == 3) {
+			return PSTR("cs off\r\n");
+		}
+#endif
+		break;
+
+	case SHELL_CMD_RESETS:
+		if (row == 0) {
+			v[0] = Boot_GetResetFlags();
+			v[1] = LimpHome_GetResetCount();
+			v[2] = LimpHome_IsActive();
+			v[3] = LimpHome_GetDisabledEntities();
+			return PSTR("rst mcusr=# count=# limp=# off=#\r\n");
+		} else if (row == 1) {
+			CrashDump_RecordType dump;
+			uint8 entity;
+
+			if (!CrashDump_GetLastRecord(&dump)) {
+				return PSTR("dump none\r\n");
+			}
+			v[0] = dump.Pc;
+			v[1] = dump.Sp;
+			v[2] = dump.ActiveTask;
+			v[3] = 0;
+			for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+				WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+				if (dump.EntityStatus[entity] == NOK) {
+					v[3] |= (1UL << entity);
+				}
+			}
+			v[4] = dump.GlobalStatus;
+			return PSTR("dump pc=# sp=# task=# nok=# status=#\r\n");
+		}
+		break;
+
+	case SHELL_CMD_CFG:
+		if (row == 0) {
+			v[0] = RunCfg_GetSource();
+			v[1] = RunCfg_GetGeneration();
+			v[2] = RunCfg_GetState();
+			return PSTR("cfg src=# gen=# state=#\r\n");
+		} else if (row <= RUNCFG_PARAM_COUNT) {
+			v[0] = row - 1;
+			v[1] = RunCfg_GetActive((RunCfg_ParamIdType)(row - 1));
+			v[2] = RunCfg_GetStaged((RunCfg_ParamIdType)(row - 1));
+			return PSTR("$ active=# staged=#\r\n");
+		}
+		break;
+
+	case SHELL_CMD_REPLY:
+		if (row == 0) {
+			return Shell_Arg ? PSTR("ok\r\n") : PSTR("err\r\n");
+		}
+		break;
+
+	default:
+		break;
+	}
+	return NULL;
+}
+
+
+/**
+ * @brief Decimal argument, 0..65535.
+ */
+static bool Shell_ParseNumber(const char *Text, uint16 *Value) {
+	uint32 value = 0;
+
+	if (*Text == '\0') {
+		return false;
+	}
+	while (*Text != '\0') {
+		WCET_LOOP_BOUND(SHELL_LINE_SIZE - 1);
+		if (*Text < '0' || *Text > '9') {
+			return false;
+		}
+		value = value * 10 + (uint8)(*Text++ - '0');
+		if (value > 0xFFFF) {
+			return false;
+		}
+	}
+	*Value = (uint16)value;
+	return true;
+}
+
+
+/**
+ * @brief Runs the received line: splits it into words, starts the response.
+ *
+ * The commands changing the configuration only edit the staged copy (RunCfg_Set) or
+ * request the background write (RunCfg_Commit), both return at once.
+ */
+static void Shell_Execute(void) {
+	char *argv[SHELL_MAX_ARGS];
+	uint8 argc = 0;
+	uint8 ok = 0;
+	uint16 value = 0;
+	uint8 i;
+	char *p = Shell_Line;
+
+	Shell_Line[Shell_LineLength] = '\0';
+	Shell_Command = SHELL_CMD_REPLY;
+	while (*p != '\0' && !Shell_LineError) {
+		WCET_LOOP_BOUND(SHELL_LINE_SIZE);
+		if (*p == ' ') {
+			*p++ = '\0';
+		} else if (argc == SHELL_MAX_ARGS) {
+			Shell_LineError = 1;
+		} else {
+			argv[argc++] = p;
+			while (*p != '\0' && *p != ' ') {
+				WCET_LOOP_BOUND(SHELL_LINE_SIZE - 1);
+				p++;
+			}
+		}
+	}
+	if (!Shell_LineError && argc != 0) {
+		for (i = 0; i < SHELL_CMD_NAMES; i++) {
+			WCET_LOOP_BOUND(SHELL_CMD_NAMES);
+			if (strcmp_P(argv[0], Shell_Commands[i]) == 0) {
+				break;
+			}
+		}
+		switch ((Shell_CommandType)(i + 1)) {
+		case SHELL_CMD_STATS:
+			if (argc == 2 && Shell_ParseNumber(argv[1], &value) && value < WDGM_ENTITY_COUNT) {
+				Shell_Command = SHELL_CMD_STATS;
+				Shell_Arg = (uint8)value;
+			}
+			break;
+		case SHELL_CMD_SET:
+			for (i = 0; argc == 3 && i < RUNCFG_PARAM_COUNT; i++) {
+				WCET_LOOP_BOUND(RUNCFG_PARAM_COUNT);
+				if (strcmp_P(argv[1], Shell_ParamNames[i]) == 0) {
+					ok = Shell_ParseNumber(argv[2], &value) && RunCfg_Set((RunCfg_ParamIdType)i, value);
+					break;
+				}
+			}
+			break;
+		case SHELL_CMD_COMMIT:
+			ok = (argc == 1) && RunCfg_Commit();
+			break;
+		case SHELL_CMD_DEFAULTS:
+			if (argc == 1) {
+				RunCfg_RestoreDefaults();
+				ok = 1;
+			}
+			break;
+		case SHELL_CMD_HELP:
+		case SHELL_CMD_WDGM:
+		case SHELL_CMD_PROF:
+		case SHELL_CMD_RESETS:
+		case SHELL_CMD_CFG:
+			if (argc == 1) {
+				Shell_Command = (Shell_CommandType)(i + 1);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	if (Shell_Command == SHELL_CMD_REPLY) {
+		Shell_Arg = ok;
+	}
+	Shell_Row = 0;
+	Shell_LineLength = 0;
+	Shell_LineError = Shell_TypedAhead;
+	Shell_TypedAhead = 0;
+	Shell_LineReady = 0;
+}
+
+
+/**
+ * @brief One received byte: end of line, backspace, or a character of the line.
+ *
+ * A line typed while the previous one still waits for its answer is dropped and
+ * answered with "err" (it would overrun the 2-byte receive buffer anyway).
+ */
+static void Shell_Receive(uint8 Flags, char Data) {
+	if (Shell_LineReady) {
+		// Typed before the answer of the previous line, the rest of its end of line aside
+		if (Data != '\r' && Data != '\n') {
+			Shell_TypedAhead = 1;
+		}
+	} else if (Flags & ((1 << FE0) | (1 << DOR0) | (1 << UPE0))) {
+		Shell_LineError = 1;
+	} else if (Data == '\r' || Data == '\n') {
+		// "\r\n": the second one ends an empty line, ignored
+		Shell_LineReady = (Shell_LineLength != 0 || Shell_LineError);
+	} else if (Data == '\b' || Data == 0x7F) {
+		if (Shell_LineLength != 0) {
+			Shell_LineLength--;
+		}
+	} else if (Shell_LineLength < SHELL_LINE_SIZE - 1) {
+		Shell_Line[Shell_LineLength++] = Data;
+	} else {
+		Shell_LineError = 1;
+	}
+}
+#endif
+
+
+/**
+ * @brief Initializes USART0 for the shell and queues the first prompt.
+ *
+ * 9600 baud 8N1 in double speed mode like RemoteMon. Both directions are polled by
+ * Shell_MainFunction, the USART interrupts stay off.
+ *
+ * @return None
+ */
+void Shell_Init(void) {
+#if (SHELL_ENABLED == 1)
+	Shell_LineLength = 0;
+	Shell_LineError = 0;
+	Shell_LineReady = 0;
+	Shell_TypedAhead = 0;
+	Shell_Command = SHELL_CMD_NONE;
+	Shell_OutLength = 0;
+	Shell_OutSent = 0;
+	Shell_Format = PSTR("> ");
+	UBRR0 = SHELL_UBRR;
+	UCSR0A = (1 << U2X0);
+	UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+	UCSR0B = (1 << RXEN0) | (1 << TXEN0);
+#endif
+}
+
+
+/**
+ * @brief One step of the shell, called on every pass of the super loop.
+ *
+ * A step takes one received byte, or sends at most one byte and does one bounded piece of
+ * work: run a complete line, take the snapshot of one response line, or format one field
+ * of it. A response is sent line by line at the line rate (about 1ms per character), the
+ * next line is read once the response and its prompt are out. The step never waits on
+ * the USART, LEDM_Manage keeps its period while the shell is in use.
+ *
+ * @return None
+ */
+void Shell_MainFunction(void) {
+#if (SHELL_ENABLED == 1)
+	uint8 flags = UCSR0A;
+
+	// The receive buffer is emptied first, UDR0 is never written over an unread byte
+	if (flags & (1 << RXC0)) {
+		Shell_Receive(flags, UDR0);
+		return;
+	}
+	if (Shell_OutSent < Shell_OutLength && (flags & (1 << UDRE0))) {
+		UDR0 = Shell_Out[Shell_OutSent++];
+	}
+	if (Shell_Format != NULL) {
+		Shell_FormatChunk();
+	} else if (Shell_OutSent < Shell_OutLength) {
+		// Line complete, still being sent
+	} else if (Shell_Command != SHELL_CMD_NONE) {
+		Shell_OutLength = 0;
+		Shell_OutSent = 0;
+		Shell_NextValue = 0;
+		Shell_Format = Shell_LoadRow();
+		Shell_Row++;
+		if (Shell_Format == NULL) {
+			Shell_Command = SHELL_CMD_NONE;
+			Shell_Format = PSTR("> ");
+		}
+	} else if (Shell_LineReady) {
+		Shell_Execute();
+	}
+#endif
+}
@@ -0,0 +1,56 @@
+/*
+ * Shell.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef SHELL_H_
+#define SHELL_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include "Std_types.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> command shell on USART0 (RXD PD0, TXD PD1), polled from the super loop. It needs
+ * the USART alone: RemoteMon and Telemetry must be disabled.
+ */
+#ifndef SHELL_ENABLED
+#define SHELL_ENABLED			0
+#endif
+
+// 9600 baud 8N1, double speed (U2X0), see REMOTEMON_UBRR
+#define SHELL_BAUD				9600UL
+#define SHELL_UBRR				((F_CPU + 4UL * SHELL_BAUD) / (8UL * SHELL_BAUD) - 1)
+
+// Command line (without the end of line) and one response line
+#define SHELL_LINE_SIZE			32
+#define SHELL_OUT_SIZE			64
+
+// Values of one response line, see Shell_LoadRow
+#define SHELL_VALUES			8
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void Shell_Init(void);
+void Shell_MainFunction(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* SHELL_H_ */
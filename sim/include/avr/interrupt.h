@@ -0,0 +1,32 @@
+/*
+ * interrupt.h (host simulator)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * ISR() defines a plain function named after the vector, the simulator calls it when the
+ * interrupt is enabled, its flag is set and the I-bit of SREG is set. Naked/blocking
+ * attributes have no meaning on the host.
+ */
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+void sim_sei(void);
+void sim_cli(void);
+
+#define sei()		sim_sei()
+#define cli()		sim_cli()
+#define reti()
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define ISR_ALIASOF(vector)
+
+#define ISR(vector, ...)	void vector(void); void vector(void)
+#define EMPTY_INTERRUPT(vector)	void vector(void); void vector(void) {}
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
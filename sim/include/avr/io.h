@@ -0,0 +1,298 @@
+/*
+ * io.h (host simulator)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * ATmega328P register file for the host build. Every register access goes through
+ * sim_access8/sim_access16, which advance the simulated clock, run the peripheral models
+ * and dispatch the pending interrupts before the access takes place (see sim.c).
+ * Only the registers and bits used by the firmware are defined, with the avr-libc names.
+ */
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+volatile uint8_t *sim_access8(uint16_t Address);
+volatile uint16_t *sim_access16(uint16_t Address);
+
+#define _SFR_MEM8(addr)		(*sim_access8(addr))
+#define _SFR_MEM16(addr)	(*sim_access16(addr))
+#define _SFR_IO8(addr)		_SFR_MEM8((addr) + 0x20)
+#define _SFR_IO16(addr)		_SFR_MEM16((addr) + 0x20)
+#define _BV(bit)			(1 << (bit))
+#define _VECTOR(N)			__vector_ ## N
+
+#define RAMSTART	0x100
+#define RAMEND		0x8FF
+#define FLASHEND	0x7FFF
+#define E2END		0x3FF
+
+/* Ports */
+#define PINB	_SFR_IO8(0x03)
+#define DDRB	_SFR_IO8(0x04)
+#define PORTB	_SFR_IO8(0x05)
+#define PINC	_SFR_IO8(0x06)
+#define DDRC	_SFR_IO8(0x07)
+#define PORTC	_SFR_IO8(0x08)
+#define PIND	_SFR_IO8(0x09)
+#define DDRD	_SFR_IO8(0x0A)
+#define PORTD	_SFR_IO8(0x0B)
+
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+/* Interrupt flags and masks */
+#define TIFR0	_SFR_IO8(0x15)
+#define TOV0	0
+#define OCF0A	1
+#define OCF0B	2
+#define TIFR1	_SFR_IO8(0x16)
+#define TOV1	0
+#define OCF1A	1
+#define OCF1B	2
+#define ICF1	5
+#define TIFR2	_SFR_IO8(0x17)
+#define TOV2	0
+#define OCF2A	1
+#define OCF2B	2
+#define PCIFR	_SFR_IO8(0x1B)
+#define EIFR	_SFR_IO8(0x1C)
+#define INTF0	0
+#define INTF1	1
+#define EIMSK	_SFR_IO8(0x1D)
+#define INT0	0
+#define INT1	1
+#define GPIOR0	_SFR_IO8(0x1E)
+
+/* EEPROM */
+#define EECR	_SFR_IO8(0x1F)
+#define EERE	0
+#define EEPE	1
+#define EEMPE	2
+#define EERIE	3
+#define EEPM0	4
+#define EEPM1	5
+#define EEDR	_SFR_IO8(0x20)
+#define EEAR	_SFR_IO16(0x21)
+#define EEARL	_SFR_IO8(0x21)
+#define EEARH	_SFR_IO8(0x22)
+
+#define GTCCR	_SFR_IO8(0x23)
+
+/* Timer0 */
+#define TCCR0A	_SFR_IO8(0x24)
+#define WGM00	0
+#define WGM01	1
+#define COM0B0	4
+#define COM0B1	5
+#define COM0A0	6
+#define COM0A1	7
+#define TCCR0B	_SFR_IO8(0x25)
+#define CS00	0
+#define CS01	1
+#define CS02	2
+#define WGM02	3
+#define TCNT0	_SFR_IO8(0x26)
+#define OCR0A	_SFR_IO8(0x27)
+#define OCR0B	_SFR_IO8(0x28)
+
+#define SMCR	_SFR_IO8(0x33)
+#define MCUSR	_SFR_IO8(0x34)
+#define PORF	0
+#define EXTRF	1
+#define BORF	2
+#define WDRF	3
+#define MCUCR	_SFR_IO8(0x35)
+
+#define SP		_SFR_IO16(0x3D)
+#define SPL		_SFR_IO8(0x3D)
+#define SPH		_SFR_IO8(0x3E)
+#define SREG	_SFR_IO8(0x3F)
+#define SREG_I	7
+
+/* Watchdog */
+#define WDTCSR	_SFR_MEM8(0x60)
+#define WDP0	0
+#define WDP1	1
+#define WDP2	2
+#define WDE		3
+#define WDCE	4
+#define WDP3	5
+#define WDIE	6
+#define WDIF	7
+
+#define CLKPR	_SFR_MEM8(0x61)
+#define PRR		_SFR_MEM8(0x64)
+#define PCICR	_SFR_MEM8(0x68)
+#define EICRA	_SFR_MEM8(0x69)
+#define ISC00	0
+#define ISC01	1
+#define ISC10	2
+#define ISC11	3
+
+#define TIMSK0	_SFR_MEM8(0x6E)
+#define TOIE0	0
+#define OCIE0A	1
+#define OCIE0B	2
+#define TIMSK1	_SFR_MEM8(0x6F)
+#define TOIE1	0
+#define OCIE1A	1
+#define OCIE1B	2
+#define ICIE1	5
+#define TIMSK2	_SFR_MEM8(0x70)
+#define TOIE2	0
+#define OCIE2A	1
+#define OCIE2B	2
+
+/* ADC */
+#define ADC		_SFR_MEM16(0x78)
+#define ADCW	_SFR_MEM16(0x78)
+#define ADCL	_SFR_MEM8(0x78)
+#define ADCH	_SFR_MEM8(0x79)
+#define ADCSRA	_SFR_MEM8(0x7A)
+#define ADPS0	0
+#define ADPS1	1
+#define ADPS2	2
+#define ADIE	3
+#define ADIF	4
+#define ADATE	5
+#define ADSC	6
+#define ADEN	7
+#define ADCSRB	_SFR_MEM8(0x7B)
+#define ADTS0	0
+#define ADTS1	1
+#define ADTS2	2
+#define ADMUX	_SFR_MEM8(0x7C)
+#define MUX0	0
+#define MUX1	1
+#define MUX2	2
+#define MUX3	3
+#define ADLAR	5
+#define REFS0	6
+#define REFS1	7
+#define DIDR0	_SFR_MEM8(0x7E)
+
+/* Timer1 */
+#define TCCR1A	_SFR_MEM8(0x80)
+#define WGM10	0
+#define WGM11	1
+#define COM1B0	4
+#define COM1B1	5
+#define COM1A0	6
+#define COM1A1	7
+#define TCCR1B	_SFR_MEM8(0x81)
+#define CS10	0
+#define CS11	1
+#define CS12	2
+#define WGM12	3
+#define WGM13	4
+#define ICES1	6
+#define ICNC1	7
+#define TCCR1C	_SFR_MEM8(0x82)
+#define TCNT1	_SFR_MEM16(0x84)
+#define ICR1	_SFR_MEM16(0x86)
+#define OCR1A	_SFR_MEM16(0x88)
+#define OCR1B	_SFR_MEM16(0x8A)
+
+/* Timer2 */
+#define TCCR2A	_SFR_MEM8(0xB0)
+#define WGM20	0
+#define WGM21	1
+#define COM2B0	4
+#define COM2B1	5
+#define COM2A0	6
+#define COM2A1	7
+#define TCCR2B	_SFR_MEM8(0xB1)
+#define CS20	0
+#define CS21	1
+#define CS22	2
+#define WGM22	3
+#define TCNT2	_SFR_MEM8(0xB2)
+#define OCR2A	_SFR_MEM8(0xB3)
+#define OCR2B	_SFR_MEM8(0xB4)
+#define ASSR	_SFR_MEM8(0xB6)
+
+/* USART0 */
+#define UCSR0A	_SFR_MEM8(0xC0)
+#define MPCM0	0
+#define U2X0	1
+#define UPE0	2
+#define DOR0	3
+#define FE0		4
+#define UDRE0	5
+#define TXC0	6
+#define RXC0	7
+#define UCSR0B	_SFR_MEM8(0xC1)
+#define TXB80	0
+#define RXB80	1
+#define UCSZ02	2
+#define TXEN0	3
+#define RXEN0	4
+#define UDRIE0	5
+#define TXCIE0	6
+#define RXCIE0	7
+#define UCSR0C	_SFR_MEM8(0xC2)
+#define UCPOL0	0
+#define UCSZ00	1
+#define UCSZ01	2
+#define USBS0	3
+#define UPM00	4
+#define UPM01	5
+#define UBRR0	_SFR_MEM16(0xC4)
+#define UBRR0L	_SFR_MEM8(0xC4)
+#define UBRR0H	_SFR_MEM8(0xC5)
+#define UDR0	_SFR_MEM8(0xC6)
+
+/* Interrupt vectors */
+#define INT0_vect			_VECTOR(1)
+#define INT1_vect			_VECTOR(2)
+#define PCINT0_vect			_VECTOR(3)
+#define PCINT1_vect			_VECTOR(4)
+#define PCINT2_vect			_VECTOR(5)
+#define WDT_vect			_VECTOR(6)
+#define TIMER2_COMPA_vect	_VECTOR(7)
+#define TIMER2_COMPB_vect	_VECTOR(8)
+#define TIMER2_OVF_vect		_VECTOR(9)
+#define TIMER1_CAPT_vect	_VECTOR(10)
+#define TIMER1_COMPA_vect	_VECTOR(11)
+#define TIMER1_COMPB_vect	_VECTOR(12)
+#define TIMER1_OVF_vect		_VECTOR(13)
+#define TIMER0_COMPA_vect	_VECTOR(14)
+#define TIMER0_COMPB_vect	_VECTOR(15)
+#define TIMER0_OVF_vect		_VECTOR(16)
+#define SPI_STC_vect		_VECTOR(17)
+#define USART_RX_vect		_VECTOR(18)
+#define USART_UDRE_vect		_VECTOR(19)
+#define USART_TX_vect		_VECTOR(20)
+#define ADC_vect			_VECTOR(21)
+#define EE_READY_vect		_VECTOR(22)
+#define ANALOG_COMP_vect	_VECTOR(23)
+#define TWI_vect			_VECTOR(24)
+#define SPM_READY_vect		_VECTOR(25)
+#define _VECTORS_SIZE		(26 * 4)
+
+#endif /* SIM_AVR_IO_H_ */
@@ -0,0 +1,33 @@
+/*
+ * pgmspace.h (host simulator)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Flash constants live in ordinary host memory. Integer addresses below the flash size
+ * (FlashCrc walks the image by address) read the simulated flash image instead.
+ */
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+uint8_t sim_pgm_read_byte(uintptr_t Address);
+uint16_t sim_pgm_read_word(uintptr_t Address);
+
+#define PROGMEM
+#define PGM_P				const char *
+#define PSTR(s)				(s)
+#define pgm_read_byte(addr)	sim_pgm_read_byte((uintptr_t)(addr))
+#define pgm_read_word(addr)	sim_pgm_read_word((uintptr_t)(addr))
+#define pgm_read_dword(addr)	((uint32_t)pgm_read_word(addr) | ((uint32_t)pgm_read_word((uintptr_t)(addr) + 2) << 16))
+#define pgm_read_byte_near(addr)	pgm_read_byte(addr)
+#define pgm_read_word_near(addr)	pgm_read_word(addr)
+#define memcpy_P			memcpy
+#define strlen_P			strlen
+#define strcmp_P			strcmp
+#define strncmp_P			strncmp
+
+#endif /* SIM_AVR_PGMSPACE_H_ */
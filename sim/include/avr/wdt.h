@@ -0,0 +1,28 @@
+/*
+ * wdt.h (host simulator)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef SIM_AVR_WDT_H_
+#define SIM_AVR_WDT_H_
+
+#include <avr/io.h>
+
+void sim_wdr(void);
+
+#define wdt_reset()		sim_wdr()
+
+#define WDTO_15MS    0
+#define WDTO_30MS    1
+#define WDTO_60MS    2
+#define WDTO_120MS   3
+#define WDTO_250MS   4
+#define WDTO_500MS   5
+#define WDTO_1S   	 6
+#define WDTO_2S      7
+#define WDTO_4S      8
+#define WDTO_8S      9
+
+#endif /* SIM_AVR_WDT_H_ */
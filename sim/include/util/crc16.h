@@ -0,0 +1,66 @@
+/*
+ * crc16.h (host simulator)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * C versions of the avr-libc CRC helpers, bit-exact with the optimized AVR assembly.
+ */
+
+#ifndef SIM_UTIL_CRC16_H_
+#define SIM_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+/* Polynomial x^16 + x^15 + x^2 + 1 (0xA001 reflected), initial value 0xFFFF */
+static inline uint16_t _crc16_update(uint16_t crc, uint8_t a) {
+	int i;
+
+	crc ^= a;
+	for (i = 0; i < 8; ++i) {
+		crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : (crc >> 1);
+	}
+	return crc;
+}
+
+/* Polynomial x^16 + x^12 + x^5 + 1 (0x1021), initial value 0x0000 */
+static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data) {
+	int i;
+
+	crc = crc ^ ((uint16_t)data << 8);
+	for (i = 0; i < 8; i++) {
+		crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+	}
+	return crc;
+}
+
+/* Polynomial x^16 + x^12 + x^5 + 1 reflected (0x8408), initial value 0xFFFF */
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data) {
+	data ^= (uint8_t)(crc & 0xFF);
+	data ^= (uint8_t)(data << 4);
+	return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+/* Polynomial x^8 + x^5 + x^4 + 1 (0x8C reflected), initial value 0x00 */
+static inline uint8_t _crc_ibutton_update(uint8_t crc, uint8_t data) {
+	uint8_t i;
+
+	crc = crc ^ data;
+	for (i = 0; i < 8; i++) {
+		crc = (crc & 0x01) ? (crc >> 1) ^ 0x8C : (crc >> 1);
+	}
+	return crc;
+}
+
+/* Polynomial x^8 + x^2 + x + 1 (0x07), initial value 0x00 */
+static inline uint8_t _crc8_ccitt_update(uint8_t inCrc, uint8_t inData) {
+	uint8_t i;
+	uint8_t data = inCrc ^ inData;
+
+	for (i = 0; i < 8; i++) {
+		data = (data & 0x80) ? (uint8_t)((data << 1) ^ 0x07) : (uint8_t)(data << 1);
+	}
+	return data;
+}
+
+#endif /* SIM_UTIL_CRC16_H_ */
@@ -0,0 +1,18 @@
+/*
+ * delay.h (host simulator)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Busy waits advance the simulated clock, interrupts are serviced meanwhile.
+ */
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+void sim_delay_us(double Us);
+
+#define _delay_us(us)	sim_delay_us((double)(us))
+#define _delay_ms(ms)	sim_delay_us((double)(ms) * 1000.0)
+
+#endif /* SIM_UTIL_DELAY_H_ */
@@ -0,0 +1,1497 @@
+/*
+ * sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "sim.h"
+#include <avr/io.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+// Data space addresses of the modeled registers
+#define A_PINB		0x23
+#define A_DDRB		0x24
+#define A_PORTB		0x25
+#define A_PIND		0x29
+#define A_PORTD		0x2B
+#define A_TIFR0		0x35
+#define A_TIFR1		0x36
+#define A_TIFR2		0x37
+#define A_EIFR		0x3C
+#define A_EECR		0x3F
+#define A_EEDR		0x40
+#define A_EEARL		0x41
+#define A_TCCR0A	0x44
+#define A_TCCR0B	0x45
+#define A_TCNT0		0x46
+#define A_OCR0A		0x47
+#define A_OCR0B		0x48
+#define A_MCUSR		0x54
+#define A_SPL		0x5D
+#define A_SPH		0x5E
+#define A_SREG		0x5F
+#define A_WDTCSR	0x60
+#define A_TIMSK0	0x6E
+#define A_TIMSK1	0x6F
+#define A_TIMSK2	0x70
+#define A_ADCL		0x78
+#define A_ADCSRA	0x7A
+#define A_ADCSRB	0x7B
+#define A_ADMUX		0x7C
+#define A_TCCR1A	0x80
+#define A_TCCR1B	0x81
+#define A_TCNT1		0x84
+#define A_ICR1		0x86
+#define A_OCR1A		0x88
+#define A_OCR1B		0x8A
+#define A_TCCR2A	0xB0
+#define A_TCCR2B	0xB1
+#define A_TCNT2		0xB2
+#define A_OCR2A		0xB3
+#define A_OCR2B		0xB4
+#define A_UCSR0A	0xC0
+#define A_UCSR0B	0xC1
+#define A_UCSR0C	0xC2
+#define A_UBRR0		0xC4
+#define A_UDR0		0xC6
+
+#define SIM_REGS			0x100
+#define SIM_FLAG_MARKER		0x80		// Reserved bit of TIFRx/EIFR, set while presented
+#define SIM_SP_VALUE		(RAMEND - 0x20)
+#define SIM_PORTS			3			// B, C, D
+#define SIM_EEPROM_WRITE_US	3400		// Erase and write of one EEPROM byte
+#define SIM_ADC_MUX_BANDGAP	0x0E
+
+// VCD time unit: one CPU cycle must be a whole number of units
+#if ((1000000000UL % F_CPU) == 0)
+#define SIM_VCD_TIMESCALE	"1 ns"
+#define SIM_VCD_PER_CYCLE	(1000000000ULL / F_CPU)
+#else
+#define SIM_VCD_TIMESCALE	"1 ps"
+#define SIM_VCD_PER_CYCLE	(1000000000000ULL / F_CPU)
+#endif
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * State shared between the test process and the boot processes.
+ */
+typedef struct {
+	SimBootResultType Result;
+	uint32_t Seed;
+	uint8_t Mcusr;
+	uint8_t FlashReady;
+	uint32_t TotalFailures;
+	uint16_t NoinitSize;
+	uint8_t Noinit[SIM_NOINIT_MAX];
+	uint8_t Flash[SIM_FLASH_SIZE];
+	uint8_t EepromReady;
+	uint8_t Eeprom[SIM_EEPROM_SIZE];
+	uint16_t VccMv;
+	uint8_t User[SIM_SHARED_SIZE] __attribute__((aligned(8)));
+} SimSharedType;
+
+/**
+ * Trace records, in the order of the VCD variables.
+ */
+typedef enum {
+	SIM_TRACE_PORTB = 0,		// Value: PORTx after the write
+	SIM_TRACE_PORTC,
+	SIM_TRACE_PORTD,
+	SIM_TRACE_BOOT,				// Value: reset cause (SimResetType)
+	SIM_TRACE_WDT_IRQ,
+	SIM_TRACE_WDR,
+	SIM_TRACE_WDT_RESET,
+	SIM_TRACE_SIGNALS
+} SimTraceSignalType;
+
+typedef struct {
+	uint64_t Cycle;				// Since the first traced boot
+	uint8_t Signal;
+	uint8_t Value;
+} SimTraceRecordType;
+
+/**
+ * Trace buffer, shared with the boot processes.
+ */
+typedef struct {
+	uint64_t BaseCycle;			// Start of the running boot on the trace time axis
+	uint32_t Capacity;
+	uint32_t Count;
+	uint32_t Dropped;
+	SimTraceRecordType Records[];
+} SimTraceType;
+
+typedef struct {
+	uint8_t TccrA, TccrB, Tcnt, OcrA, OcrB, Timsk;
+	uint8_t Wide;				// 16-bit counter (Timer1)
+	const uint16_t *Prescalers;
+	uint8_t OcPort[2], OcPin[2];	// Output compare pins A/B (port index, bit)
+} SimTimerType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+int firmware_main(void);
+
+// .init sections of the firmware, run by the simulated C startup when linked
+void StackMon_Paint(void) __attribute__((weak));
+void Boot_EarlyInit(void) __attribute__((weak));
+
+// Sections of the variables kept across resets (NOINIT)
+extern uint8_t __start_sim_noinit[] __attribute__((weak));
+extern uint8_t __stop_sim_noinit[] __attribute__((weak));
+
+#define SIM_WEAK_VECTOR(n)	void __vector_ ## n(void) __attribute__((weak));
+SIM_WEAK_VECTOR(1)  SIM_WEAK_VECTOR(2)  SIM_WEAK_VECTOR(3)  SIM_WEAK_VECTOR(4)
+SIM_WEAK_VECTOR(5)  SIM_WEAK_VECTOR(6)  SIM_WEAK_VECTOR(7)  SIM_WEAK_VECTOR(8)
+SIM_WEAK_VECTOR(9)  SIM_WEAK_VECTOR(10) SIM_WEAK_VECTOR(11) SIM_WEAK_VECTOR(12)
+SIM_WEAK_VECTOR(13) SIM_WEAK_VECTOR(14) SIM_WEAK_VECTOR(15) SIM_WEAK_VECTOR(16)
+SIM_WEAK_VECTOR(17) SIM_WEAK_VECTOR(18) SIM_WEAK_VECTOR(19) SIM_WEAK_VECTOR(20)
+SIM_WEAK_VECTOR(21) SIM_WEAK_VECTOR(22) SIM_WEAK_VECTOR(23) SIM_WEAK_VECTOR(24)
+SIM_WEAK_VECTOR(25)
+
+static void (*const sim_vectors[SIM_VECTORS])(void) = {
+	NULL,        __vector_1,  __vector_2,  __vector_3,  __vector_4,  __vector_5,
+	__vector_6,  __vector_7,  __vector_8,  __vector_9,  __vector_10, __vector_11,
+	__vector_12, __vector_13, __vector_14, __vector_15, __vector_16, __vector_17,
+	__vector_18, __vector_19, __vector_20, __vector_21, __vector_22, __vector_23,
+	__vector_24, __vector_25
+};
+
+static const uint16_t sim_prescalers01[8] = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+static const uint16_t sim_prescalers2[8] = { 0, 1, 8, 32, 64, 128, 256, 1024 };
+
+static const SimTimerType sim_timers[3] = {
+	{ A_TCCR0A, A_TCCR0B, A_TCNT0, A_OCR0A, A_OCR0B, A_TIMSK0, 0, sim_prescalers01, { 2, 2 }, { 6, 5 } },
+	{ A_TCCR1A, A_TCCR1B, A_TCNT1, A_OCR1A, A_OCR1B, A_TIMSK1, 1, sim_prescalers01, { 0, 0 }, { 1, 2 } },
+	{ A_TCCR2A, A_TCCR2B, A_TCNT2, A_OCR2A, A_OCR2B, A_TIMSK2, 0, sim_prescalers2,  { 0, 2 }, { 3, 3 } },
+};
+
+static SimSharedType *sim_sh = NULL;
+static SimTraceType *sim_trace = NULL;
+static size_t sim_traceSize;
+static char *sim_tracePath;
+
+uint8_t sim_stack_area[SIM_STACK_AREA_SIZE];
+
+static uint8_t sim_mem[SIM_REGS] __attribute__((aligned(2)));		// Register file as seen by the firmware
+static uint8_t sim_shadow[SIM_REGS];	// Content after the last access (write detection)
+static uint16_t sim_pendAddr;
+static uint8_t sim_pendSize;
+static uint8_t sim_udrPresentedRx;
+
+static uint64_t sim_cycle;
+static uint64_t sim_maxCycles;
+static int sim_inHook;
+
+static uint8_t sim_tifr[3];
+static uint8_t sim_ocLevel[3][2];
+static uint8_t sim_mcusr;
+
+static uint8_t sim_wdtcsr;
+static uint64_t sim_wdtCount;
+static uint64_t sim_wdtTimeout;
+static uint64_t sim_wdceUntil;
+static uint8_t sim_wdceOpen;
+
+static uint8_t sim_eempeOpen;
+static uint64_t sim_eempeUntil;
+static uint8_t sim_eeBusy;				// Byte write in progress (EEPE)
+static uint64_t sim_eeDone;
+static uint16_t sim_eeAddr;
+static uint8_t sim_eeData;
+
+static uint8_t sim_adcOn;				// ADEN set: the next conversion is the first one
+static uint8_t sim_adcFirst;
+static uint8_t sim_adcBusy;				// Conversion in progress (ADSC)
+static uint64_t sim_adcDone;
+static uint8_t sim_adif;
+static uint8_t sim_adcTrigger;			// Level of the auto trigger flag at the last cycle
+
+static uint8_t sim_pinLevel[SIM_PORTS];		// External levels of the input pins
+static uint8_t sim_pinDriven[SIM_PORTS];	// Input pins driven by the test
+static uint8_t sim_lastLevels[SIM_PORTS];
+
+static uint8_t sim_rxQueue[SIM_UART_RX_QUEUE];
+static uint16_t sim_rxHead, sim_rxCount;
+static uint8_t sim_rxLineBusy;
+static uint64_t sim_rxDone;
+static uint8_t sim_rxFifo[2];
+static uint8_t sim_rxFifoCount;
+static uint8_t sim_rxOverrun;
+static uint8_t sim_txShift, sim_txShiftBusy, sim_txBuf, sim_txBufFull, sim_txc;
+static uint64_t sim_txDone;
+
+static SimHookType sim_hook;
+static uint64_t sim_hookPeriod, sim_hookNext;
+static SimPortHookType sim_portHook;
+static SimByteHookType sim_txHook;
+static SimVectorHookType sim_vectorHook;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+static void sim_finish(SimExitType Exit) __attribute__((noreturn));
+static void sim_reconcile(void);
+
+
+static uint32_t sim_random(void) {
+	uint32_t x = sim_sh->Seed ? sim_sh->Seed : 0x2545F491u;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	sim_sh->Seed = x;
+	return x;
+}
+
+
+/**
+ * @brief Appends a record at the current cycle (no-op while no trace is open).
+ */
+static inline void sim_trace_add(SimTraceSignalType Signal, uint8_t Value) {
+	SimTraceRecordType *rec;
+
+	if (!sim_trace) {
+		return;
+	}
+	if (sim_trace->Count >= sim_trace->Capacity) {
+		sim_trace->Dropped++;
+		return;
+	}
+	rec = &sim_trace->Records[sim_trace->Count++];
+	rec->Cycle = sim_trace->BaseCycle + sim_cycle;
+	rec->Signal = (uint8_t)Signal;
+	rec->Value = Value;
+}
+
+
+static uint16_t sim_reg16(uint8_t Address) {
+	return (uint16_t)(sim_mem[Address] | (sim_mem[Address + 1] << 8));
+}
+
+
+static void sim_set16(uint8_t Address, uint16_t Value) {
+	sim_mem[Address] = sim_shadow[Address] = (uint8_t)Value;
+	sim_mem[Address + 1] = sim_shadow[Address + 1] = (uint8_t)(Value >> 8);
+}
+
+
+/*******************************************************************************
+ ******************************   GPIO                  ************************
+ *******************************************************************************/
+static uint8_t sim_levels(uint8_t Port) {
+	uint8_t ddr = sim_mem[A_DDRB + 3 * Port];
+	uint8_t port = sim_mem[A_PORTB + 3 * Port];
+	uint8_t out = port;
+	uint8_t t, ch;
+
+	for (t = 0; t < 3; t++) {
+		for (ch = 0; ch < 2; ch++) {
+			uint8_t com = (sim_mem[sim_timers[t].TccrA] >> (ch ? 4 : 6)) & 3;
+			if (com && sim_timers[t].OcPort[ch] == Port) {
+				uint8_t bit = 1 << sim_timers[t].OcPin[ch];
+				out = (out & ~bit) | (sim_ocLevel[t][ch] ? bit : 0);
+			}
+		}
+	}
+	// Undriven inputs follow the pull-up (PORT bit)
+	return (out & ddr) | (~ddr & ((sim_pinLevel[Port] & sim_pinDriven[Port]) | (port & ~sim_pinDriven[Port])));
+}
+
+
+static void sim_ports_changed(void) {
+	uint8_t p;
+
+	for (p = 0; p < SIM_PORTS; p++) {
+		uint8_t levels = sim_levels(p);
+		if (levels != sim_lastLevels[p]) {
+			sim_lastLevels[p] = levels;
+			if (sim_portHook) {
+				sim_portHook((uint8_t)('B' + p), levels);
+			}
+		}
+	}
+}
+
+
+/*******************************************************************************
+ ******************************   Timers                ************************
+ *******************************************************************************/
+static void sim_timer_match(uint8_t T, uint8_t Channel) {
+	uint8_t com = (sim_mem[sim_timers[T].TccrA] >> (Channel ? 4 : 6)) & 3;
+
+	sim_tifr[T] |= Channel ? (1 << OCF0B) : (1 << OCF0A);
+	if (com == 1) {
+		sim_ocLevel[T][Channel] ^= 1;
+	} else if (com == 2) {
+		sim_ocLevel[T][Channel] = 0;
+	} else if (com == 3) {
+		sim_ocLevel[T][Channel] = 1;
+	}
+	if (com) {
+		sim_ports_changed();
+	}
+}
+
+
+static void sim_timer_tick(uint8_t T) {
+	const SimTimerType *tm = &sim_timers[T];
+	uint16_t max = tm->Wide ? 0xFFFF : 0xFF;
+	uint16_t cnt = tm->Wide ? sim_reg16(tm->Tcnt) : sim_mem[tm->Tcnt];
+	uint16_t ocrA = tm->Wide ? sim_reg16(tm->OcrA) : sim_mem[tm->OcrA];
+	uint16_t ocrB = tm->Wide ? sim_reg16(tm->OcrB) : sim_mem[tm->OcrB];
+	uint8_t wgm;
+	uint16_t top = max;
+	uint8_t ctc = 0;
+
+	if (tm->Wide) {
+		wgm = (sim_mem[tm->TccrA] & 3) | ((sim_mem[tm->TccrB] >> 1) & 0x0C);
+		if (wgm == 4) {
+			ctc = 1;
+			top = ocrA;
+		} else if (wgm == 12) {
+			ctc = 1;
+			top = sim_reg16(A_ICR1);
+		}
+	} else {
+		wgm = (sim_mem[tm->TccrA] & 3) | ((sim_mem[tm->TccrB] >> 1) & 0x04);
+		if (wgm == 2) {
+			ctc = 1;
+			top = ocrA;
+		}
+	}
+
+	// The flags are set on the timer clock that follows the match (with the CTC clear)
+	if (cnt == ocrA) {
+		sim_timer_match(T, 0);
+	}
+	if (cnt == ocrB) {
+		sim_timer_match(T, 1);
+	}
+	if (ctc && cnt == top) {
+		cnt = 0;
+	} else if (cnt == max) {
+		cnt = 0;
+		sim_tifr[T] |= (1 << TOV0);
+	} else {
+		cnt++;
+	}
+	if (tm->Wide) {
+		sim_set16(tm->Tcnt, cnt);
+	} else {
+		sim_mem[tm->Tcnt] = sim_shadow[tm->Tcnt] = (uint8_t)cnt;
+	}
+}
+
+
+/*******************************************************************************
+ ******************************   Watchdog              ************************
+ *******************************************************************************/
+static uint64_t sim_wdt_timeout_cycles(void) {
+	uint8_t wdp = (sim_wdtcsr & 0x07) | ((sim_wdtcsr >> 2) & 0x08);
+
+	// 2K cycles of the 128kHz WDT oscillator (16ms) doubled per prescaler step
+	return ((uint64_t)F_CPU * (16000ULL << wdp)) / 1000000ULL;
+}
+
+
+static void sim_wdt_step(void) {
+	if (!(sim_wdtcsr & ((1 << WDE) | (1 << WDIE)))) {
+		return;
+	}
+	if (++sim_wdtCount < sim_wdtTimeout) {
+		return;
+	}
+	sim_wdtCount = 0;
+	if (sim_wdtcsr & (1 << WDIE)) {
+		if ((sim_wdtcsr & (1 << WDE)) && (sim_wdtcsr & (1 << WDIF))) {
+			sim_finish(SIM_EXIT_WATCHDOG_RESET);	// Interrupt never serviced
+		}
+		sim_wdtcsr |= (1 << WDIF);
+	} else {
+		sim_finish(SIM_EXIT_WATCHDOG_RESET);
+	}
+}
+
+
+static void sim_wdt_write(uint8_t Value) {
+	uint8_t wde = sim_wdtcsr & (1 << WDE);
+	uint8_t wdp = sim_wdtcsr & ((1 << WDP3) | 0x07);
+
+	if (sim_wdceOpen && sim_cycle <= sim_wdceUntil) {
+		// Second write of the timed sequence: WDE can be cleared and the prescaler changed
+		wde = (Value & (1 << WDE)) || (sim_mcusr & (1 << WDRF)) ? (1 << WDE) : 0;
+		wdp = Value & ((1 << WDP3) | 0x07);
+		sim_wdceOpen = 0;
+	} else {
+		wde |= Value & (1 << WDE);
+		sim_wdceOpen = 0;
+		if ((Value & (1 << WDCE)) && (Value & (1 << WDE))) {
+			sim_wdceOpen = 1;
+			sim_wdceUntil = sim_cycle + 4;
+		}
+	}
+	sim_wdtcsr = (sim_wdtcsr & (1 << WDIF)) | (Value & (1 << WDIE)) | wde | wdp;
+	if (Value & (1 << WDIF)) {
+		sim_wdtcsr &= ~(1 << WDIF);
+	}
+	sim_wdtTimeout = sim_wdt_timeout_cycles();
+}
+
+
+/*******************************************************************************
+ ******************************   EEPROM                ************************
+ *******************************************************************************/
+static void sim_eeprom_step(void) {
+	if (sim_eeBusy && sim_cycle >= sim_eeDone) {
+		sim_sh->Eeprom[sim_eeAddr] = sim_eeData;
+		sim_eeBusy = 0;
+	}
+}
+
+
+/**
+ * @brief EECR write: EEMPE opens the 4-cycle window for EEPE, EERE reads EEDR at once.
+ *
+ * The byte is stored when the write completes: a boot ending during the write (reset,
+ * power loss) leaves the old content.
+ */
+static void sim_eecr_write(uint8_t Value) {
+	uint16_t address = (uint16_t)((sim_mem[A_EEARL] | (sim_mem[A_EEARL + 1] << 8)) % SIM_EEPROM_SIZE);
+	uint8_t mode = (Value >> EEPM0) & 0x03;
+
+	sim_mem[A_EECR] = Value & ((1 << EERIE) | (1 << EEPM1) | (1 << EEPM0));
+	if (sim_eeBusy) {
+		return;		// EEPE set: EERE and a new EEPE are ignored
+	}
+	if ((Value & (1 << EEPE)) && sim_eempeOpen && sim_cycle <= sim_eempeUntil) {
+		sim_eeAddr = address;
+		sim_eeData = (mode == 1) ? 0xFF : (mode == 2) ? (uint8_t)(sim_sh->Eeprom[address] & sim_mem[A_EEDR])
+													  : sim_mem[A_EEDR];
+		sim_eeBusy = 1;
+		sim_eeDone = sim_cycle + (uint64_t)SIM_EEPROM_WRITE_US * (F_CPU / 1000000UL);
+		sim_eempeOpen = 0;
+	} else if (Value & (1 << EEMPE)) {
+		sim_eempeOpen = 1;
+		sim_eempeUntil = sim_cycle + 4;
+	}
+	if (Value & (1 << EERE)) {
+		sim_mem[A_EEDR] = sim_shadow[A_EEDR] = sim_sh->Eeprom[address];
+	}
+}
+
+
+/*******************************************************************************
+ ******************************   ADC                   ************************
+ *******************************************************************************/
+static void sim_adc_start(uint8_t HalfClocks) {
+	static const uint8_t prescalers[8] = { 2, 2, 4, 8, 16, 32, 64, 128 };
+	uint8_t p = prescalers[sim_mem[A_ADCSRA] & 0x07];
+
+	sim_adcBusy = 1;
+	sim_adcDone = sim_cycle + (uint64_t)HalfClocks * p / 2;
+	sim_adcFirst = 0;
+}
+
+
+/**
+ * @brief Conversion result: the bandgap (channel 14) or GND, against AVCC or the internal
+ * 1.1V reference (REFS1:0 = 3); the ADC0..7 pins read as GND.
+ */
+static uint16_t sim_adc_result(void) {
+	uint8_t mux = sim_mem[A_ADMUX];
+	uint32_t ref = (((mux >> REFS0) & 3) == 3) ? SIM_BANDGAP_MV : sim_sh->VccMv;
+	uint32_t in = ((mux & 0x0F) == SIM_ADC_MUX_BANDGAP) ? SIM_BANDGAP_MV : 0;
+	uint32_t v = ref ? (in * 1024UL) / ref : 1023;
+
+	if (v > 1023) {
+		v = 1023;
+	}
+	return (mux & (1 << ADLAR)) ? (uint16_t)(v << 6) : (uint16_t)v;
+}
+
+
+/**
+ * @brief Ends the running conversion and starts the next one: free running (ADTS = 0)
+ * right away, the other auto trigger sources on the rising edge of their flag (13.5 ADC
+ * clocks). Analog comparator and INT0 triggers are not modeled.
+ */
+static void sim_adc_step(void) {
+	uint8_t a = sim_mem[A_ADCSRA];
+	uint8_t trigger = 0;
+
+	if (!(a & (1 << ADEN))) {
+		return;
+	}
+	if (sim_adcBusy && sim_cycle >= sim_adcDone) {
+		sim_set16(A_ADCL, sim_adc_result());
+		sim_adif = 1;
+		sim_adcBusy = 0;
+		if ((a & (1 << ADATE)) && (sim_mem[A_ADCSRB] & 0x07) == 0) {
+			sim_adc_start(26);
+		}
+	}
+	if (a & (1 << ADATE)) {
+		switch (sim_mem[A_ADCSRB] & 0x07) {
+		case 3: trigger = sim_tifr[0] & (1 << OCF0A); break;
+		case 4: trigger = sim_tifr[0] & (1 << TOV0);  break;
+		case 5: trigger = sim_tifr[1] & (1 << OCF1B); break;
+		case 6: trigger = sim_tifr[1] & (1 << TOV1);  break;
+		case 7: trigger = sim_tifr[1] & (1 << ICF1);  break;
+		default: break;
+		}
+		if (trigger && !sim_adcTrigger && !sim_adcBusy) {
+			sim_adc_start(sim_adcFirst ? 50 : 27);
+		}
+	}
+	sim_adcTrigger = trigger;
+}
+
+
+/**
+ * @brief ADCSRA write: ADSC starts a conversion (25 ADC clocks after ADEN, then 13), ADEN
+ * cleared aborts it.
+ */
+static void sim_adcsra_write(uint8_t Value) {
+	sim_mem[A_ADCSRA] = Value & ~((1 << ADSC) | (1 << ADIF));
+	if (Value & (1 << ADIF)) {
+		sim_adif = 0;
+	}
+	if (!(Value & (1 << ADEN))) {
+		sim_adcOn = 0;
+		sim_adcBusy = 0;
+		return;
+	}
+	if (!sim_adcOn) {
+		sim_adcOn = 1;
+		sim_adcFirst = 1;
+	}
+	if ((Value & (1 << ADSC)) && !sim_adcBusy) {
+		sim_adc_start(sim_adcFirst ? 50 : 26);
+	}
+}
+
+
+/*******************************************************************************
+ ******************************   USART0                ************************
+ *******************************************************************************/
+static uint64_t sim_uart_frame_cycles(void) {
+	uint8_t c = sim_mem[A_UCSR0C];
+	uint8_t bits = 1 + 8 + ((c & (1 << UPM01)) ? 1 : 0) + ((c & (1 << USBS0)) ? 2 : 1);
+	uint64_t bit = (uint64_t)(sim_reg16(A_UBRR0) + 1) * ((sim_mem[A_UCSR0A] & (1 << U2X0)) ? 8 : 16);
+
+	return bit * bits;
+}
+
+
+static void sim_uart_step(void) {
+	if (sim_rxLineBusy && sim_cycle >= sim_rxDone) {
+		uint8_t data = sim_rxQueue[sim_rxHead];
+
+		sim_rxHead = (sim_rxHead + 1) % SIM_UART_RX_QUEUE;
+		sim_rxCount--;
+		sim_rxLineBusy = 0;
+		if (sim_mem[A_UCSR0B] & (1 << RXEN0)) {
+			if (sim_rxFifoCount < 2) {
+				sim_rxFifo[sim_rxFifoCount++] = data;
+			} else {
+				sim_rxOverrun = 1;
+			}
+		}
+	}
+	if (!sim_rxLineBusy && sim_rxCount) {
+		sim_rxLineBusy = 1;
+		sim_rxDone = sim_cycle + sim_uart_frame_cycles();
+	}
+	if (sim_txShiftBusy && sim_cycle >= sim_txDone) {
+		if (sim_txHook) {
+			sim_txHook(sim_txShift);
+		}
+		sim_txShiftBusy = 0;
+		if (sim_txBufFull) {
+			sim_txShift = sim_txBuf;
+			sim_txBufFull = 0;
+			sim_txShiftBusy = 1;
+			sim_txDone = sim_cycle + sim_uart_frame_cycles();
+		} else {
+			sim_txc = 1;
+		}
+	}
+}
+
+
+static void sim_uart_tx(uint8_t Data) {
+	if (!(sim_mem[A_UCSR0B] & (1 << TXEN0))) {
+		return;
+	}
+	if (!sim_txShiftBusy) {
+		sim_txShift = Data;
+		sim_txShiftBusy = 1;
+		sim_txDone = sim_cycle + sim_uart_frame_cycles();
+	} else if (!sim_txBufFull) {
+		sim_txBuf = Data;
+		sim_txBufFull = 1;
+	}
+}
+
+
+static uint8_t sim_ucsr0a(void) {
+	uint8_t a = sim_mem[A_UCSR0A] & ((1 << U2X0) | (1 << MPCM0));
+
+	if (sim_rxFifoCount) {
+		a |= (1 << RXC0);
+		if (sim_rxOverrun) {
+			a |= (1 << DOR0);
+		}
+	}
+	if (!sim_txBufFull) {
+		a |= (1 << UDRE0);
+	}
+	if (sim_txc) {
+		a |= (1 << TXC0);
+	}
+	return a;
+}
+
+
+/*******************************************************************************
+ ******************************   Core                  ************************
+ *******************************************************************************/
+static void sim_step(uint32_t Cycles) {
+	uint8_t t;
+
+	while (Cycles--) {
+		sim_cycle++;
+		for (t = 0; t < 3; t++) {
+			uint16_t p = sim_timers[t].Prescalers[sim_mem[sim_timers[t].TccrB] & 0x07];
+			if (p && (sim_cycle & (p - 1)) == 0) {
+				sim_timer_tick(t);
+			}
+		}
+		sim_wdt_step();
+		sim_uart_step();
+		sim_eeprom_step();
+		sim_adc_step();
+		if (sim_cycle >= sim_maxCycles) {
+			sim_finish(SIM_EXIT_STOPPED);
+		}
+	}
+}
+
+
+static void sim_run_hook(void) {
+	if (sim_hook && !sim_inHook && sim_cycle >= sim_hookNext) {
+		sim_hookNext += sim_hookPeriod;
+		sim_inHook = 1;
+		sim_hook();
+		sim_reconcile();
+		sim_inHook = 0;
+	}
+}
+
+
+/**
+ * @brief Value shown to the firmware for the next access of a register.
+ */
+static void sim_present(uint16_t Address) {
+	uint8_t v = sim_mem[Address];
+
+	switch (Address) {
+	case A_PINB: case A_PINB + 3: case A_PINB + 6:
+		v = sim_levels((uint8_t)((Address - A_PINB) / 3));
+		break;
+	case A_TIFR0: case A_TIFR1: case A_TIFR2:
+		v = sim_tifr[Address - A_TIFR0] | SIM_FLAG_MARKER;
+		break;
+	case A_MCUSR:
+		v = sim_mcusr;
+		break;
+	case A_EECR:
+		v = sim_mem[A_EECR] | SIM_FLAG_MARKER;
+		if (sim_eeBusy) {
+			v |= (1 << EEPE);
+		}
+		if (sim_eempeOpen && sim_cycle <= sim_eempeUntil) {
+			v |= (1 << EEMPE);
+		}
+		break;
+	case A_WDTCSR:
+		v = sim_wdtcsr;
+		break;
+	case A_ADCSRA:
+		v = sim_mem[A_ADCSRA] & ~((1 << ADSC) | (1 << ADIF));
+		if (sim_adcBusy) {
+			v |= (1 << ADSC);
+		}
+		if (sim_adif) {
+			v |= (1 << ADIF);
+		}
+		break;
+	case A_SPL:
+		v = (uint8_t)SIM_SP_VALUE;
+		break;
+	case A_SPH:
+		v = (uint8_t)(SIM_SP_VALUE >> 8);
+		break;
+	case A_UCSR0A:
+		v = sim_ucsr0a();
+		break;
+	case A_UDR0:
+		sim_udrPresentedRx = sim_rxFifoCount != 0;
+		v = sim_udrPresentedRx ? sim_rxFifo[0] : 0;
+		break;
+	default:
+		break;
+	}
+	sim_mem[Address] = sim_shadow[Address] = v;
+}
+
+
+static void sim_write(uint16_t Address, uint8_t Value) {
+	switch (Address) {
+	case A_PINB: case A_PINB + 3: case A_PINB + 6:
+		// Writing ones to PINx toggles PORTx
+		sim_mem[Address + 2] = sim_shadow[Address + 2] = sim_mem[Address + 2] ^ Value;
+		sim_trace_add((SimTraceSignalType)((Address - A_PINB) / 3), sim_mem[Address + 2]);
+		sim_ports_changed();
+		break;
+	case A_TIFR0: case A_TIFR1: case A_TIFR2:
+		sim_tifr[Address - A_TIFR0] &= ~Value;
+		break;
+	case A_MCUSR:
+		sim_mcusr &= Value;		// Flags are only cleared by writing zero
+		break;
+	case A_WDTCSR:
+		sim_wdt_write(Value);
+		break;
+	case A_EECR:
+		sim_eecr_write(Value);
+		break;
+	case A_ADCSRA:
+		sim_adcsra_write(Value);
+		break;
+	case A_UCSR0A:
+		if (Value & (1 << TXC0)) {
+			sim_txc = 0;
+		}
+		sim_mem[Address] = Value & ((1 << U2X0) | (1 << MPCM0));
+		break;
+	case A_UDR0:
+		sim_uart_tx(Value);
+		break;
+	case A_PORTB: case A_PORTB + 3: case A_PORTB + 6:
+		sim_mem[Address] = Value;
+		sim_trace_add((SimTraceSignalType)((Address - A_PORTB) / 3), Value);
+		sim_ports_changed();
+		break;
+	default:
+		sim_mem[Address] = Value;
+		if ((Address >= A_DDRB && Address <= A_PORTD) || Address == A_TCCR0A ||
+			Address == A_TCCR1A || Address == A_TCCR2A) {
+			sim_ports_changed();
+		}
+		break;
+	}
+}
+
+
+static void sim_read(uint16_t Address) {
+	if (Address == A_UDR0 && sim_rxFifoCount) {
+		sim_rxFifo[0] = sim_rxFifo[1];
+		sim_rxFifoCount--;
+		sim_rxOverrun = 0;
+	}
+}
+
+
+/**
+ * @brief Classifies the previous access as read or write and applies its side effects.
+ */
+static void sim_reconcile(void) {
+	uint8_t i;
+	uint8_t size = sim_pendSize;
+
+	sim_pendSize = 0;
+	for (i = 0; i < size; i++) {
+		uint16_t a = sim_pendAddr + i;
+		uint8_t v = sim_mem[a];
+		uint8_t written = (v != sim_shadow[a]);
+
+		if (a == A_UDR0 && !sim_udrPresentedRx) {
+			written = 1;	// Nothing to read: the access was a transmit
+		}
+		if (written) {
+			sim_write(a, v);
+		} else {
+			sim_read(a);
+		}
+		sim_present(a);
+	}
+}
+
+
+static uint8_t sim_pending_vector(void) {
+	if ((sim_wdtcsr & (1 << WDIE)) && (sim_wdtcsr & (1 << WDIF)))		return 6;
+	if ((sim_mem[A_TIMSK2] & sim_tifr[2]) & (1 << OCF2A))				return 7;
+	if ((sim_mem[A_TIMSK2] & sim_tifr[2]) & (1 << OCF2B))				return 8;
+	if ((sim_mem[A_TIMSK2] & sim_tifr[2]) & (1 << TOV2))				return 9;
+	if ((sim_mem[A_TIMSK1] & sim_tifr[1]) & (1 << ICF1))				return 10;
+	if ((sim_mem[A_TIMSK1] & sim_tifr[1]) & (1 << OCF1A))				return 11;
+	if ((sim_mem[A_TIMSK1] & sim_tifr[1]) & (1 << OCF1B))				return 12;
+	if ((sim_mem[A_TIMSK1] & sim_tifr[1]) & (1 << TOV1))				return 13;
+	if ((sim_mem[A_TIMSK0] & sim_tifr[0]) & (1 << OCF0A))				return 14;
+	if ((sim_mem[A_TIMSK0] & sim_tifr[0]) & (1 << OCF0B))				return 15;
+	if ((sim_mem[A_TIMSK0] & sim_tifr[0]) & (1 << TOV0))				return 16;
+	if ((sim_mem[A_UCSR0B] & (1 << RXCIE0)) && sim_rxFifoCount)			return 18;
+	if ((sim_mem[A_UCSR0B] & (1 << UDRIE0)) && !sim_txBufFull)			return 19;
+	if ((sim_mem[A_UCSR0B] & (1 << TXCIE0)) && sim_txc)					return 20;
+	if ((sim_mem[A_ADCSRA] & (1 << ADIE)) && sim_adif)					return 21;
+	if ((sim_mem[A_EECR] & (1 << EERIE)) && !sim_eeBusy)				return 22;
+	return 0;
+}
+
+
+/**
+ * @brief Runs the highest priority pending interrupt, if the I-bit is set.
+ *
+ * Like the MCU, at most one interrupt is serviced between two accesses of the main code.
+ */
+static void sim_dispatch(void) {
+	uint8_t vector;
+	uint64_t start = sim_cycle;
+
+	if (sim_inHook || !(sim_mem[A_SREG] & (1 << SREG_I))) {
+		return;
+	}
+	vector = sim_pending_vector();
+	if (!vector) {
+		return;
+	}
+	// Flags cleared by the hardware when the vector is executed
+	switch (vector) {
+	case 6:
+		sim_trace_add(SIM_TRACE_WDT_IRQ, 1);
+		sim_wdtcsr &= ~(1 << WDIF);
+		if (sim_wdtcsr & (1 << WDE)) {
+			sim_wdtcsr &= ~(1 << WDIE);		// Interrupt-then-reset: next timeout resets
+		}
+		break;
+	case 7:  sim_tifr[2] &= ~(1 << OCF2A); break;
+	case 8:  sim_tifr[2] &= ~(1 << OCF2B); break;
+	case 9:  sim_tifr[2] &= ~(1 << TOV2);  break;
+	case 10: sim_tifr[1] &= ~(1 << ICF1);  break;
+	case 11: sim_tifr[1] &= ~(1 << OCF1A); break;
+	case 12: sim_tifr[1] &= ~(1 << OCF1B); break;
+	case 13: sim_tifr[1] &= ~(1 << TOV1);  break;
+	case 14: sim_tifr[0] &= ~(1 << OCF0A); break;
+	case 15: sim_tifr[0] &= ~(1 << OCF0B); break;
+	case 16: sim_tifr[0] &= ~(1 << TOV0);  break;
+	case 20: sim_txc = 0; break;
+	case 21: sim_adif = 0; break;
+	default: break;
+	}
+	if (!sim_vectors[vector]) {
+		sim_sh->Result.Vector = vector;
+		sim_finish(SIM_EXIT_BAD_INTERRUPT);
+	}
+	sim_mem[A_SREG] = sim_shadow[A_SREG] = sim_mem[A_SREG] & ~(1 << SREG_I);
+	if (sim_vectorHook) {
+		sim_inHook = 1;
+		sim_vectorHook(vector);
+		sim_reconcile();
+		sim_inHook = 0;
+	}
+	sim_step(SIM_ISR_CYCLES / 2);
+	sim_vectors[vector]();
+	sim_reconcile();
+	sim_step(SIM_ISR_CYCLES / 2);
+	sim_mem[A_SREG] = sim_shadow[A_SREG] = sim_mem[A_SREG] | (1 << SREG_I);	// reti
+	sim_sh->Result.IsrCount[vector]++;
+	sim_sh->Result.IsrCycles[vector] += sim_cycle - start;
+}
+
+
+static volatile uint8_t *sim_access(uint16_t Address, uint8_t Size) {
+	sim_reconcile();
+	if (!sim_inHook) {
+		sim_step(SIM_ACCESS_CYCLES);
+		sim_run_hook();
+		sim_dispatch();
+	}
+	sim_present(Address);
+	if (Size == 2) {
+		sim_present(Address + 1);
+	}
+	sim_pendAddr = Address;
+	sim_pendSize = Size;
+	return &sim_mem[Address];
+}
+
+
+volatile uint8_t *sim_access8(uint16_t Address) {
+	return sim_access(Address, 1);
+}
+
+
+volatile uint16_t *sim_access16(uint16_t Address) {
+	return (volatile uint16_t *)sim_access(Address, 2);
+}
+
+
+void sim_sei(void) {
+	sim_reconcile();
+	sim_mem[A_SREG] = sim_shadow[A_SREG] = sim_mem[A_SREG] | (1 << SREG_I);
+	if (!sim_inHook) {
+		sim_step(1);
+	}
+}
+
+
+void sim_cli(void) {
+	sim_reconcile();
+	sim_mem[A_SREG] = sim_shadow[A_SREG] = sim_mem[A_SREG] & ~(1 << SREG_I);
+	if (!sim_inHook) {
+		sim_step(1);
+	}
+}
+
+
+void sim_wdr(void) {
+	sim_reconcile();
+	sim_wdtCount = 0;
+	sim_trace_add(SIM_TRACE_WDR, 1);
+	if (!sim_inHook) {
+		sim_step(1);
+	}
+}
+
+
+void sim_delay_us(double Us) {
+	uint64_t cycles = (uint64_t)(Us * (F_CPU / 1000000.0));
+
+	sim_reconcile();
+	while (cycles--) {
+		sim_step(1);
+		sim_run_hook();
+		sim_dispatch();
+	}
+}
+
+
+uint8_t sim_pgm_read_byte(uintptr_t Address) {
+	if (Address < SIM_FLASH_SIZE) {
+		if (!sim_inHook) {
+			sim_reconcile();
+			sim_step(3);	// LPM
+		}
+		return sim_sh->Flash[Address];
+	}
+	return *(const uint8_t *)Address;
+}
+
+
+uint16_t sim_pgm_read_word(uintptr_t Address) {
+	return (uint16_t)(sim_pgm_read_byte(Address) | (sim_pgm_read_byte(Address + 1) << 8));
+}
+
+
+/*******************************************************************************
+ ******************************   Boot control          ************************
+ *******************************************************************************/
+static void sim_shared_init(void) {
+	if (!sim_sh) {
+		sim_sh = mmap(NULL, sizeof(SimSharedType), PROT_READ | PROT_WRITE,
+					  MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (sim_sh == MAP_FAILED) {
+			perror("sim: mmap");
+			exit(2);
+		}
+		memset(sim_sh, 0, sizeof(SimSharedType));
+		sim_sh->Seed = 1;
+		sim_sh->VccMv = SIM_VCC_MV;
+	}
+}
+
+
+/**
+ * @brief Fills the flash image with a pseudo-random program and its CRC-16/CCITT-FALSE.
+ */
+static void sim_flash_init(void) {
+	uint32_t i;
+	uint16_t crc = 0xFFFF;
+	uint8_t b;
+
+	for (i = 0; i < SIM_FLASH_SIZE; i++) {
+		sim_sh->Flash[i] = (i < SIM_FLASH_IMAGE_END) ? (uint8_t)sim_random() : 0xFF;
+	}
+	for (i = 0; i < SIM_FLASH_IMAGE_END; i++) {
+		if (i == SIM_FLASH_CRC_ADDR || i == SIM_FLASH_CRC_ADDR + 1) {
+			continue;
+		}
+		crc ^= (uint16_t)sim_sh->Flash[i] << 8;
+		for (b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	sim_sh->Flash[SIM_FLASH_CRC_ADDR] = (uint8_t)crc;
+	sim_sh->Flash[SIM_FLASH_CRC_ADDR + 1] = (uint8_t)(crc >> 8);
+	sim_sh->FlashReady = 1;
+}
+
+
+static void sim_finish(SimExitType Exit) {
+	size_t size = (size_t)(__stop_sim_noinit - __start_sim_noinit);
+
+	if (size > SIM_NOINIT_MAX) {
+		size = SIM_NOINIT_MAX;
+	}
+	if (size) {
+		memcpy(sim_sh->Noinit, __start_sim_noinit, size);
+	}
+	sim_sh->NoinitSize = (uint16_t)size;
+	sim_sh->Mcusr = sim_mcusr;
+	if (Exit == SIM_EXIT_WATCHDOG_RESET) {
+		sim_sh->Mcusr |= (1 << WDRF);
+		sim_trace_add(SIM_TRACE_WDT_RESET, 1);
+	}
+	if (sim_trace) {
+		sim_trace->BaseCycle += sim_cycle;
+	}
+	sim_sh->Result.Exit = Exit;
+	sim_sh->Result.EndUs = sim_now_us();
+	fflush(stdout);
+	fflush(stderr);
+	_exit(0);
+}
+
+
+static void sim_child(SimResetType Cause, uint64_t MaxUs) __attribute__((noreturn));
+static void sim_child(SimResetType Cause, uint64_t MaxUs) {
+	size_t size = (size_t)(__stop_sim_noinit - __start_sim_noinit);
+	size_t i;
+
+	sim_maxCycles = (MaxUs * (F_CPU / 1000000UL));
+	sim_cycle = 0;
+
+	// Reset values of the registers
+	memset(sim_mem, 0, sizeof(sim_mem));
+	sim_eempeOpen = 0;
+	sim_eeBusy = 0;
+	sim_adcOn = 0;
+	sim_adcBusy = 0;
+	sim_adif = 0;
+	sim_adcTrigger = 0;
+	sim_mem[A_UCSR0C] = (1 << UCSZ01) | (1 << UCSZ00);
+	memcpy(sim_shadow, sim_mem, sizeof(sim_mem));
+
+	switch (Cause) {
+	case SIM_RESET_POWER_ON:  sim_mcusr = (1 << PORF); break;
+	case SIM_RESET_EXTERNAL:  sim_mcusr = sim_sh->Mcusr | (1 << EXTRF); break;
+	case SIM_RESET_BROWN_OUT: sim_mcusr = sim_sh->Mcusr | (1 << BORF); break;
+	default:                  sim_mcusr = sim_sh->Mcusr; break;
+	}
+	// WDRF forces WDE: the dog keeps running with the 16ms reset prescaler
+	sim_wdtcsr = (sim_mcusr & (1 << WDRF)) ? (1 << WDE) : 0;
+	sim_wdtTimeout = sim_wdt_timeout_cycles();
+
+	// SRAM content: random after power-on, kept otherwise
+	if (size > SIM_NOINIT_MAX) {
+		size = SIM_NOINIT_MAX;
+	}
+	if (Cause == SIM_RESET_POWER_ON || sim_sh->NoinitSize != size) {
+		for (i = 0; i < size; i++) {
+			__start_sim_noinit[i] = (uint8_t)sim_random();
+		}
+	} else if (size) {
+		memcpy(__start_sim_noinit, sim_sh->Noinit, size);
+	}
+	for (i = 0; i < SIM_STACK_AREA_SIZE; i++) {
+		sim_stack_area[i] = (uint8_t)sim_random();
+	}
+	for (i = 0; i < SIM_PORTS; i++) {
+		sim_lastLevels[i] = sim_levels((uint8_t)i);
+	}
+	sim_trace_add(SIM_TRACE_BOOT, (uint8_t)Cause);
+	for (i = 0; i < SIM_PORTS; i++) {
+		sim_trace_add((SimTraceSignalType)(SIM_TRACE_PORTB + i), 0);
+	}
+
+	// C startup: .init1 .. .init3 hooks, then main
+	if (StackMon_Paint) {
+		StackMon_Paint();
+	}
+	if (Boot_EarlyInit) {
+		Boot_EarlyInit();
+	}
+	firmware_main();
+	sim_finish(SIM_EXIT_RETURNED);
+}
+
+
+/**
+ * @brief Runs one boot of the firmware in a child process.
+ *
+ * @param Cause Reset that starts the boot (MCUSR and SRAM content follow from it).
+ * @param MaxUs Simulated time after which the boot is stopped.
+ * @param Result Optional copy of the boot result.
+ * @return How the boot ended.
+ */
+SimExitType sim_boot(SimResetType Cause, uint64_t MaxUs, SimBootResultType *Result) {
+	pid_t pid;
+	int wstatus;
+
+	sim_shared_init();
+	if (!sim_sh->FlashReady) {
+		sim_flash_init();
+	}
+	if (!sim_sh->EepromReady) {
+		memset(sim_sh->Eeprom, 0xFF, SIM_EEPROM_SIZE);
+		sim_sh->EepromReady = 1;
+	}
+	memset(&sim_sh->Result, 0, sizeof(sim_sh->Result));
+	sim_sh->Result.Exit = SIM_EXIT_CRASHED;
+
+	fflush(stdout);
+	fflush(stderr);
+	pid = fork();
+	if (pid < 0) {
+		perror("sim: fork");
+		exit(2);
+	}
+	if (pid == 0) {
+		sim_child(Cause, MaxUs);
+	}
+	if (waitpid(pid, &wstatus, 0) < 0 || !WIFEXITED(wstatus)) {
+		sim_sh->Result.Exit = SIM_EXIT_CRASHED;
+	}
+	if (Result) {
+		*Result = sim_sh->Result;
+	}
+	return sim_sh->Result.Exit;
+}
+
+
+
+/**
+ * @brief Runs one test scenario: clears the test scratch memory (sim_shared), installs the
+ * periodic hook and boots the firmware.
+ *
+ * @param Hook Periodic hook of the scenario, NULL: none.
+ * @param PeriodUs Period of the hook.
+ * @param Cause Reset that starts the boot.
+ * @param MaxUs Simulated time after which the boot is stopped.
+ * @param Result Optional copy of the boot result.
+ * @return How the boot ended.
+ */
+SimExitType sim_run(SimHookType Hook, uint32_t PeriodUs, SimResetType Cause, uint64_t MaxUs,
+					SimBootResultType *Result) {
+	memset(sim_shared(), 0, SIM_SHARED_SIZE);
+	sim_set_hook(Hook, PeriodUs);
+	return sim_boot(Cause, MaxUs, Result);
+}
+
+
+void sim_stop(void) {
+	sim_finish(SIM_EXIT_STOPPED);
+}
+
+
+void *sim_shared(void) {
+	sim_shared_init();
+	return sim_sh->User;
+}
+
+
+void sim_set_seed(uint32_t Seed) {
+	sim_shared_init();
+	sim_sh->Seed = Seed ? Seed : 1;
+	sim_sh->FlashReady = 0;
+}
+
+
+/*******************************************************************************
+ ******************************   Waveform trace        ************************
+ *******************************************************************************/
+/**
+ * @brief Starts recording the following boots for a VCD file.
+ *
+ * @param Path VCD file written by sim_trace_close.
+ * @param Capacity Records kept, 0: SIM_TRACE_CAPACITY. The buffer is reserved here, the
+ *                 boots only append to it.
+ * @return 0, -1 when the buffer cannot be mapped.
+ */
+int sim_trace_open(const char *Path, uint32_t Capacity) {
+	if (sim_trace) {
+		sim_trace_close();
+	}
+	if (!Capacity) {
+		Capacity = SIM_TRACE_CAPACITY;
+	}
+	sim_traceSize = sizeof(SimTraceType) + (size_t)Capacity * sizeof(SimTraceRecordType);
+	sim_trace = mmap(NULL, sim_traceSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (sim_trace == MAP_FAILED) {
+		perror("sim: trace mmap");
+		sim_trace = NULL;
+		return -1;
+	}
+	sim_trace->BaseCycle = 0;
+	sim_trace->Capacity = Capacity;
+	sim_trace->Count = 0;
+	sim_trace->Dropped = 0;
+	sim_tracePath = strdup(Path);
+	return 0;
+}
+
+
+/**
+ * @brief Vector value change: b<binary> <id>, without leading zeros.
+ */
+static void sim_vcd_vector(FILE *F, uint32_t Value, char Id) {
+	int b = 31;
+
+	while (b > 0 && !((Value >> b) & 1)) {
+		b--;
+	}
+	fputc('b', F);
+	for (; b >= 0; b--) {
+		fputc((Value >> b) & 1 ? '1' : '0', F);
+	}
+	fprintf(F, " %c\n", Id);
+}
+
+
+/**
+ * @brief Writes the recorded boots as a VCD file and stops the trace.
+ *
+ * Each port is dumped as an 8-bit vector (PORTx) and as one wire per pin (Px0..Px7), the
+ * WDT interrupt, wdr and the watchdog reset as events, the boot count with the reset
+ * cause of the last boot as integers.
+ *
+ * @return Records dropped because the buffer was full, -1 when the file cannot be written.
+ */
+long sim_trace_close(void) {
+	static const char *const events[] = { "wdt_irq", "wdr", "wdt_reset" };
+	uint8_t last[SIM_PORTS] = { 0, 0, 0 };
+	uint64_t time = 0;
+	uint32_t boots = 0;
+	long dropped;
+	uint32_t i;
+	FILE *f;
+	int p, b;
+
+	if (!sim_trace) {
+		return -1;
+	}
+	dropped = sim_trace->Dropped;
+	f = fopen(sim_tracePath, "w");
+	if (!f) {
+		perror(sim_tracePath);
+		dropped = -1;
+	} else {
+		fprintf(f, "$version ATmega328P host simulator, F_CPU %lu Hz $end\n", (unsigned long)F_CPU);
+		if (sim_trace->Dropped) {
+			fprintf(f, "$comment %lu records dropped (trace buffer full) $end\n",
+					(unsigned long)sim_trace->Dropped);
+		}
+		fprintf(f, "$timescale %s $end\n$scope module atmega328p $end\n", SIM_VCD_TIMESCALE);
+		for (p = 0; p < SIM_PORTS; p++) {
+			fprintf(f, "$var wire 8 %c PORT%c [7:0] $end\n", 'B' + p, 'B' + p);
+			for (b = 0; b < 8; b++) {
+				fprintf(f, "$var wire 1 %c%d P%c%d $end\n", 'B' + p, b, 'B' + p, b);
+			}
+		}
+		for (i = 0; i < 3; i++) {
+			fprintf(f, "$var event 1 E%u %s $end\n", (unsigned)i, events[i]);
+		}
+		fprintf(f, "$var integer 32 N boot $end\n$var integer 8 R reset_cause $end\n");
+		fprintf(f, "$upscope $end\n$enddefinitions $end\n#0\n$dumpvars\n");
+		for (p = 0; p < SIM_PORTS; p++) {
+			sim_vcd_vector(f, 0, (char)('B' + p));
+			for (b = 0; b < 8; b++) {
+				fprintf(f, "0%c%d\n", 'B' + p, b);
+			}
+		}
+		fprintf(f, "b0 N\nb0 R\n$end\n");
+
+		for (i = 0; i < sim_trace->Count; i++) {
+			const SimTraceRecordType *rec = &sim_trace->Records[i];
+			uint64_t t = rec->Cycle * SIM_VCD_PER_CYCLE;
+
+			if (rec->Signal <= SIM_TRACE_PORTD && rec->Value == last[rec->Signal]) {
+				continue;		// Same value written again
+			}
+			if (t != time) {
+				fprintf(f, "#%llu\n", (unsigned long long)t);
+				time = t;
+			}
+			switch (rec->Signal) {
+			case SIM_TRACE_PORTB: case SIM_TRACE_PORTC: case SIM_TRACE_PORTD:
+				p = rec->Signal - SIM_TRACE_PORTB;
+				sim_vcd_vector(f, rec->Value, (char)('B' + p));
+				for (b = 0; b < 8; b++) {
+					if (((rec->Value ^ last[p]) >> b) & 1) {
+						fprintf(f, "%c%c%d\n", (rec->Value >> b) & 1 ? '1' : '0', 'B' + p, b);
+					}
+				}
+				last[p] = rec->Value;
+				break;
+			case SIM_TRACE_BOOT:
+				sim_vcd_vector(f, ++boots, 'N');
+				sim_vcd_vector(f, rec->Value, 'R');
+				break;
+			default:
+				fprintf(f, "1E%u\n", (unsigned)(rec->Signal - SIM_TRACE_WDT_IRQ));
+				break;
+			}
+		}
+		if (fclose(f) != 0) {
+			perror(sim_tracePath);
+			dropped = -1;
+		}
+	}
+	munmap(sim_trace, sim_traceSize);
+	sim_trace = NULL;
+	free(sim_tracePath);
+	sim_tracePath = NULL;
+	return dropped;
+}
+
+
+/*******************************************************************************
+ ******************************   Stimuli / observation ************************
+ *******************************************************************************/
+uint64_t sim_cycles(void) {
+	return sim_cycle;
+}
+
+
+uint64_t sim_now_us(void) {
+	return (sim_cycle * 1000000ULL) / F_CPU;
+}
+
+
+void sim_set_hook(SimHookType Hook, uint32_t PeriodUs) {
+	sim_hook = Hook;
+	sim_hookPeriod = ((uint64_t)PeriodUs * F_CPU) / 1000000ULL;
+	if (!sim_hookPeriod) {
+		sim_hookPeriod = 1;
+	}
+	sim_hookNext = sim_cycle + sim_hookPeriod;
+}
+
+
+/**
+ * @brief Hook called at the entry of every interrupt (vector number), before the ISR.
+ */
+void sim_set_vector_hook(SimVectorHookType Hook) {
+	sim_vectorHook = Hook;
+}
+
+
+void sim_set_port_hook(SimPortHookType Hook) {
+	sim_portHook = Hook;
+}
+
+
+void sim_set_uart_tx_hook(SimByteHookType Hook) {
+	sim_txHook = Hook;
+}
+
+
+/**
+ * @brief Queues bytes on the RX line, sent back to back at the configured baud rate.
+ */
+void sim_uart_rx(const uint8_t *Data, uint16_t Length) {
+	while (Length-- && sim_rxCount < SIM_UART_RX_QUEUE) {
+		sim_rxQueue[(sim_rxHead + sim_rxCount) % SIM_UART_RX_QUEUE] = *Data++;
+		sim_rxCount++;
+	}
+}
+
+
+uint16_t sim_uart_rx_pending(void) {
+	return sim_rxCount;
+}
+
+
+void sim_pin_input(uint8_t Port, uint8_t Pin, uint8_t Level) {
+	uint8_t p = (uint8_t)(Port - 'B');
+
+	sim_pinDriven[p] |= (1 << Pin);
+	sim_pinLevel[p] = Level ? (sim_pinLevel[p] | (1 << Pin)) : (sim_pinLevel[p] & ~(1 << Pin));
+	sim_ports_changed();
+}
+
+
+/**
+ * @brief Supply voltage (AVCC) seen by the ADC, kept across boots. Takes effect at the
+ * end of the running conversion.
+ */
+void sim_set_vcc_mv(uint16_t Mv) {
+	sim_shared_init();
+	sim_sh->VccMv = Mv;
+}
+
+
+uint16_t sim_vcc_mv(void) {
+	sim_shared_init();
+	return sim_sh->VccMv;
+}
+
+
+uint8_t sim_port_levels(uint8_t Port) {
+	return sim_levels((uint8_t)(Port - 'B'));
+}
+
+
+uint8_t *sim_flash(void) {
+	sim_shared_init();
+	return sim_sh->Flash;
+}
+
+
+/**
+ * @brief EEPROM content, kept across boots (erased, 0xFF, before the first boot).
+ */
+uint8_t *sim_eeprom(void) {
+	sim_shared_init();
+	if (!sim_sh->EepromReady) {
+		memset(sim_sh->Eeprom, 0xFF, SIM_EEPROM_SIZE);
+		sim_sh->EepromReady = 1;
+	}
+	return sim_sh->Eeprom;
+}
+
+
+void sim_check(int Ok, const char *Expression, const char *File, int Line) {
+	if (!Ok) {
+		sim_shared_init();
+		sim_sh->Result.Failures++;
+		sim_sh->TotalFailures++;
+		fprintf(stderr, "%s:%d: check failed at %llu us: %s\n", File, Line,
+				(unsigned long long)(sim_cycle * 1000000ULL / F_CPU), Expression);
+	}
+}
+
+
+/**
+ * @brief SIM_CHECK failures of all the boots so far.
+ */
+uint32_t sim_failures(void) {
+	sim_shared_init();
+	return sim_sh->TotalFailures;
+}
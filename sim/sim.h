@@ -0,0 +1,150 @@
+/*
+ * sim.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Host simulator of the ATmega328P peripherals used by the firmware: register file,
+ * Timer0/1/2 (normal and CTC modes, output compare pins), watchdog (timed sequence,
+ * interrupt / reset / interrupt-then-reset modes), USART0, GPIO ports, flash image, EEPROM
+ * (kept across boots, 3.4ms per byte write), ADC (bandgap and GND channels against AVCC or
+ * the internal reference, single, free-running and timer-triggered conversions, VCC set by
+ * the test) and the C startup (.noinit kept across watchdog resets, .init sections).
+ *
+ * The unmodified firmware sources are compiled for the host against sim/include, main()
+ * is renamed to firmware_main. Each sim_boot runs one boot in a forked process, so every
+ * boot starts from pristine .data/.bss like the MCU after a reset; .noinit and MCUSR are
+ * carried over between boots through shared memory.
+ * sim_run is the usual scenario step of a test: it clears the test scratch memory
+ * (sim_shared), installs the periodic hook and boots.
+ *
+ * Timing model: every register access costs SIM_ACCESS_CYCLES CPU cycles and every
+ * interrupt entry/exit SIM_ISR_CYCLES, C code between two register accesses takes no
+ * simulated time. Peripherals are stepped cycle by cycle at F_CPU.
+ *
+ * Known limitation: a register access is classified as read or write after the fact by
+ * comparing the register with its previous content. Writing the value a register already
+ * holds is seen as a read; this only matters for registers with write side effects and
+ * is handled for the interrupt flag registers and EECR (reserved bit set as write marker) and for
+ * UDR0 (every access is a transmit while no received byte is pending). ADIF is only cleared
+ * by the execution of ADC_vect, not by writing it.
+ *
+ * Waveform trace: between sim_trace_open and sim_trace_close every write to PORTB/C/D, the
+ * WDT interrupts, wdr and the watchdog resets are stored with their cycle in a buffer
+ * preallocated in shared memory, the boots follow each other on one time axis. The buffer
+ * is written as a VCD file (GTKWave) by sim_trace_close; records past the capacity are
+ * dropped and counted.
+ *
+ * CPU load: the boot result holds the count and the cycles (entry to reti) of every
+ * interrupt vector, the load of a handler is its cycles over the boot cycles. Only the
+ * register accesses cost cycles, the C code between them is free: this load is a lower
+ * bound, the cycle budgets of tools/wcet_budget.txt give the upper one.
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define SIM_ACCESS_CYCLES		4			/* CPU cycles charged per register access     */
+#define SIM_ISR_CYCLES			20			/* Interrupt entry, prologue, epilogue, reti  */
+#define SIM_FLASH_SIZE			0x8000
+#define SIM_FLASH_IMAGE_END		0x2000		/* Simulated .text + .data initializers       */
+#define SIM_FLASH_CRC_ADDR		0x1FFE		/* Word holding the image CRC (FlashCrc)      */
+#define SIM_STACK_AREA_SIZE		512			/* Painted stand-in of the free SRAM           */
+#define SIM_NOINIT_MAX			256			/* Bytes of .noinit carried across resets     */
+#define SIM_EEPROM_SIZE			1024
+#define SIM_SHARED_SIZE			4096		/* Test scratch memory kept across boots      */
+#define SIM_UART_RX_QUEUE		1024
+#define SIM_TRACE_CAPACITY		(1UL << 20)	/* Default trace records (16 bytes each)      */
+#define SIM_VECTORS				26
+#define SIM_VCC_MV				5000		/* Supply voltage before sim_set_vcc_mv       */
+#define SIM_BANDGAP_MV			1100		/* Internal reference (ADC channel 14)        */
+
+#define SIM_CHECK(cond)			sim_check((cond) != 0, #cond, __FILE__, __LINE__)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	SIM_RESET_POWER_ON = 0,
+	SIM_RESET_EXTERNAL,
+	SIM_RESET_BROWN_OUT,
+	SIM_RESET_WATCHDOG
+} SimResetType;
+
+typedef enum {
+	SIM_EXIT_STOPPED = 0,		/* sim_stop or the boot time limit                 */
+	SIM_EXIT_WATCHDOG_RESET,	/* WDT timeout in reset mode                        */
+	SIM_EXIT_BAD_INTERRUPT,		/* Enabled interrupt without ISR (jumps to reset)   */
+	SIM_EXIT_RETURNED,			/* firmware_main returned                           */
+	SIM_EXIT_CRASHED			/* The boot process died (signal)                   */
+} SimExitType;
+
+typedef struct {
+	SimExitType Exit;
+	uint64_t EndUs;				/* Simulated time at the end of the boot            */
+	uint32_t Failures;			/* SIM_CHECK failures during the boot               */
+	uint8_t Vector;				/* Vector number of a bad interrupt                 */
+	uint32_t IsrCount[SIM_VECTORS];		/* Executions per interrupt vector          */
+	uint64_t IsrCycles[SIM_VECTORS];	/* CPU cycles per vector, entry to reti     */
+} SimBootResultType;
+
+typedef void (*SimHookType)(void);
+typedef void (*SimPortHookType)(uint8_t Port, uint8_t Levels);
+typedef void (*SimByteHookType)(uint8_t Data);
+typedef void (*SimVectorHookType)(uint8_t Vector);
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+/* Run control (test side) */
+SimExitType sim_boot(SimResetType Cause, uint64_t MaxUs, SimBootResultType *Result);
+SimExitType sim_run(SimHookType Hook, uint32_t PeriodUs, SimResetType Cause, uint64_t MaxUs,
+					SimBootResultType *Result);
+void sim_stop(void);
+void *sim_shared(void);
+void sim_set_seed(uint32_t Seed);
+uint32_t sim_failures(void);
+int sim_trace_open(const char *Path, uint32_t Capacity);
+long sim_trace_close(void);
+
+/* Stimuli and observation (from hooks, inside the boot) */
+uint64_t sim_cycles(void);
+uint64_t sim_now_us(void);
+void sim_set_hook(SimHookType Hook, uint32_t PeriodUs);
+void sim_set_port_hook(SimPortHookType Hook);
+void sim_set_uart_tx_hook(SimByteHookType Hook);
+void sim_set_vector_hook(SimVectorHookType Hook);
+void sim_uart_rx(const uint8_t *Data, uint16_t Length);
+uint16_t sim_uart_rx_pending(void);
+void sim_pin_input(uint8_t Port, uint8_t Pin, uint8_t Level);
+void sim_set_vcc_mv(uint16_t Mv);
+uint16_t sim_vcc_mv(void);
+uint8_t sim_port_levels(uint8_t Port);
+uint8_t *sim_flash(void);
+uint8_t *sim_eeprom(void);
+void sim_check(int Ok, const char *Expression, const char *File, int Line);
+
+/* Firmware side (register access, shims) */
+volatile uint8_t *sim_access8(uint16_t Address);
+volatile uint16_t *sim_access16(uint16_t Address);
+void sim_sei(void);
+void sim_cli(void);
+void sim_wdr(void);
+void sim_delay_us(double Us);
+uint8_t sim_pgm_read_byte(uintptr_t Address);
+uint16_t sim_pgm_read_word(uintptr_t Address);
+
+extern uint8_t sim_stack_area[SIM_STACK_AREA_SIZE];
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* SIM_H_ */
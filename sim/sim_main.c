@@ -0,0 +1,82 @@
+/*
+ * sim_main.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Command line runner of the host simulator: boots the firmware from power-on, follows the
+ * watchdog resets and prints what USART0 transmits. With --vcd the port writes and the
+ * watchdog events of all the boots are written to a VCD file for GTKWave.
+ *
+ * usage: firmware_sim [--vcd file] [run_ms [max_boots]]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define SIM_MAIN_RUN_MS			2000UL
+#define SIM_MAIN_MAX_BOOTS		10
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+static const char *const sim_exitNames[] = {
+	"stopped", "watchdog reset", "bad interrupt", "main returned", "crashed"
+};
+
+
+static void sim_main_tx(uint8_t Data) {
+	putchar(Data);
+	if (Data == '\n') {
+		fflush(stdout);
+	}
+}
+
+
+int main(int argc, char **argv) {
+	const char *vcd = NULL;
+	uint64_t runUs;
+	int maxBoots;
+	SimResetType cause = SIM_RESET_POWER_ON;
+	SimBootResultType result;
+	long dropped;
+	int boot;
+
+	if (argc > 2 && !strcmp(argv[1], "--vcd")) {
+		vcd = argv[2];
+		argc -= 2;
+		argv += 2;
+	}
+	runUs = (argc > 1 ? strtoull(argv[1], NULL, 0) : SIM_MAIN_RUN_MS) * 1000ULL;
+	maxBoots = argc > 2 ? atoi(argv[2]) : SIM_MAIN_MAX_BOOTS;
+	if (vcd && sim_trace_open(vcd, 0) != 0) {
+		return 2;
+	}
+	sim_set_uart_tx_hook(sim_main_tx);
+	for (boot = 1; boot <= maxBoots; boot++) {
+		sim_boot(cause, runUs, &result);
+		fprintf(stderr, "boot %d: %s after %llu us", boot, sim_exitNames[result.Exit],
+				(unsigned long long)result.EndUs);
+		if (result.Exit == SIM_EXIT_BAD_INTERRUPT) {
+			fprintf(stderr, " (vector %u)", result.Vector);
+		}
+		fputc('\n', stderr);
+		if (result.Exit != SIM_EXIT_WATCHDOG_RESET) {
+			break;
+		}
+		cause = SIM_RESET_WATCHDOG;
+	}
+	if (vcd) {
+		dropped = sim_trace_close();
+		if (dropped < 0) {
+			return 2;
+		}
+		fprintf(stderr, "%s written%s\n", vcd, dropped ? " (trace buffer full, end missing)" : "");
+	}
+	return (result.Exit == SIM_EXIT_CRASHED || result.Exit == SIM_EXIT_BAD_INTERRUPT) ? 1 : 0;
+}
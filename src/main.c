@@ -23,6 +23,19 @@
 #include "buzzer.h"			/* Buzzer and Speaker driver*/
 #include "Exti.h"			/* Eternal Interrupt driver*/
 #include "gicr.h"			/* General Interrupt Control Register driver */
+#include "HBMON.h"			/* External heartbeat monitor (Timer1 input capture) */
+#include "CrashDump.h"		/* Post-mortem of watchdog resets */
+#include "FlashCrc.h"		/* Background flash integrity check */
+#include "Boot.h"			/* Boot phase time stamps and fast-boot mode */
+#include "LimpHome.h"		/* Reset-loop detection and degraded profile */
+#include "ExtWdg.h"			/* Heartbeat output to an external watchdog */
+#include "RemoteMon.h"		/* Serial heartbeat frames of remote nodes */
+#include "Telemetry.h"		/* Supervision statistics on USART0 TX */
+#include "WinCal.h"			/* Supervision windows learned after a cold boot */
+#include "TickMon.h"		/* Latency and lost ticks of the 1ms tick */
+#include "VccMon.h"			/* Supply voltage through the ADC bandgap channel */
+#include "RunCfg.h"			/* Runtime configuration (EEPROM A/B copies) */
+#include "Shell.h"			/* Serial command shell on USART0 */
 /*******************************************************************************
  ******************************   includes End      ****************************
  *******************************************************************************/
@@ -33,9 +46,10 @@
  *******************************************************************************/
 static vuint32_t checkLedTime = 0;
 static vuint32_t checkWDGTime = 0;
+static uint32 checkFlashCrcTime = 0;
+static uint32 checkTelemetryTime = 0;
 
 char resetTimes[10];
-uint8 resets = 0;
 /*******************************************************************************
  *************************   Global variables end      ***********************
  *******************************************************************************/
@@ -44,6 +58,9 @@ uint8 resets = 0;
  *******************************   Main start    *******************************
  *******************************************************************************/
 int main() {
+	Boot_MarkPhase(BOOT_PHASE_MAIN);
+
+#if (BOOT_FAST_MODE == 0)
 	/**
 	 *
 	 * @if the buzzer make noise and turn ON and OFF very rapid,
@@ -52,6 +69,19 @@ int main() {
 	 *
 	 */
 	Buzzer_Init();
+#endif
+
+	/**
+	 * Publish the post-mortem captured by the WDT early-warning interrupt
+	 * before the watchdog reset (if any), see CrashDump_GetLastRecord
+	 */
+	CrashDump_Init();
+
+	/**
+	 * Periods, windows and WDT timeout of this run (RunCfg_Active), from the EEPROM or the
+	 * flash defaults. Before every init function that reads them.
+	 */
+	RunCfg_Init();
 
 	/**
 	 * The initialization of LCD make some delay in the time
@@ -59,17 +89,39 @@ int main() {
 	 */
 //	LCD_Init();
 //	LCD_String_xy(0,0, "WDG reset times");
-//	utoa(resets, resetTimes);   //function to convert from char to string to display it
+//	utoa(LimpHome_GetResetCount(), resetTimes);   //function to convert from char to string to display it
 //	LCD_String(resetTimes);
 
 
     LEDM_Init();
     GPIO_Write(PROJECT_START_LED, HIGH);
+    Boot_MarkPhase(BOOT_PHASE_DRIVERS);
+    Boot_ReleaseTimer();
+    TickMon_Init();
     timers_init();
+    HBMon_Init();
     WDGDrv_Init();
     WDGM_Init();
+    RemoteMon_Init();
+    Telemetry_Init();
+    Shell_Init();
+    LimpHome_Init();
+    WinCal_Init();
+    ExtWdg_Init();
+    VccMon_Init();
+    FlashCrc_Init();
+    Boot_MarkPhase(BOOT_PHASE_SUPERVISION);
     GPIO_Write(PROJECT_START_LED, LOW);
 
+#if (BOOT_FAST_MODE == 1)
+    /**
+     * Interrupts are enabled once, after every init function. The first LEDM_Manage call
+     * runs right away instead of after its first 10ms period.
+     */
+    sei();
+    checkLedTime = HAL_GetTick() - RunCfg_Active.LedmPeriodMs;
+#endif
+
     while(1) {
 
     	// get the current time
@@ -86,32 +138,74 @@ int main() {
          *
 		 * @if We changing the checking time of the LED
 		 * from                                10ms          to         5ms
-		 * the reset time changed from       ~64.11ms        to        ~114ms
+		 * the reset time changed from       ~64.11ms        to        ~117ms
+		 * (LEDM_PERIOD_MS, checked by test/test_reset_timing.c; RunCfg_Active.LedmPeriodMs
+		 * at run time)
 		 *
 		 */
-        if (currentTimerTime - checkLedTime >= 10) {
+        if (currentTimerTime - checkLedTime >= RunCfg_Active.LedmPeriodMs) {
+            CrashDump_EnterTask(CRASHDUMP_TASK_LEDM);
             LEDM_Manage();
+            CrashDump_LeaveTask();
+            // Reset-to-operational time, see Boot_GetTimeToOperationalUs
+            Boot_MarkOperational();
             // update the LED time checker
             checkLedTime = currentTimerTime;
         }
 
         /**
          *
-         * The WDGM_MainFunction shall be called periodically every 20ms.
+         * The WDGM_MainFunction shall be called periodically every 20ms (RunCfg_Active.WdgmTaskMs).
          * Check and run watchdog main function if it's time
          *
          * */
-        if (currentTimerTime - checkWDGTime >= 20) {
+        if (currentTimerTime - checkWDGTime >= RunCfg_Active.WdgmTaskMs) {
         	/**
         	 *
         	 * @if We commenting WDGM_MainFunction the WDG reset( system reset )
         	 * after 64ms
         	 *
         	 */
+            CrashDump_EnterTask(CRASHDUMP_TASK_WDGM);
             WDGM_MainFunction();
+            LimpHome_MainFunction();
+            WinCal_MainFunction();
+            RunCfg_MainFunction();
+            ExtWdg_Kick();
+            CrashDump_LeaveTask();
             // update the WGDT time checker
             checkWDGTime = currentTimerTime;
         }
+
+        /**
+         *
+         * One time-sliced step of the flash CRC (bounded by FLASHCRC_STEP_BUDGET_US)
+         *
+         * */
+        if (currentTimerTime - checkFlashCrcTime >= FLASHCRC_STEP_PERIOD_MS) {
+            CrashDump_EnterTask(CRASHDUMP_TASK_FLASHCRC);
+            FlashCrc_MainFunction();
+            CrashDump_LeaveTask();
+            checkFlashCrcTime = currentTimerTime;
+        }
+
+        /**
+         *
+         * Statistics frame of the next supervised entity (queued, sent by the UDRE interrupt)
+         *
+         * */
+        if (currentTimerTime - checkTelemetryTime >= TELEMETRY_PERIOD_MS) {
+            Telemetry_MainFunction();
+            checkTelemetryTime = currentTimerTime;
+        }
+
+        /**
+         *
+         * One step of the command shell on every pass (one byte, one command or one
+         * field of the response: bounded, never waits on the USART)
+         *
+         * */
+        Shell_MainFunction();
     }
 
     return 0;
@@ -122,14 +216,8 @@ int main() {
 
 /**
  * @brief
- * Interrupt service routine of the WDG timer
- * Increments the number of resets every time the WDG reset the system
- * then we display the number of resets on the LCD
+ * The interrupt service routine of the WDG timer (early warning before the reset)
+ * lives in CrashDump.c: it captures the post-mortem of the reset into .noinit and
+ * pulses MCU_reset_LED while doing so.
  *
  * */
-ISR(WDT_vect){
-	GPIO_Write(MCU_reset_LED, HIGH);
-	resets++;
-	GPIO_Write(MCU_reset_LED, LOW);
-
-}
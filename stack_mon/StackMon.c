@@ -0,0 +1,122 @@
+/*
+ * StackMon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "StackMon.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+#if defined(__AVR__)
+// First free SRAM byte after .data/.bss/.noinit (linker script), the stack grows down to it
+extern uint8 __heap_start;
+#define STACKMON_RAM_START	(&__heap_start)
+#define STACKMON_RAM_SIZE	((uint16)(RAMEND + 1 - (uint16)&__heap_start))
+#else
+// Host simulator: a painted stand-in of the free SRAM
+#include "sim.h"
+#define STACKMON_RAM_START	(&sim_stack_area[0])
+#define STACKMON_RAM_SIZE	((uint16)SIM_STACK_AREA_SIZE)
+#endif
+
+static const uint8 *StackMon_Cursor;		// Next byte to check in the current pass
+static uint16 StackMon_FreeBytes;			// Lowest untouched painted bytes ever seen
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+
+/**
+ * @brief Paints the SRAM between __heap_start and RAMEND with STACKMON_PAINT.
+ *
+ * Runs from .init1, before the C runtime sets up anything, so the stack is still empty and
+ * the loop must not use it. .noinit (crash dump) lies below __heap_start and is kept.
+ */
+#if defined(__AVR__)
+void StackMon_Paint(void) __attribute__((naked, used, section(".init1")));
+void StackMon_Paint(void) {
+	__asm__ __volatile__ (
+		"    ldi r30, lo8(__heap_start)  \n\t"
+		"    ldi r31, hi8(__heap_start)  \n\t"
+		"    ldi r24, %0                 \n\t"
+		"    ldi r25, hi8(%1)            \n\t"
+		"    rjmp 2f                     \n\t"
+		"1:  st Z+, r24                  \n\t"
+		"2:  cpi r30, lo8(%1)            \n\t"
+		"    cpc r31, r25                \n\t"
+		"    brlo 1b                     \n\t"
+		"    breq 1b                     \n\t"
+		:: "M" (STACKMON_PAINT), "i" (RAMEND));
+}
+#else
+void StackMon_Paint(void) {
+	uint16 i;
+
+	for (i = 0; i < STACKMON_RAM_SIZE; i++) {
+		STACKMON_RAM_START[i] = STACKMON_PAINT;
+	}
+}
+#endif
+
+
+/**
+ * @brief Initializes the high-water-mark scan.
+ *
+ * @return None
+ */
+void StackMon_Init(void) {
+	StackMon_Cursor = STACKMON_RAM_START;
+	StackMon_FreeBytes = STACKMON_RAM_SIZE;
+}
+
+
+/**
+ * @brief Incremental high-water-mark scan, called from WDGM_MainFunction.
+ *
+ * A pass walks up from __heap_start while the paint is intact; the first overwritten byte
+ * is the deepest point the stack ever reached. Only the bytes below the known mark can
+ * change, so a pass stops there. At most STACKMON_SCAN_BYTES_PER_CALL bytes are checked
+ * per call, the cost stays constant whatever the SRAM size.
+ *
+ * A margin below STACKMON_MARGIN_MIN_BYTES is reported as a failure of WDGM_ENTITY_STACKMON.
+ *
+ * @return None
+ */
+void StackMon_MainFunction(void) {
+	const uint8 *mark = STACKMON_RAM_START + StackMon_FreeBytes;
+	uint8 count = STACKMON_SCAN_BYTES_PER_CALL;
+
+	while (count--) {
+		WCET_LOOP_BOUND(STACKMON_SCAN_BYTES_PER_CALL);
+		if (StackMon_Cursor >= mark || *StackMon_Cursor != STACKMON_PAINT) {
+			StackMon_FreeBytes = (uint16)(StackMon_Cursor - STACKMON_RAM_START);
+			StackMon_Cursor = STACKMON_RAM_START;	// Start a new pass
+			break;
+		}
+		StackMon_Cursor++;
+	}
+
+	if (StackMon_FreeBytes < STACKMON_MARGIN_MIN_BYTES) {
+		WDGM_EntityFailureIndication(WDGM_ENTITY_STACKMON);
+	}
+}
+
+
+/**
+ * @brief Smallest number of free bytes between the data and the stack seen so far.
+ */
+uint16 StackMon_GetFreeBytes(void) {
+	return StackMon_FreeBytes;
+}
+
+
+/**
+ * @brief Peak stack usage in bytes (for stack sizing).
+ */
+uint16 StackMon_GetPeakUsage(void) {
+	return STACKMON_RAM_SIZE - StackMon_FreeBytes;
+}
@@ -0,0 +1,43 @@
+/*
+ * StackMon.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef STACKMON_H_
+#define STACKMON_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include "Std_types.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define STACKMON_PAINT					0xC5	/* Pattern written over the free SRAM at startup */
+#define STACKMON_SCAN_BYTES_PER_CALL	16		/* Bytes checked per WDGM_MainFunction call       */
+#define STACKMON_MARGIN_MIN_BYTES		96		/* Free bytes below which the entity is NOK       */
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void StackMon_Init(void);
+void StackMon_MainFunction(void);
+uint16 StackMon_GetFreeBytes(void);
+uint16 StackMon_GetPeakUsage(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* STACKMON_H_ */
@@ -0,0 +1,175 @@
+/*
+ * Telemetry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "Telemetry.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static uint8 Telemetry_TxBuffer[TELEMETRY_TX_SIZE];
+static volatile uint8 Telemetry_TxHead;		// Written by the super loop only
+static volatile uint8 Telemetry_TxTail;		// Written by the USART_UDRE ISR only
+
+static uint8 Telemetry_NextEntity;			// Round robin over the WDGM entities with statistics
+static uint16 Telemetry_Dropped;			// Frames not queued, buffer full
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Initializes the USART0 transmitter for the telemetry frames.
+ *
+ * 9600 baud 8N1 in double speed mode like RemoteMon; called after RemoteMon_Init so the
+ * receiver setting is kept. The data register empty interrupt drains the frames.
+ *
+ * @return None
+ */
+void Telemetry_Init(void) {
+	Telemetry_TxHead = 0;
+	Telemetry_TxTail = 0;
+	Telemetry_NextEntity = 0;
+	Telemetry_Dropped = 0;
+#if (TELEMETRY_ENABLED == 1)
+	UBRR0 = TELEMETRY_UBRR;
+	UCSR0A = (1 << U2X0);
+	UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+	UCSR0B |= (1 << TXEN0);
+#endif
+}
+
+
+/**
+ * @brief CRC-8 of a frame (Type, Length, Payload), also used by the tests.
+ */
+uint8 Telemetry_FrameCrc(uint8 Type, const uint8 *Payload, uint8 Length) {
+	uint8 crc = TELEMETRY_CRC_INIT;
+	uint8 i;
+
+	crc = _crc8_ccitt_update(crc, Type);
+	crc = _crc8_ccitt_update(crc, Length);
+	for (i = 0; i < Length; i++) {
+		WCET_LOOP_BOUND(TELEMETRY_STATS_LENGTH);
+		crc = _crc8_ccitt_update(crc, Payload[i]);
+	}
+	return crc;
+}
+
+
+/**
+ * @brief Frames dropped because the transmit buffer was full.
+ */
+uint16 Telemetry_GetDroppedFrames(void) {
+	return Telemetry_Dropped;
+}
+
+
+#if (TELEMETRY_ENABLED == 1)
+static uint8 *Telemetry_Put16(uint8 *Data, uint16 Value) {
+	*Data++ = (uint8)Value;
+	*Data++ = (uint8)(Value >> 8);
+	return Data;
+}
+
+
+/**
+ * @brief Queues one frame as a whole or drops it (never blocks the super loop).
+ */
+static void Telemetry_Send(uint8 Type, const uint8 *Payload, uint8 Length) {
+	uint8 head = Telemetry_TxHead;
+	uint8 free = (uint8)(TELEMETRY_TX_SIZE - 1 - (uint8)(head - Telemetry_TxTail));
+	uint8 sreg;
+	uint8 i;
+
+	if (free < Length + TELEMETRY_FRAME_OVERHEAD) {
+		if (Telemetry_Dropped != 0xFFFF) {
+			Telemetry_Dropped++;
+		}
+		return;
+	}
+	Telemetry_TxBuffer[head++ % TELEMETRY_TX_SIZE] = TELEMETRY_SOF;
+	Telemetry_TxBuffer[head++ % TELEMETRY_TX_SIZE] = Type;
+	Telemetry_TxBuffer[head++ % TELEMETRY_TX_SIZE] = Length;
+	for (i = 0; i < Length; i++) {
+		WCET_LOOP_BOUND(TELEMETRY_STATS_LENGTH);
+		Telemetry_TxBuffer[head++ % TELEMETRY_TX_SIZE] = Payload[i];
+	}
+	Telemetry_TxBuffer[head++ % TELEMETRY_TX_SIZE] = Telemetry_FrameCrc(Type, Payload, Length);
+
+	// Publish the frame, then (re)start the transmission
+	CRITSEC_ENTER(CRITSEC_SITE_TELEMETRY_SEND, sreg);
+	Telemetry_TxHead = head;
+	UCSR0B |= (1 << UDRIE0);
+	CRITSEC_EXIT(CRITSEC_SITE_TELEMETRY_SEND, sreg);
+}
+#endif
+
+
+/**
+ * @brief Periodic function of the telemetry (every TELEMETRY_PERIOD_MS).
+ *
+ * Queues the statistics frame of the next WDGM entity that has statistics (the
+ * count-supervised ones, LEDM at least). The frame is built from a WDGM_GetEntityStats
+ * snapshot: a few hundred cycles, no waiting on the line.
+ *
+ * @return None
+ */
+void Telemetry_MainFunction(void) {
+#if (TELEMETRY_ENABLED == 1)
+	WDGM_EntityStatsType stats;
+	uint8 payload[TELEMETRY_STATS_LENGTH];
+	uint8 *p = payload;
+	uint16 mean = 0;
+	uint8 entity;
+	uint8 bin;
+
+	do {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		entity = Telemetry_NextEntity;
+		Telemetry_NextEntity = (Telemetry_NextEntity + 1) % WDGM_ENTITY_COUNT;
+	} while (!WDGM_GetEntityStats((WDGM_EntityIdType)entity, &stats));
+	if (stats.Windows != 0) {
+		mean = (uint16)((stats.CallSum * 16 + stats.Windows / 2) / stats.Windows);
+	}
+	*p++ = entity;
+	p = Telemetry_Put16(p, (uint16)stats.Windows);
+	p = Telemetry_Put16(p, (uint16)(stats.Windows >> 16));
+	*p++ = stats.MinCount;
+	*p++ = stats.MaxCount;
+	p = Telemetry_Put16(p, mean);
+	*p++ = (uint8)stats.MinMarginLow;
+	*p++ = (uint8)stats.MinMarginHigh;
+	p = Telemetry_Put16(p, stats.NearMisses);
+	p = Telemetry_Put16(p, stats.Violations);
+	for (bin = 0; bin < WDGM_STATS_BINS; bin++) {
+		WCET_LOOP_BOUND(WDGM_STATS_BINS);
+		p = Telemetry_Put16(p, stats.Histogram[bin]);
+	}
+	Telemetry_Send(TELEMETRY_TYPE_ENTITY_STATS, payload, TELEMETRY_STATS_LENGTH);
+#endif
+}
+
+
+/**
+ * @brief USART0 data register empty interrupt service routine.
+ *
+ * Sends the next queued byte, the interrupt is switched off when the buffer is empty and
+ * on again by the next frame.
+ *
+ * @return None
+ */
+ISR(USART_UDRE_vect) {
+	uint8 tail = Telemetry_TxTail;
+
+	if (tail == Telemetry_TxHead) {
+		UCSR0B &= ~(1 << UDRIE0);
+		return;
+	}
+	UDR0 = Telemetry_TxBuffer[tail % TELEMETRY_TX_SIZE];
+	Telemetry_TxTail = tail + 1;
+}
@@ -0,0 +1,75 @@
+/*
+ * Telemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/crc16.h>
+#include "Std_types.h"
+#include "WDGDRV.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> the supervision statistics of WDGM are sent on TXD (PD1). PD1 is then the USART0
+ * transmitter (same line settings as RemoteMon, which keeps the receiver).
+ */
+#ifndef TELEMETRY_ENABLED
+#define TELEMETRY_ENABLED		0
+#endif
+
+// 9600 baud 8N1, double speed (U2X0), see REMOTEMON_UBRR
+#define TELEMETRY_BAUD			9600UL
+#define TELEMETRY_UBRR			((F_CPU + 4UL * TELEMETRY_BAUD) / (8UL * TELEMETRY_BAUD) - 1)
+
+// One frame (one entity, round robin) per period: every entity each 6 * 250ms
+#define TELEMETRY_PERIOD_MS		250
+
+// Transmit ring buffer, power of two
+#define TELEMETRY_TX_SIZE		64
+
+/**
+ * Frame: [SOF][Type][Length][Payload][CRC8], CRC-8 (poly 0x07, init 0x00) over Type,
+ * Length and Payload. Multi-byte fields are little endian.
+ *
+ * Entity stats payload (TELEMETRY_TYPE_ENTITY_STATS), see WDGM_EntityStatsType:
+ *   [Entity][Windows u32][MinCount][MaxCount][MeanX16 u16][MinMarginLow s8]
+ *   [MinMarginHigh s8][NearMisses u16][Violations u16][Histogram u16 x WDGM_STATS_BINS]
+ * MeanX16 is the mean call count per window in 1/16 (rounded).
+ */
+#define TELEMETRY_SOF			0x5A
+#define TELEMETRY_CRC_INIT		0x00
+#define TELEMETRY_TYPE_ENTITY_STATS	0x01
+#define TELEMETRY_STATS_LENGTH	(15 + 2 * WDGM_STATS_BINS)
+#define TELEMETRY_FRAME_OVERHEAD	4
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void Telemetry_Init(void);
+void Telemetry_MainFunction(void);
+uint16 Telemetry_GetDroppedFrames(void);
+uint8 Telemetry_FrameCrc(uint8 Type, const uint8 *Payload, uint8 Length);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,172 @@
+/*
+ * test_crit_sec.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Critical sections on the host simulator (built with CRITSEC_INSTRUMENTED=1):
+ *   - healthy run: HAL_GetTick and the WDGM counters are measured at every call, none of
+ *     the sections is longer than one TCNT2 tick, the histograms add up to the counts
+ *   - Exti_Init called with the interrupts disabled leaves them disabled and is not
+ *     measured (nested), called with them enabled it is measured and they stay enabled
+ *   - a 700us section from LEDM_Manage (--wrap) is measured 672..704us in the 16..31 ticks
+ *     bin and no 1ms tick is lost: millis matches the healthy run
+ */
+
+#include <stdio.h>
+#include <util/delay.h>
+#include "sim.h"
+#include "CritSec.h"
+#include "Exti.h"
+#include "LEDM.h"
+#include "timer.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US					2000000ULL
+#define ACTION_AT_US			500000ULL
+#define LONG_SECTION_US			700
+#define TICK_US					32
+// A site that is never entered in this build (no fault injection)
+#define LONG_SITE				CRITSEC_SITE_FAULTINJ_ARM
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	SCENARIO_HEALTHY = 0,
+	SCENARIO_NESTED,		/* Exti_Init with the interrupts disabled, then enabled */
+	SCENARIO_LONG			/* One LONG_SECTION_US section                          */
+} ScenarioType;
+
+/**
+ * What the firmware reported, written inside the boot.
+ */
+typedef struct {
+	uint8_t Done;
+	uint8_t OffAfterNested;		// I-bit still clear after the nested Exti_Init
+	uint8_t OnAfterOuter;		// I-bit still set after the outermost Exti_Init
+	uint32_t Millis;
+	CritSec_StatsType Stats[CRITSEC_SITE_COUNT];
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static ScenarioType Scenario;
+static ObservedType *Observed;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_LEDM_Manage(void);
+
+void __wrap_LEDM_Manage(void) {
+	uint8_t sreg;
+
+	__real_LEDM_Manage();
+	if (Observed->Done || sim_now_us() < ACTION_AT_US) {
+		return;
+	}
+	Observed->Done = 1;
+	if (Scenario == SCENARIO_NESTED) {
+		sreg = SREG;
+		cli();
+		Exti_Init(EXTI_INT0, EXTI_RISING_EDGE);
+		Observed->OffAfterNested = !(SREG & (1 << SREG_I));
+		SREG = sreg;
+		Exti_Init(EXTI_INT0, EXTI_RISING_EDGE);
+		Observed->OnAfterOuter = (SREG & (1 << SREG_I)) != 0;
+	} else if (Scenario == SCENARIO_LONG) {
+		CRITSEC_ENTER(LONG_SITE, sreg);
+		_delay_us(LONG_SECTION_US);
+		CRITSEC_EXIT(LONG_SITE, sreg);
+	}
+}
+
+
+static void Snapshot_Hook(void) {
+	uint8_t site;
+
+	for (site = 0; site < CRITSEC_SITE_COUNT; site++) {
+		CritSec_GetSiteStats((CritSec_SiteType)site, &Observed->Stats[site]);
+	}
+	Observed->Millis = HAL_GetTick();
+}
+
+
+static void Scenario_Run(ScenarioType Which) {
+	Scenario = Which;
+	SIM_CHECK(sim_run(Snapshot_Hook, 100000UL, SIM_RESET_POWER_ON, RUN_US, NULL) == SIM_EXIT_STOPPED);
+}
+
+
+/**
+ * @brief Every histogram adds up to the count of its site (HAL_GetTick saturates: the
+ * main loop polls it continuously, the bins then add up to at least the count).
+ */
+static void Histograms_Check(void) {
+	uint8_t site, bin;
+
+	for (site = 0; site < CRITSEC_SITE_COUNT; site++) {
+		uint32_t sum = 0;
+		for (bin = 0; bin < CRITSEC_BINS; bin++) {
+			sum += Observed->Stats[site].Histogram[bin];
+		}
+		if (Observed->Stats[site].Count == 0xFFFF) {
+			SIM_CHECK(sum >= 0xFFFF);
+		} else {
+			SIM_CHECK(sum == Observed->Stats[site].Count);
+		}
+	}
+}
+
+
+int main(void) {
+	const CritSec_StatsType *stats;
+	uint32_t healthyMillis;
+	uint8_t site;
+
+	Observed = (ObservedType *)sim_shared();
+
+	// Healthy: short sections only
+	Scenario_Run(SCENARIO_HEALTHY);
+	for (site = 0; site < CRITSEC_SITE_COUNT; site++) {
+		stats = &Observed->Stats[site];
+		if (stats->Count) {
+			printf("healthy  site %2u: %5u sections, max %3u us\n", site, stats->Count, stats->MaxUs);
+		}
+		SIM_CHECK(stats->MaxUs <= TICK_US);
+	}
+	Histograms_Check();
+	SIM_CHECK(Observed->Stats[CRITSEC_SITE_HAL_GETTICK].Count >= RUN_US / 1000UL / LEDM_PERIOD_MS);
+	SIM_CHECK(Observed->Stats[CRITSEC_SITE_WDGM_COUNTERS].Count >= RUN_US / 1000UL / WDGM_PERIOD_MS);
+	SIM_CHECK(Observed->Stats[CRITSEC_SITE_EXTI_INIT].Count == 0);
+	healthyMillis = Observed->Millis;
+
+	// Nested: SREG restored, not enabled
+	Scenario_Run(SCENARIO_NESTED);
+	printf("nested   disabled after nested %u, enabled after outermost %u, measured %u\n",
+		   Observed->OffAfterNested, Observed->OnAfterOuter, Observed->Stats[CRITSEC_SITE_EXTI_INIT].Count);
+	SIM_CHECK(Observed->Done);
+	SIM_CHECK(Observed->OffAfterNested);
+	SIM_CHECK(Observed->OnAfterOuter);
+	SIM_CHECK(Observed->Stats[CRITSEC_SITE_EXTI_INIT].Count == 1);
+
+	// Long section: measured at TCNT2 resolution, the pending tick is served afterwards
+	Scenario_Run(SCENARIO_LONG);
+	stats = &Observed->Stats[LONG_SITE];
+	printf("long     %u section, max %u us, millis %u (healthy %u)\n", stats->Count, stats->MaxUs,
+		   (unsigned)Observed->Millis, (unsigned)healthyMillis);
+	Histograms_Check();
+	SIM_CHECK(stats->Count == 1);
+	SIM_CHECK(stats->MaxUs >= LONG_SECTION_US - TICK_US && stats->MaxUs <= LONG_SECTION_US + TICK_US);
+	SIM_CHECK(stats->Histogram[5] == 1);
+	SIM_CHECK(Observed->Millis == healthyMillis);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
@@ -0,0 +1,292 @@
+/*
+ * test_remote_mon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Remote node supervision on the host simulator: simulated nodes send heartbeat frames on
+ * a virtual bus (the USART0 RX line, frames serialized at 9600 baud) while the unmodified
+ * firmware runs. Every scenario is one power-on boot; the hook records what the firmware
+ * reports into shared memory and the checks run after the boot.
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "RemoteMon.h"
+#include "WDGM.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define NODE_PERIOD_US			25000UL
+#define FAULT_AT_US				500000UL
+#define RUN_US					1500000ULL
+#define HOOK_PERIOD_US			1000UL
+
+// Window closed every WDGM_PERIOD_MS (checked from the 20ms WDGM task), plus one window
+#define DETECTION_MAX_US		((2UL * WDGM_PERIOD_MS + 40UL) * 1000UL)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	FAULT_NONE = 0,
+	FAULT_SILENT,			/* Node stops sending                               */
+	FAULT_DUPLICATE,		/* One frame sent twice                             */
+	FAULT_OUT_OF_ORDER,		/* Two frames swapped                               */
+	FAULT_RESTART,			/* Node restarts, its sequence begins at 0 again    */
+	FAULT_GAP,				/* One sequence number skipped                      */
+	FAULT_CRC,				/* One frame with a corrupted CRC                   */
+	FAULT_STATUS,			/* Node reports a failure in its status byte        */
+	FAULT_TRUNCATED,		/* A stray partial frame before a regular frame     */
+	FAULT_NOISE,			/* Line noise (no SOF) between the frames           */
+	FAULT_UNKNOWN_NODE		/* Frames of a node id that is not supervised       */
+} FaultType;
+
+typedef struct {
+	uint8_t Id;
+	uint32_t OffsetUs;
+	FaultType Fault;
+	uint64_t NextUs;
+	uint8_t Seq;
+	uint8_t FaultDone;
+} NodeType;
+
+/**
+ * What the firmware reported, written by the hook inside the boot.
+ */
+typedef struct {
+	RemoteMon_NodeStatsType Node[REMOTEMON_NODE_COUNT];
+	RemoteMon_BusStatsType Bus;
+	uint64_t FirstNokUs[REMOTEMON_NODE_COUNT];	// 0: never reported NOK
+	uint64_t LastUs;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static NodeType Nodes[REMOTEMON_NODE_COUNT];
+static ObservedType *Observed;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+static void Bus_SendFrame(uint8_t Id, uint8_t Seq, uint8_t Status, uint8_t Corrupt) {
+	uint8_t frame[5];
+
+	frame[0] = REMOTEMON_SOF;
+	frame[1] = Id;
+	frame[2] = Seq;
+	frame[3] = Status;
+	frame[4] = RemoteMon_FrameCrc(Id, Seq, Status);
+	if (Corrupt) {
+		frame[4] ^= 0x5A;
+	}
+	sim_uart_rx(frame, sizeof(frame));
+}
+
+
+/**
+ * @brief One heartbeat of a simulated node, with its fault injected once at FAULT_AT_US.
+ */
+static void Node_Send(NodeType *Node, uint64_t Now) {
+	uint8_t inject = (Node->Fault != FAULT_NONE && !Node->FaultDone && Now >= FAULT_AT_US);
+
+	if (!inject) {
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 0);
+		return;
+	}
+	switch (Node->Fault) {
+	case FAULT_SILENT:
+		return;		// Never done, the node stays silent
+	case FAULT_DUPLICATE:
+		Bus_SendFrame(Node->Id, Node->Seq, REMOTEMON_STATUS_OK, 0);
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 0);
+		break;
+	case FAULT_OUT_OF_ORDER:
+		Bus_SendFrame(Node->Id, Node->Seq + 1, REMOTEMON_STATUS_OK, 0);
+		Bus_SendFrame(Node->Id, Node->Seq, REMOTEMON_STATUS_OK, 0);
+		Node->Seq += 2;
+		break;
+	case FAULT_RESTART:
+		Node->Seq = 0;
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 0);
+		break;
+	case FAULT_GAP:
+		Node->Seq++;
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 0);
+		break;
+	case FAULT_CRC:
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 1);
+		break;
+	case FAULT_STATUS:
+		Bus_SendFrame(Node->Id, Node->Seq++, 0x01, 0);
+		break;
+	case FAULT_TRUNCATED: {
+		const uint8_t fragment[2] = { REMOTEMON_SOF, Node->Id };
+		sim_uart_rx(fragment, sizeof(fragment));
+		Node->NextUs += 10000UL;	// Line idle for 10ms, then the regular frame
+		Node->FaultDone = 1;
+		return;
+	}
+	case FAULT_NOISE: {
+		static const uint8_t noise[3] = { 0x00, 0xFF, 0x5A };
+		sim_uart_rx(noise, sizeof(noise));
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 0);
+		return;		// Noise before every frame from now on
+	}
+	case FAULT_UNKNOWN_NODE:
+		Bus_SendFrame(REMOTEMON_NODE_COUNT + 5, 0, REMOTEMON_STATUS_OK, 0);
+		Bus_SendFrame(Node->Id, Node->Seq++, REMOTEMON_STATUS_OK, 0);
+		return;
+	default:
+		break;
+	}
+	Node->FaultDone = 1;
+}
+
+
+/**
+ * @brief Virtual bus and observation, every HOOK_PERIOD_US of simulated time.
+ */
+static void Bus_Hook(void) {
+	uint64_t now = sim_now_us();
+	uint8_t i;
+
+	for (i = 0; i < REMOTEMON_NODE_COUNT; i++) {
+		if (now >= Nodes[i].NextUs) {
+			Nodes[i].NextUs += NODE_PERIOD_US;
+			Node_Send(&Nodes[i], now);
+		}
+		RemoteMon_GetNodeStats(i + 1, &Observed->Node[i]);
+		if (!Observed->FirstNokUs[i] && WDGM_GetEntityStatus(REMOTEMON_ENTITY(i + 1)) == NOK) {
+			Observed->FirstNokUs[i] = now;
+		}
+	}
+	RemoteMon_GetBusStats(&Observed->Bus);
+	Observed->LastUs = now;
+}
+
+
+static void Scenario_Hook(void) {
+	// First hook call inside the boot: install the periodic bus hook
+	sim_set_hook(Bus_Hook, HOOK_PERIOD_US);
+	Bus_Hook();
+}
+
+
+/**
+ * @brief Boots the firmware with node 1 affected by Fault and node 2 healthy.
+ */
+static SimExitType Scenario_Run(FaultType Fault) {
+	uint8_t i;
+
+	for (i = 0; i < REMOTEMON_NODE_COUNT; i++) {
+		Nodes[i].Id = i + 1;
+		Nodes[i].OffsetUs = 20000UL + i * 7000UL;
+		Nodes[i].Fault = (i == 0) ? Fault : FAULT_NONE;
+		Nodes[i].NextUs = Nodes[i].OffsetUs;
+		Nodes[i].Seq = (uint8_t)(0xF0 + i * 3);		// Wraps during the run
+		Nodes[i].FaultDone = 0;
+	}
+	return sim_run(Scenario_Hook, 1000, SIM_RESET_POWER_ON, RUN_US, NULL);
+}
+
+
+static void Check_Healthy(const char *Name, SimExitType Exit) {
+	uint8_t i;
+
+	printf("%-14s exit %d, node1 frames %u, node2 frames %u\n", Name, Exit,
+		   Observed->Node[0].Frames, Observed->Node[1].Frames);
+	SIM_CHECK(Exit == SIM_EXIT_STOPPED);
+	for (i = 0; i < REMOTEMON_NODE_COUNT; i++) {
+		SIM_CHECK(Observed->FirstNokUs[i] == 0);
+		SIM_CHECK(Observed->Node[i].Frames >= (RUN_US - 60000UL) / NODE_PERIOD_US - 2);
+		SIM_CHECK(Observed->Node[i].Duplicates == 0);
+		SIM_CHECK(Observed->Node[i].OutOfOrder == 0);
+		SIM_CHECK(Observed->Node[i].Gaps == 0);
+		SIM_CHECK(Observed->Node[i].StatusErrors == 0);
+		SIM_CHECK(Observed->Node[i].Resyncs == 0);
+	}
+	SIM_CHECK(Observed->Bus.CrcErrors == 0);
+	SIM_CHECK(Observed->Bus.LineErrors == 0);
+}
+
+
+/**
+ * @brief Node 1 must be reported NOK within DETECTION_MAX_US, node 2 never, and the
+ *        supervision failure must end in a watchdog reset.
+ */
+static void Check_Detected(const char *Name, SimExitType Exit) {
+	uint64_t latency = Observed->FirstNokUs[0] ? Observed->FirstNokUs[0] - FAULT_AT_US : 0;
+
+	printf("%-14s exit %d, node1 NOK after %llu us, reset at %llu us\n", Name, Exit,
+		   (unsigned long long)latency, (unsigned long long)Observed->LastUs);
+	SIM_CHECK(Exit == SIM_EXIT_WATCHDOG_RESET);
+	SIM_CHECK(Observed->FirstNokUs[0] > FAULT_AT_US);
+	SIM_CHECK(latency <= DETECTION_MAX_US);
+	SIM_CHECK(Observed->FirstNokUs[1] == 0);
+}
+
+
+int main(void) {
+	SimExitType exit;
+
+	Observed = (ObservedType *)sim_shared();
+
+	exit = Scenario_Run(FAULT_NONE);
+	Check_Healthy("healthy", exit);
+
+	exit = Scenario_Run(FAULT_NOISE);
+	Check_Healthy("noise", exit);
+
+	exit = Scenario_Run(FAULT_TRUNCATED);
+	Check_Healthy("truncated", exit);
+	SIM_CHECK(Observed->Bus.Truncated == 1);
+
+	exit = Scenario_Run(FAULT_UNKNOWN_NODE);
+	Check_Healthy("unknown node", exit);
+	SIM_CHECK(Observed->Bus.UnknownNodes >= 1);
+
+	exit = Scenario_Run(FAULT_SILENT);
+	Check_Detected("silent", exit);
+
+	exit = Scenario_Run(FAULT_DUPLICATE);
+	Check_Detected("duplicate", exit);
+	SIM_CHECK(Observed->Node[0].Duplicates == 1);
+
+	exit = Scenario_Run(FAULT_OUT_OF_ORDER);
+	Check_Detected("out of order", exit);
+	SIM_CHECK(Observed->Node[0].OutOfOrder == 1);
+	SIM_CHECK(Observed->Node[0].Resyncs == 0);
+
+	// One failure, then the node is followed again until the reset
+	exit = Scenario_Run(FAULT_RESTART);
+	Check_Detected("restart", exit);
+	printf("%-14s out of order %u, resyncs %u, last seq %u\n", "", Observed->Node[0].OutOfOrder,
+		   Observed->Node[0].Resyncs, Observed->Node[0].LastSeq);
+	SIM_CHECK(Observed->Node[0].OutOfOrder == 1);
+	SIM_CHECK(Observed->Node[0].Resyncs == 1);
+	SIM_CHECK(Observed->Node[0].Duplicates == 0 && Observed->Node[0].Gaps == 0);
+	SIM_CHECK(Observed->Node[0].Frames > REMOTEMON_RESYNC_FRAMES &&
+			  Observed->Node[0].LastSeq >= REMOTEMON_RESYNC_FRAMES);
+
+	exit = Scenario_Run(FAULT_GAP);
+	Check_Detected("gap", exit);
+	SIM_CHECK(Observed->Node[0].Gaps == 1);
+
+	exit = Scenario_Run(FAULT_CRC);
+	Check_Detected("crc", exit);
+	SIM_CHECK(Observed->Bus.CrcErrors == 1);
+	SIM_CHECK(Observed->Node[0].Gaps == 1);		// The lost frame shows as a gap
+
+	exit = Scenario_Run(FAULT_STATUS);
+	Check_Detected("node status", exit);
+	SIM_CHECK(Observed->Node[0].StatusErrors == 1);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
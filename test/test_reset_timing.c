@@ -0,0 +1,138 @@
+/*
+ * test_reset_timing.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Reset timings documented in src/main.c and LEDM.c, measured on the host simulator from
+ * power-on:
+ *   WDGM_MainFunction never called       -> watchdog expires after ~64ms
+ *   WDGM_AlivenessIndication never called -> watchdog expires after ~117ms
+ *   LEDM task every 5ms instead of 10ms   -> watchdog expires after ~117ms
+ *
+ * The watchdog runs in interrupt-then-reset mode: at expiry the WDT interrupt captures the
+ * crash dump and applies the safe state, the system reset follows one timeout later.
+ * Both instants are checked.
+ *
+ * The calls are removed with the linker (--wrap), the LEDM period is a build option: the
+ * same file is built a second time with -DLEDM_PERIOD_MS=5 (test_reset_timing_led5), and a
+ * third time with the fast-boot init path (test_reset_timing_fastboot, BOOT_FAST_MODE=1).
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "WDGM.h"
+#include "LEDM.h"
+#include "WDGDRV.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US						2000000ULL
+#define WDT_VECTOR					6
+
+// Documented expiry times and accepted band (us from power-on). Without aliveness the
+// expiry is one WDT timeout after the first Timer1 refresh (52.2ms after timers_init):
+// ~117ms in both init paths (BOOT_FAST_MODE), the original one ~0.1ms later.
+#define NO_MAIN_FUNCTION_US			64000UL
+#define NO_ALIVENESS_US				117000UL
+#define TOLERANCE_US				3000UL
+
+// The reset follows the expiry after one more WDGDRV_DEFAULT_TIMEOUT (64ms)
+#define WDT_TIMEOUT_US				64000UL
+#define RESET_TOLERANCE_US			1000UL
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+typedef enum {
+	SCENARIO_NONE = 0,
+	SCENARIO_NO_MAIN_FUNCTION,
+	SCENARIO_NO_ALIVENESS
+} ScenarioType;
+
+typedef struct {
+	uint64_t ExpiryUs;		// First WDT interrupt, 0: none
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static ScenarioType Scenario;
+static ObservedType *Observed;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_WDGM_MainFunction(void);
+void __real_WDGM_AlivenessIndication(void);
+
+void __wrap_WDGM_MainFunction(void) {
+	if (Scenario != SCENARIO_NO_MAIN_FUNCTION) {
+		__real_WDGM_MainFunction();
+	}
+}
+
+void __wrap_WDGM_AlivenessIndication(void) {
+	if (Scenario != SCENARIO_NO_ALIVENESS) {
+		__real_WDGM_AlivenessIndication();
+	}
+}
+
+
+static void Vector_Hook(uint8_t Vector) {
+	if (Vector == WDT_VECTOR && !Observed->ExpiryUs) {
+		Observed->ExpiryUs = sim_now_us();
+	}
+}
+
+
+static SimExitType Scenario_Run(ScenarioType Which, SimBootResultType *Result) {
+	Scenario = Which;
+	sim_set_vector_hook(Vector_Hook);
+	return sim_run(NULL, 0, SIM_RESET_POWER_ON, RUN_US, Result);
+}
+
+
+/**
+ * @brief Expiry inside [ExpectedUs +- TOLERANCE_US], reset one timeout later.
+ */
+static void Check_Reset(const char *Name, SimExitType Exit, const SimBootResultType *Result,
+						uint32_t ExpectedUs) {
+	printf("%-24s expiry %llu us (documented %lu us), reset %llu us\n", Name,
+		   (unsigned long long)Observed->ExpiryUs, (unsigned long)ExpectedUs,
+		   (unsigned long long)Result->EndUs);
+	SIM_CHECK(Exit == SIM_EXIT_WATCHDOG_RESET);
+	SIM_CHECK(Observed->ExpiryUs >= ExpectedUs - TOLERANCE_US);
+	SIM_CHECK(Observed->ExpiryUs <= ExpectedUs + TOLERANCE_US);
+	SIM_CHECK(Result->EndUs >= Observed->ExpiryUs + WDT_TIMEOUT_US - RESET_TOLERANCE_US);
+	SIM_CHECK(Result->EndUs <= Observed->ExpiryUs + WDT_TIMEOUT_US + RESET_TOLERANCE_US);
+}
+
+
+int main(void) {
+	SimBootResultType result;
+	SimExitType exit;
+
+	Observed = (ObservedType *)sim_shared();
+
+#if (LEDM_PERIOD_MS == 10)
+	exit = Scenario_Run(SCENARIO_NONE, &result);
+	printf("%-24s exit %d after %llu us\n", "supervision OK", exit, (unsigned long long)result.EndUs);
+	SIM_CHECK(exit == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->ExpiryUs == 0);
+
+	exit = Scenario_Run(SCENARIO_NO_MAIN_FUNCTION, &result);
+	Check_Reset("no WDGM_MainFunction", exit, &result, NO_MAIN_FUNCTION_US);
+
+	exit = Scenario_Run(SCENARIO_NO_ALIVENESS, &result);
+	Check_Reset("no aliveness indication", exit, &result, NO_ALIVENESS_US);
+#else
+	exit = Scenario_Run(SCENARIO_NONE, &result);
+	Check_Reset("LEDM period 5ms", exit, &result, NO_ALIVENESS_US);
+#endif
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * test_run_cfg.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Runtime configuration (RunCfg) on the host simulator, the EEPROM is kept across the boots.
+ * The changes are made from LEDM_Manage (--wrap) once per boot:
+ *   - erased EEPROM: flash defaults; LEDM period 20ms with a 4..6 window committed into
+ *     copy A (generation 1) in the background, the running boot keeps its configuration
+ *   - next boot: copy A loaded, 5 LEDM calls per window, supervision OK; a WDT timeout of
+ *     WDTO_120MS committed into copy B (generation 2) and applied at the next boot
+ *   - a boot ending while copy A is written: copy B still loaded
+ *   - copy B corrupted as well: flash defaults
+ *   - an inconsistent set (LEDM period alone) and a value out of range are rejected, as is
+ *     a 10..10 window without room for the +/-1 call jitter of LEDM
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <util/crc16.h>
+#include "sim.h"
+#include "RunCfg.h"
+#include "WDGM.h"
+#include "WDGDRV.h"
+#include "LEDM.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US					1500000ULL
+#define ACTION_AT_US			200000ULL
+#define HOOK_PERIOD_US			1000UL
+#define STOP_AFTER_US			10000ULL		// Boot cut this long into the write
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	SCENARIO_NONE = 0,
+	SCENARIO_LEDM_20MS,		/* LEDM period 20ms, window 4..6, commit             */
+	SCENARIO_WDT_120MS,		/* WDT timeout WDTO_120MS, commit                    */
+	SCENARIO_POWER_LOSS,	/* LEDM window 4..7, commit, boot ends in the write  */
+	SCENARIO_INCONSISTENT,	/* LEDM period 20ms alone, WDTO_30MS                 */
+	SCENARIO_NO_JITTER		/* LEDM window 10..10 for 10 calls, commit           */
+} ScenarioType;
+
+/**
+ * What the firmware reported, written inside the boot.
+ */
+typedef struct {
+	uint8_t Done;
+	uint8_t SetOk;				// Every RunCfg_Set accepted
+	uint8_t CommitOk;
+	uint8_t NokSeen;
+	uint64_t WritingUs;			// First time in RUNCFG_STATE_WRITING, 0: never
+	RunCfg_SourceType LoadedSource;
+	uint16_t LoadedGeneration;
+	RunCfg_ParamsType Active;
+	RunCfg_StateType State;
+	uint8_t WdtTimeout;
+	WDGM_EntityConfigType Ledm;
+	WDGM_EntityStatsType LedmStats;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static ScenarioType Scenario;
+static ObservedType *Observed;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_LEDM_Manage(void);
+
+void __wrap_LEDM_Manage(void) {
+	bool ok = true;
+
+	__real_LEDM_Manage();
+	if (Observed->Done || sim_now_us() < ACTION_AT_US) {
+		return;
+	}
+	Observed->Done = 1;
+	Observed->LoadedSource = RunCfg_GetSource();
+	Observed->LoadedGeneration = RunCfg_GetGeneration();
+	switch (Scenario) {
+	case SCENARIO_LEDM_20MS:
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_CALLS_MIN, 4);
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_CALLS_MAX, 6);
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_PERIOD_MS, 20);
+		break;
+	case SCENARIO_WDT_120MS:
+		ok &= RunCfg_Set(RUNCFG_PARAM_WDT_TIMEOUT, WDTO_120MS);
+		break;
+	case SCENARIO_POWER_LOSS:
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_CALLS_MAX, 7);
+		break;
+	case SCENARIO_INCONSISTENT:
+		ok &= !RunCfg_Set(RUNCFG_PARAM_WDT_TIMEOUT, WDTO_30MS);
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_PERIOD_MS, 20);
+		break;
+	case SCENARIO_NO_JITTER:
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_CALLS_MIN, 10);
+		ok &= RunCfg_Set(RUNCFG_PARAM_LEDM_CALLS_MAX, 10);
+		break;
+	default:
+		return;
+	}
+	Observed->SetOk = ok;
+	Observed->CommitOk = RunCfg_Commit();
+}
+
+
+static void Observe_Hook(void) {
+	Observed->Active = RunCfg_Active;
+	Observed->State = RunCfg_GetState();
+	Observed->WdtTimeout = WDGDrv_GetTimeout();
+	WDGM_GetEntityConfig(WDGM_ENTITY_LEDM, &Observed->Ledm);
+	WDGM_GetEntityStats(WDGM_ENTITY_LEDM, &Observed->LedmStats);
+	if (WDGM_ProvideSupervisionStatus() == NOK) {
+		Observed->NokSeen = 1;
+	}
+	if (Observed->State == RUNCFG_STATE_WRITING && !Observed->WritingUs) {
+		Observed->WritingUs = sim_now_us();
+	}
+	if (Scenario == SCENARIO_POWER_LOSS && Observed->WritingUs &&
+		sim_now_us() - Observed->WritingUs >= STOP_AFTER_US) {
+		sim_stop();
+	}
+}
+
+
+static SimExitType Scenario_Run(ScenarioType Which) {
+	SimBootResultType result;
+
+	Scenario = Which;
+	sim_run(Observe_Hook, HOOK_PERIOD_US, SIM_RESET_POWER_ON, RUN_US, &result);
+	printf("scenario %d: loaded source %d gen %u, LEDM %ums %u..%u, WDTO %u, commit %u, state %d, "
+		   "calls %u..%u, NOK %u\n", (int)Which, (int)Observed->LoadedSource, Observed->LoadedGeneration,
+		   Observed->Active.LedmPeriodMs, Observed->Ledm.MinCalls, Observed->Ledm.MaxCalls,
+		   Observed->WdtTimeout, Observed->CommitOk, (int)Observed->State, Observed->LedmStats.MinCount,
+		   Observed->LedmStats.MaxCount, Observed->NokSeen);
+	return result.Exit;
+}
+
+
+/**
+ * @brief Copy in the simulated EEPROM, 1 when it is valid.
+ */
+static int Copy_Get(uint16_t Address, RunCfg_BlockType *Block) {
+	uint16_t crc = 0xFFFF;
+	size_t i;
+
+	memcpy(Block, sim_eeprom() + Address, sizeof(*Block));
+	for (i = 0; i < offsetof(RunCfg_BlockType, Crc); i++) {
+		crc = _crc_ccitt_update(crc, ((const uint8_t *)Block)[i]);
+	}
+	return Block->Version == RUNCFG_VERSION && Block->Crc == crc;
+}
+
+
+int main(void) {
+	RunCfg_BlockType block;
+
+	Observed = (ObservedType *)sim_shared();
+	memset(sim_eeprom(), 0xFF, SIM_EEPROM_SIZE);
+
+	// Erased EEPROM: defaults, the commit goes to copy A and applies at the next boot
+	SIM_CHECK(Scenario_Run(SCENARIO_LEDM_20MS) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->LoadedSource == RUNCFG_SOURCE_DEFAULTS && Observed->LoadedGeneration == 0);
+	SIM_CHECK(Observed->SetOk && Observed->CommitOk);
+	SIM_CHECK(Observed->State == RUNCFG_STATE_IDLE && Observed->WritingUs != 0);
+	SIM_CHECK(Observed->Active.LedmPeriodMs == LEDM_PERIOD_MS);
+	SIM_CHECK(Observed->Ledm.MinCalls == LEDM_CALLS_OK_MIN && Observed->Ledm.MaxCalls == LEDM_CALLS_OK_MAX);
+	SIM_CHECK(!Observed->NokSeen);
+	SIM_CHECK(Copy_Get(RUNCFG_EEPROM_ADDR_A, &block) && block.Generation == 1);
+	SIM_CHECK(block.Params.LedmPeriodMs == 20);
+	SIM_CHECK(!Copy_Get(RUNCFG_EEPROM_ADDR_B, &block));
+
+	// Copy A: 5 calls per window against 4..6; WDT timeout committed into copy B
+	SIM_CHECK(Scenario_Run(SCENARIO_WDT_120MS) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->LoadedSource == RUNCFG_SOURCE_COPY_A && Observed->LoadedGeneration == 1);
+	SIM_CHECK(Observed->Active.LedmPeriodMs == 20);
+	SIM_CHECK(Observed->Ledm.MinCalls == 4 && Observed->Ledm.MaxCalls == 6);
+	SIM_CHECK(Observed->LedmStats.Windows > 0 && Observed->LedmStats.Violations == 0);
+	SIM_CHECK(Observed->LedmStats.MinCount >= 4 && Observed->LedmStats.MaxCount <= 6);
+	SIM_CHECK(Observed->WdtTimeout == WDGDRV_DEFAULT_TIMEOUT);
+	SIM_CHECK(!Observed->NokSeen);
+	SIM_CHECK(Observed->CommitOk);
+	SIM_CHECK(Copy_Get(RUNCFG_EEPROM_ADDR_B, &block) && block.Generation == 2);
+
+	// Copy B: both changes applied
+	SIM_CHECK(Scenario_Run(SCENARIO_NONE) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->LoadedSource == RUNCFG_SOURCE_COPY_B && Observed->LoadedGeneration == 2);
+	SIM_CHECK(Observed->WdtTimeout == WDTO_120MS && Observed->Active.LedmPeriodMs == 20);
+	SIM_CHECK(!Observed->NokSeen);
+
+	// Power loss while copy A is written: copy B is loaded at the next boot
+	Scenario_Run(SCENARIO_POWER_LOSS);
+	SIM_CHECK(Observed->CommitOk && Observed->State == RUNCFG_STATE_WRITING);
+	SIM_CHECK(!Copy_Get(RUNCFG_EEPROM_ADDR_A, &block) || block.Generation == 1);
+	SIM_CHECK(Scenario_Run(SCENARIO_NONE) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->LoadedSource == RUNCFG_SOURCE_COPY_B && Observed->LoadedGeneration == 2);
+	SIM_CHECK(Observed->Ledm.MaxCalls == 6);
+
+	// Both copies invalid: flash defaults
+	sim_eeprom()[RUNCFG_EEPROM_ADDR_A + offsetof(RunCfg_BlockType, Params)] ^= 0x01;
+	sim_eeprom()[RUNCFG_EEPROM_ADDR_B + offsetof(RunCfg_BlockType, Params)] ^= 0x01;
+	SIM_CHECK(Scenario_Run(SCENARIO_INCONSISTENT) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->LoadedSource == RUNCFG_SOURCE_DEFAULTS);
+	SIM_CHECK(Observed->Active.LedmPeriodMs == LEDM_PERIOD_MS && Observed->WdtTimeout == WDGDRV_DEFAULT_TIMEOUT);
+	SIM_CHECK(!Observed->NokSeen);
+
+	// 5 calls per window against the 8..12 default window: rejected, nothing written
+	SIM_CHECK(Observed->SetOk && !Observed->CommitOk);
+	SIM_CHECK(Observed->WritingUs == 0);
+
+	// 10 calls per window against 10..10: no room for the jitter, rejected
+	SIM_CHECK(Scenario_Run(SCENARIO_NO_JITTER) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->SetOk && !Observed->CommitOk);
+	SIM_CHECK(Observed->WritingUs == 0);
+	SIM_CHECK(!Observed->NokSeen);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
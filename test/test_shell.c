@@ -0,0 +1,188 @@
+/*
+ * test_shell.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Command shell (SHELL_ENABLED=1) on the host simulator. The commands are typed one by one
+ * on USART0, each one after the prompt of the previous response:
+ *   - every command answers, unknown commands and bad arguments with "err", the statistics
+ *     of a failure-only entity with "none"
+ *   - an inconsistent configuration is rejected by "commit", a consistent one is written
+ *     and loaded at the next boot
+ *   - an overlong line is answered with "err", a backspace edits the line
+ *   - the supervision stays OK and LEDM_Manage inside its 8..12 window all along
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "sim.h"
+#include "Shell.h"
+#include "RunCfg.h"
+#include "WDGM.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US					4000000ULL
+#define HOOK_PERIOD_US			1000UL
+#define OUT_SIZE				4096
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * What the firmware sent and reported, written inside the boot.
+ */
+typedef struct {
+	char Out[OUT_SIZE];
+	uint16_t OutLength;
+	uint8_t Prompts;				// "> " received
+	uint8_t Sent;					// Commands typed
+	uint8_t PrevBytes[2];
+	uint8_t NokSeen;
+	WDGM_EntityStatsType LedmStats;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static const char *const *Commands;
+static ObservedType *Observed;
+
+static const char *const Session[] = {
+	"help\r\n",
+	"wdgm\r\n",
+	"stats 0\r\n",
+	"stats 2\r\n",					// STACKMON: failure indications only, no statistics
+	"prof\r\n",
+	"resets\r\n",
+	"cfg\r\n",
+	"set ledm 20\r\n",
+	"commit\r\n",					// 5 calls per window against 8..12: rejected
+	"set min 4\r\n",
+	"set max 6\r\n",
+	"commit\r\n",
+	"bogus\r\n",
+	"stats 99\r\n",
+	"0123456789012345678901234567890123456789\r\n",
+	"wdgx\bm\r\n",
+	NULL
+};
+
+static const char *const NextBoot[] = {
+	"cfg\r\n",
+	NULL
+};
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+static void Terminal_Receive(uint8_t Data) {
+	if (Observed->OutLength < OUT_SIZE - 1) {
+		Observed->Out[Observed->OutLength++] = (char)Data;
+	}
+	// "> " at the start of a line ("<param> " of the help is not a prompt)
+	if (Data == ' ' && Observed->PrevBytes[1] == '>' && (Observed->PrevBytes[0] == '\n' || Observed->OutLength == 2)) {
+		Observed->Prompts++;
+	}
+	Observed->PrevBytes[0] = Observed->PrevBytes[1];
+	Observed->PrevBytes[1] = Data;
+}
+
+
+/**
+ * @brief Types the next command once the prompt of the previous response is out.
+ */
+static void Terminal_Hook(void) {
+	const char *command = Commands[Observed->Sent];
+
+	WDGM_GetEntityStats(WDGM_ENTITY_LEDM, &Observed->LedmStats);
+	if (WDGM_ProvideSupervisionStatus() == NOK) {
+		Observed->NokSeen = 1;
+	}
+	if (command != NULL && Observed->Prompts > Observed->Sent) {
+		sim_uart_rx((const uint8_t *)command, (uint16_t)strlen(command));
+		Observed->Sent++;
+	}
+}
+
+
+static SimExitType Session_Run(const char *const *Which) {
+	SimBootResultType result;
+
+	Commands = Which;
+	memset(Observed, 0, sizeof(*Observed));
+	sim_set_hook(Terminal_Hook, HOOK_PERIOD_US);
+	sim_set_uart_tx_hook(Terminal_Receive);
+	sim_boot(SIM_RESET_POWER_ON, RUN_US, &result);
+	printf("%s", Observed->Out);
+	printf("\n%u commands, %u prompts, LEDM calls %u..%u, violations %u, NOK %u\n", Observed->Sent,
+		   Observed->Prompts, Observed->LedmStats.MinCount, Observed->LedmStats.MaxCount,
+		   Observed->LedmStats.Violations, Observed->NokSeen);
+	return result.Exit;
+}
+
+
+/**
+ * @brief Position of Text in the output after From, -1 when missing.
+ */
+static int Out_Find(const char *Text, int From) {
+	const char *found = (From < 0) ? NULL : strstr(Observed->Out + From, Text);
+
+	if (found == NULL) {
+		printf("missing: \"%s\"\n", Text);
+		return -1;
+	}
+	return (int)(found - Observed->Out);
+}
+
+
+int main(void) {
+	int at = 0;
+
+	Observed = (ObservedType *)sim_shared();
+	memset(sim_eeprom(), 0xFF, SIM_EEPROM_SIZE);
+
+	SIM_CHECK(Session_Run(Session) == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->Sent == sizeof(Session) / sizeof(Session[0]) - 1);
+	SIM_CHECK(Observed->Prompts == Observed->Sent + 1);
+
+	// The responses, in the order of the commands
+	at = Out_Find("cfg | set <param> <value> | commit | defaults\r\n", at);
+	at = Out_Find("wdgm status=0 profile=0\r\n", at);
+	at = Out_Find("ent=0 nok=0 en=1 min=8 max=12\r\n", at);
+	at = Out_Find("ent=0 win=", at);
+	at = Out_Find("viol=0\r\nhist ", at);
+	at = Out_Find("ent=2 none\r\n", at);
+	at = Out_Find("tick max=", at);
+	at = Out_Find("stack free=", at);
+	at = Out_Find("vcc off\r\ncs off\r\n", at);
+	at = Out_Find("rst mcusr=", at);
+	at = Out_Find("dump none\r\n", at);
+	at = Out_Find("cfg src=0 gen=0 state=0\r\n", at);
+	at = Out_Find("ledm active=10 staged=10\r\n", at);
+	at = Out_Find("wdto active=", at);
+	at = Out_Find("ok\r\n> err\r\n> ok\r\n> ok\r\n> ok\r\n", at);
+	at = Out_Find("> err\r\n> err\r\n> err\r\n> wdgm status=0", at);
+	SIM_CHECK(at >= 0);
+
+	// The shell never delays LEDM_Manage out of its window
+	SIM_CHECK(!Observed->NokSeen);
+	SIM_CHECK(Observed->LedmStats.Windows > 0 && Observed->LedmStats.Violations == 0);
+	SIM_CHECK(Observed->LedmStats.MinCount >= LEDM_CALLS_OK_MIN && Observed->LedmStats.MaxCount <= LEDM_CALLS_OK_MAX);
+
+	// The committed configuration is loaded at the next boot
+	SIM_CHECK(Session_Run(NextBoot) == SIM_EXIT_STOPPED);
+	at = Out_Find("cfg src=1 gen=1 state=0\r\n", 0);
+	at = Out_Find("ledm active=20 staged=20\r\n", at);
+	at = Out_Find("min active=4 staged=4\r\n", at);
+	SIM_CHECK(at >= 0);
+	SIM_CHECK(!Observed->NokSeen);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
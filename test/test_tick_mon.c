@@ -0,0 +1,140 @@
+/*
+ * test_tick_mon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Latency of the 1ms tick (TickMon) on the host simulator. A critical section is opened
+ * from LEDM_Manage (--wrap) once, TCNT2 = 8 at its entry (256us into a tick), so the next
+ * compare match falls 768us into it:
+ *   - healthy run: every tick within one count, nothing late or lost, supervision OK
+ *   - 1000us section: the tick is served 232us late, below the bound, supervision OK
+ *   - 1400us section: 632us late, WDGM_ENTITY_TICKMON fails and the watchdog resets
+ *   - 2000us section: a second compare match falls inside, one tick is lost (Timer1
+ *     cross-check), WDGM_ENTITY_TICKMON fails
+ */
+
+#include <stdio.h>
+#include <util/delay.h>
+#include "sim.h"
+#include "TickMon.h"
+#include "CritSec.h"
+#include "timer.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US					3000000ULL
+#define SECTION_AT_US			1000000ULL
+#define SECTION_START_COUNTS	8
+#define HOOK_PERIOD_US			1000UL
+#define COUNT_US				32
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * What the firmware reported, written inside the boot.
+ */
+typedef struct {
+	uint8_t Done;
+	uint8_t EntityNok;
+	uint8_t GlobalNok;
+	TickMon_StatsType Stats;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static uint32_t SectionUs;
+static ObservedType *Observed;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_LEDM_Manage(void);
+
+void __wrap_LEDM_Manage(void) {
+	uint8_t sreg;
+
+	__real_LEDM_Manage();
+	if (!SectionUs || Observed->Done || sim_now_us() < SECTION_AT_US) {
+		return;
+	}
+	Observed->Done = 1;
+	// Same phase in every run: the next tick, then SECTION_START_COUNTS into it
+	while (TCNT2 >= SECTION_START_COUNTS) {
+	}
+	while (TCNT2 < SECTION_START_COUNTS) {
+	}
+	CRITSEC_ENTER(CRITSEC_SITE_FAULTINJ_ARM, sreg);
+	_delay_us(SectionUs);
+	CRITSEC_EXIT(CRITSEC_SITE_FAULTINJ_ARM, sreg);
+}
+
+
+static void Observe_Hook(void) {
+	TickMon_GetStats(&Observed->Stats);
+	if (WDGM_GetEntityStatus(WDGM_ENTITY_TICKMON) == NOK) {
+		Observed->EntityNok = 1;
+	}
+	if (WDGM_ProvideSupervisionStatus() == NOK) {
+		Observed->GlobalNok = 1;
+	}
+}
+
+
+static SimExitType Scenario_Run(uint32_t Section) {
+	SimBootResultType result;
+	uint32_t ticks = 0;
+	uint8_t bin;
+
+	SectionUs = Section;
+	sim_run(Observe_Hook, HOOK_PERIOD_US, SIM_RESET_POWER_ON, RUN_US, &result);
+	for (bin = 0; bin < TICKMON_BINS; bin++) {
+		ticks += Observed->Stats.Histogram[bin];
+	}
+	printf("section %4u us: %5u ticks, max latency %3u us, late %u, lost %u, entity NOK %u, exit %d\n",
+		   (unsigned)Section, (unsigned)ticks, Observed->Stats.MaxUs, Observed->Stats.Late,
+		   Observed->Stats.Lost, Observed->EntityNok, (int)result.Exit);
+	return result.Exit;
+}
+
+
+int main(void) {
+	const TickMon_StatsType *stats;
+
+	Observed = (ObservedType *)sim_shared();
+	stats = &Observed->Stats;
+
+	// Healthy: interrupt response only
+	SIM_CHECK(Scenario_Run(0) == SIM_EXIT_STOPPED);
+	SIM_CHECK(stats->MaxUs <= COUNT_US);
+	SIM_CHECK(stats->Late == 0 && stats->Lost == 0);
+	SIM_CHECK(stats->Histogram[0] >= RUN_US / TIMER2_PERIOD_US - 2);
+	SIM_CHECK(!Observed->GlobalNok);
+
+	// Late but below the bound
+	SIM_CHECK(Scenario_Run(1000) == SIM_EXIT_STOPPED);
+	SIM_CHECK(stats->MaxUs >= 232 - COUNT_US && stats->MaxUs <= 232 + COUNT_US);
+	SIM_CHECK(stats->Histogram[stats->MaxUs / TICKMON_BIN_US] == 1);
+	SIM_CHECK(stats->Late == 0 && stats->Lost == 0);
+	SIM_CHECK(!Observed->GlobalNok);
+
+	// Late above the bound: supervision event
+	SIM_CHECK(Scenario_Run(1400) == SIM_EXIT_WATCHDOG_RESET);
+	SIM_CHECK(stats->MaxUs >= 632 - COUNT_US && stats->MaxUs <= 632 + COUNT_US);
+	SIM_CHECK(stats->Late == 1 && stats->Lost == 0);
+	SIM_CHECK(Observed->EntityNok);
+
+	// Lost tick: seen by the Timer1 cross-check only
+	SIM_CHECK(Scenario_Run(2000) == SIM_EXIT_WATCHDOG_RESET);
+	SIM_CHECK(stats->Lost == 1);
+	SIM_CHECK(stats->Late == 0);
+	SIM_CHECK(Observed->EntityNok);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
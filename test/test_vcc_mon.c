@@ -0,0 +1,167 @@
+/*
+ * test_vcc_mon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Supply voltage supervision (VccMon, built with VCCMON_ENABLED=1) on the host simulator,
+ * VCC set with sim_set_vcc_mv from a hook:
+ *   - healthy run at 5V: samples per second of the trigger mode, CPU load of ADC_vect
+ *     between a lower bound (simulator cycles: register accesses only, the C code costs
+ *     nothing) and an upper bound (its cycle budget of tools/wcet_budget.txt), the filtered
+ *     VCC within one ADC step
+ *   - sag to 4.3V: WDGM_ENTITY_VCCMON fails and the watchdog resets
+ *   - step to 2.9V (above the brown-out level): VccMon drives the safe state itself within
+ *     one filter window
+ *   - collapse at 20mV/ms down to the brown-out level: the outputs are in the safe state
+ *     before the brown-out detector would reset the MCU
+ * The last two need the free running trigger, built again with VCCMON_TRIGGER=5
+ * (test_vcc_mon_timer) the first two only run.
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "VccMon.h"
+#include "SafeState.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US					3000000ULL
+#define HEALTHY_US				2000000ULL
+#define EVENT_AT_US				1000000ULL
+#define HOOK_PERIOD_US			100UL
+#define NOMINAL_MV				5000
+#define SAG_MV					4300
+#define STEP_MV					2900
+#define RAMP_MV_PER_HOOK		2				// 20mV/ms
+#define ADC_VECTOR				21
+// ADC_vect cycle budget of tools/wcet_budget.txt (response included)
+#define ADC_VECT_BUDGET_CYCLES	250
+// VCC resolution at 5V: one ADC step is 20mV
+#define VCC_TOLERANCE_MV		25
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	SCENARIO_HEALTHY = 0,
+	SCENARIO_SAG,
+	SCENARIO_STEP,
+	SCENARIO_RAMP
+} ScenarioType;
+
+/**
+ * What the firmware reported, written inside the boot.
+ */
+typedef struct {
+	uint8_t EntityNok;
+	uint16_t VccMv;				// VccMon_GetVccMv at the last hook
+	uint64_t SafeStateUs;		// First hook with the safe state active, 0: none
+	uint16_t SafeStateAtMv;		// Simulated VCC at that hook
+	VccMon_StatsType Stats;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static ScenarioType Scenario;
+static ObservedType *Observed;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+static void Supply_Hook(void) {
+	uint64_t now = sim_now_us();
+	uint16_t vcc = sim_vcc_mv();
+
+	if (now >= EVENT_AT_US) {
+		if (Scenario == SCENARIO_SAG) {
+			vcc = SAG_MV;
+		} else if (Scenario == SCENARIO_STEP) {
+			vcc = STEP_MV;
+		} else if (Scenario == SCENARIO_RAMP) {
+			vcc -= RAMP_MV_PER_HOOK;
+		}
+		sim_set_vcc_mv(vcc);
+	}
+	VccMon_GetStats(&Observed->Stats);
+	Observed->VccMv = VccMon_GetVccMv();
+	if (WDGM_GetEntityStatus(WDGM_ENTITY_VCCMON) == NOK) {
+		Observed->EntityNok = 1;
+	}
+	if (SafeState_IsActive() && !Observed->SafeStateUs) {
+		Observed->SafeStateUs = now;
+		Observed->SafeStateAtMv = vcc;
+	}
+	if (vcc <= VCCMON_BOD_MV) {
+		sim_stop();		// Brown-out reset
+	}
+}
+
+
+static SimExitType Scenario_Run(ScenarioType Which, uint64_t RunUs, SimBootResultType *Result) {
+	Scenario = Which;
+	sim_set_vcc_mv(NOMINAL_MV);
+	return sim_run(Supply_Hook, HOOK_PERIOD_US, SIM_RESET_POWER_ON, RunUs, Result);
+}
+
+
+int main(void) {
+	SimBootResultType result;
+	const VccMon_StatsType *stats;
+	uint32_t expected;
+	uint32_t perSecond;
+
+	Observed = (ObservedType *)sim_shared();
+	stats = &Observed->Stats;
+
+	// Healthy: rate of the trigger mode, load of the conversion complete interrupt
+	SIM_CHECK(Scenario_Run(SCENARIO_HEALTHY, HEALTHY_US, &result) == SIM_EXIT_STOPPED);
+	expected = (uint32_t)(HEALTHY_US / VCCMON_SAMPLE_US);
+	perSecond = (uint32_t)((uint64_t)stats->Samples * 1000000ULL / HEALTHY_US);
+	printf("healthy: %u samples/s (sample every %lu us), ADC_vect %u runs, %llu cycles each, "
+		   "CPU load %.2f%% (register accesses, lower bound) .. %.2f%% (budget), VCC %u mV (min %u)\n",
+		   (unsigned)perSecond, (unsigned long)VCCMON_SAMPLE_US, (unsigned)result.IsrCount[ADC_VECTOR],
+		   (unsigned long long)(result.IsrCount[ADC_VECTOR] ? result.IsrCycles[ADC_VECTOR] / result.IsrCount[ADC_VECTOR] : 0),
+		   100.0 * (double)result.IsrCycles[ADC_VECTOR] / (double)(HEALTHY_US * (F_CPU / 1000000UL)),
+		   100.0 * (double)result.IsrCount[ADC_VECTOR] * ADC_VECT_BUDGET_CYCLES / (double)(HEALTHY_US * (F_CPU / 1000000UL)),
+		   Observed->VccMv, stats->MinMv);
+	SIM_CHECK(stats->Samples + 2 >= expected && stats->Samples <= expected);
+	SIM_CHECK(result.IsrCount[ADC_VECTOR] >= stats->Samples);
+	SIM_CHECK(Observed->VccMv >= NOMINAL_MV - VCC_TOLERANCE_MV && Observed->VccMv <= NOMINAL_MV + VCC_TOLERANCE_MV);
+	SIM_CHECK(stats->Sags == 0 && !stats->SafeState);
+	SIM_CHECK(!Observed->EntityNok && !Observed->SafeStateUs);
+
+	// Sag: supervision event, the watchdog resets
+	SIM_CHECK(Scenario_Run(SCENARIO_SAG, RUN_US, &result) == SIM_EXIT_WATCHDOG_RESET);
+	printf("sag:     %u mV filtered, %u sag, entity NOK %u, reset at %llu us\n", Observed->VccMv,
+		   stats->Sags, Observed->EntityNok, (unsigned long long)result.EndUs);
+	SIM_CHECK(Observed->EntityNok);
+	SIM_CHECK(stats->Sags == 1);
+	SIM_CHECK(!stats->SafeState);
+	SIM_CHECK(Observed->VccMv >= SAG_MV - VCC_TOLERANCE_MV && Observed->VccMv <= SAG_MV + VCC_TOLERANCE_MV);
+
+#if (VCCMON_TRIGGER == VCCMON_TRIGGER_FREE_RUNNING)
+	// Step below the safe level: VccMon does not wait for the supervision window
+	Scenario_Run(SCENARIO_STEP, RUN_US, &result);
+	printf("step:    safe state %llu us after the step, by VccMon %u\n",
+		   (unsigned long long)(Observed->SafeStateUs - EVENT_AT_US), stats->SafeState);
+	SIM_CHECK(stats->SafeState);
+	SIM_CHECK(Observed->SafeStateUs >= EVENT_AT_US);
+	SIM_CHECK(Observed->SafeStateUs - EVENT_AT_US <= (VCCMON_WINDOW + 1) * VCCMON_SAMPLE_US);
+
+	// Collapse: safe state before the brown-out level
+	SIM_CHECK(Scenario_Run(SCENARIO_RAMP, RUN_US, &result) == SIM_EXIT_STOPPED);
+	printf("ramp:    safe state at %u mV (brown-out %u mV), by VccMon %u, min %u mV filtered\n",
+		   Observed->SafeStateAtMv, VCCMON_BOD_MV, stats->SafeState, stats->MinMv);
+	SIM_CHECK(Observed->SafeStateUs);
+	SIM_CHECK(Observed->SafeStateAtMv > VCCMON_BOD_MV);
+#endif
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
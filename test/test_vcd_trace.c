@@ -0,0 +1,205 @@
+/*
+ * test_vcd_trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * VCD trace of the host simulator (sim_trace_open / sim_trace_close):
+ *   - the healthy firmware toggles PB5 (LED_TOGGLE_LED) every 500 ticks in the trace, the
+ *     tick being 1024us (Timer2) this is 512ms
+ *   - without WDGM_MainFunction the watchdog reset is in the trace at the end time of the
+ *     boot, the second boot follows on the same time axis with PORTB back to 0
+ *   - a full buffer drops records and says so in the file
+ *   - tracing costs less than twice the CPU time of an untraced run
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include "sim.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define VCD_PATH				"build/test_vcd_trace.vcd"
+#define TOGGLE_RUN_US			3000000ULL
+#define RESET_RUN_US			400000ULL
+#define TOGGLE_PERIOD_NS		(500ULL * 1024000ULL)
+#define TOGGLE_TOLERANCE_NS		2000000ULL
+#define SPEED_RUN_US			20000000ULL
+#define SPEED_REPEAT			3
+#define SPEED_MAX_RATIO			2.0
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+typedef struct {
+	uint32_t Toggles;			// PB5 changes after the init
+	uint64_t WorstPeriodNs;		// Largest deviation from TOGGLE_PERIOD_NS between two
+	uint64_t ResetNs;			// First wdt_reset event, 0: none
+	uint32_t Boots;				// Last value of "boot"
+	uint8_t PortbAfterReset;	// PORTB at the time of the reset, after the record
+	uint8_t Dropped;			// $comment of a full buffer present
+	uint8_t Timescale;			// 1 ns
+} VcdSummaryType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static uint8_t *SkipMainFunction;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_WDGM_MainFunction(void);
+
+void __wrap_WDGM_MainFunction(void) {
+	if (!*SkipMainFunction) {
+		__real_WDGM_MainFunction();
+	}
+}
+
+
+static uint32_t Vcd_Binary(const char *Bits) {
+	uint32_t v = 0;
+
+	while (*Bits == '0' || *Bits == '1') {
+		v = (v << 1) | (uint32_t)(*Bits++ - '0');
+	}
+	return v;
+}
+
+
+/**
+ * @brief Reads back the VCD written by sim_trace_close (the subset it emits).
+ */
+static VcdSummaryType Vcd_Read(const char *Path) {
+	VcdSummaryType sum;
+	char line[128];
+	uint64_t now = 0, lastToggle = 0;
+	uint8_t resetSeen = 0, initSeen = 0;
+	FILE *f = fopen(Path, "r");
+
+	memset(&sum, 0, sizeof(sum));
+	if (!f) {
+		SIM_CHECK(f != NULL);
+		return sum;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\n")] = '\0';
+		if (!strncmp(line, "$timescale 1 ns", 15)) {
+			sum.Timescale = 1;
+		} else if (!strncmp(line, "$comment", 8) && strstr(line, "dropped")) {
+			sum.Dropped = 1;
+		} else if (line[0] == '#') {
+			now = strtoull(line + 1, NULL, 10);
+		} else if ((!strcmp(line, "1B5") || !strcmp(line, "0B5")) && now != 0) {
+			if (!initSeen) {
+				initSeen = 1;		// LEDM_Init sets the LED
+				continue;
+			}
+			if (sum.Toggles++) {
+				uint64_t period = now - lastToggle;
+				uint64_t dev = period > TOGGLE_PERIOD_NS ? period - TOGGLE_PERIOD_NS : TOGGLE_PERIOD_NS - period;
+				if (dev > sum.WorstPeriodNs) {
+					sum.WorstPeriodNs = dev;
+				}
+			}
+			lastToggle = now;
+		} else if (!strcmp(line, "1E2") && !sum.ResetNs) {
+			sum.ResetNs = now;
+			resetSeen = 1;
+		} else if (line[0] == 'b' && !strcmp(line + strcspn(line, " "), " N")) {
+			sum.Boots = Vcd_Binary(line + 1);
+		} else if (line[0] == 'b' && !strcmp(line + strcspn(line, " "), " B") && resetSeen &&
+				   now == sum.ResetNs) {
+			sum.PortbAfterReset = (uint8_t)Vcd_Binary(line + 1);
+		}
+	}
+	fclose(f);
+	return sum;
+}
+
+
+/**
+ * @brief CPU time of the boot processes for one healthy boot of RunUs.
+ */
+static double Boot_Seconds(uint64_t RunUs) {
+	struct rusage before, after;
+
+	getrusage(RUSAGE_CHILDREN, &before);
+	sim_boot(SIM_RESET_POWER_ON, RunUs, NULL);
+	getrusage(RUSAGE_CHILDREN, &after);
+	return (after.ru_utime.tv_sec - before.ru_utime.tv_sec) + (after.ru_stime.tv_sec - before.ru_stime.tv_sec) +
+		   ((after.ru_utime.tv_usec - before.ru_utime.tv_usec) + (after.ru_stime.tv_usec - before.ru_stime.tv_usec)) / 1e6;
+}
+
+
+int main(void) {
+	SimBootResultType result;
+	VcdSummaryType sum;
+	double plain = 1e9, traced = 1e9, s;
+	long dropped;
+	int i;
+
+	SkipMainFunction = (uint8_t *)sim_shared();
+
+	// Healthy run: PB5 every 500ms, one boot, nothing dropped
+	*SkipMainFunction = 0;
+	SIM_CHECK(sim_trace_open(VCD_PATH, 0) == 0);
+	sim_boot(SIM_RESET_POWER_ON, TOGGLE_RUN_US, &result);
+	dropped = sim_trace_close();
+	sum = Vcd_Read(VCD_PATH);
+	printf("toggle       %u PB5 changes, worst period error %llu ns, %u boot(s), dropped %ld\n",
+		   (unsigned)sum.Toggles, (unsigned long long)sum.WorstPeriodNs, (unsigned)sum.Boots, dropped);
+	SIM_CHECK(dropped == 0);
+	SIM_CHECK(sum.Timescale);
+	SIM_CHECK(sum.Toggles >= TOGGLE_RUN_US * 1000ULL / TOGGLE_PERIOD_NS - 1);
+	SIM_CHECK(sum.WorstPeriodNs <= TOGGLE_TOLERANCE_NS);
+	SIM_CHECK(sum.Boots == 1);
+	SIM_CHECK(sum.ResetNs == 0);
+
+	// Watchdog reset: at the end of the first boot, cycle for cycle, then the second boot
+	*SkipMainFunction = 1;
+	SIM_CHECK(sim_trace_open(VCD_PATH, 0) == 0);
+	sim_boot(SIM_RESET_POWER_ON, RESET_RUN_US, &result);
+	SIM_CHECK(result.Exit == SIM_EXIT_WATCHDOG_RESET);
+	sim_boot(SIM_RESET_WATCHDOG, RESET_RUN_US, NULL);
+	dropped = sim_trace_close();
+	sum = Vcd_Read(VCD_PATH);
+	printf("reset        wdt_reset at %llu ns (boot end %llu us), %u boots, PORTB after reset 0x%02X\n",
+		   (unsigned long long)sum.ResetNs, (unsigned long long)result.EndUs, (unsigned)sum.Boots,
+		   sum.PortbAfterReset);
+	SIM_CHECK(dropped == 0);
+	SIM_CHECK(sum.ResetNs == result.EndUs * 1000ULL);
+	SIM_CHECK(sum.Boots == 2);
+	SIM_CHECK(sum.PortbAfterReset == 0);
+
+	// Full buffer: the records past the capacity are counted, the file says so
+	*SkipMainFunction = 0;
+	SIM_CHECK(sim_trace_open(VCD_PATH, 16) == 0);
+	sim_boot(SIM_RESET_POWER_ON, TOGGLE_RUN_US, NULL);
+	dropped = sim_trace_close();
+	sum = Vcd_Read(VCD_PATH);
+	printf("full buffer  %ld records dropped\n", dropped);
+	SIM_CHECK(dropped > 0);
+	SIM_CHECK(sum.Dropped);
+
+	// Cost: best of SPEED_REPEAT runs each
+	for (i = 0; i < SPEED_REPEAT; i++) {
+		s = Boot_Seconds(SPEED_RUN_US);
+		plain = s < plain ? s : plain;
+		SIM_CHECK(sim_trace_open(VCD_PATH, 0) == 0);
+		s = Boot_Seconds(SPEED_RUN_US);
+		sim_trace_close();
+		traced = s < traced ? s : traced;
+	}
+	printf("speed        %.3f s untraced, %.3f s traced (%.2fx) for %llu s simulated\n", plain, traced,
+		   plain > 0 ? traced / plain : 0.0, (unsigned long long)(SPEED_RUN_US / 1000000ULL));
+	SIM_CHECK(traced <= plain * SPEED_MAX_RATIO + 0.01);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
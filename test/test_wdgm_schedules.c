@@ -0,0 +1,728 @@
+/*
+ * test_wdgm_schedules.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Randomized, seeded schedule interleaving of the supervision chain: WDGM_Init,
+ * WDGM_MainFunction, WDGM_AlivenessIndication and WDGDrv_IsrNotification (WDGM.c and
+ * WDGDRV.c unmodified) run under the super loop of src/main.c, without the peripheral
+ * simulator so that millions of schedules fit in a minute.
+ *
+ * Schedule model (times in CPU microseconds, F_CPU = 1MHz):
+ *   - millis ticks every 1024us from a random phase (Timer2, not blocked: the interrupt
+ *     disabled sections of WDGM are far shorter than one tick)
+ *   - Timer1 compare every 52224us; it starts in timers_init, so the first match comes one
+ *     period minus the init time (0..INIT_MAX_US) after the loop starts. The ISR is held
+ *     back while the I-bit is cleared and preempts the main context at any preemption
+ *     point: every register access and every call into GPIO, timer, StackMon and SafeState
+ *   - every preemption point costs 1..PreemptUs, every task call starts 0..JitterUs late
+ *   - the watchdog oscillator drifts against the CPU clock (DriftPermille)
+ *
+ * Invariants:
+ *   - nominal schedule: WDGM never reports NOK and the watchdog never expires
+ *   - fault schedule: NOK or watchdog expiry within DETECT_BOUND_US of the fault
+ *   - the ISR always reads a valid status and providedStatus equals status (one byte,
+ *     written once per window: no torn reads)
+ *
+ * A failing schedule is shrunk (shorter run, knobs set to zero or halved while it still
+ * fails) and printed as a replay spec
+ * seed:duration_ms:jitter_us:preempt_us:drift_permille:init_us:tick_phase_us:fault:fault_ms
+ *
+ *   test_wdgm_schedules [--count N] [--seed S] [--jobs N] [--jitter-max US]
+ *                       [--preempt-max US] [--drift-max PERMILLE]
+ *   test_wdgm_schedules --replay <spec> [--trace]
+ *
+ * --jobs splits the schedules over worker processes (default: one per CPU).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "WDGM.h"
+#include "WDGDRV.h"
+#include "GPIO.h"
+#include "timer.h"
+#include "StackMon.h"
+#include "SafeState.h"
+#include "Boot.h"
+#include "RunCfg.h"
+#include <avr/interrupt.h>
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define TICK_US					1024UL		// Timer2: OCR2A = 31, clk/32
+#define TIMER1_US				52224UL		// Timer1: OCR1A = 815, clk/64
+#define WDT_US					64000UL		// WDTO_60MS at the nominal oscillator
+#define ISR_ENTRY_US			20			// Vector, prologue and epilogue
+
+#define LEDM_MS					10			// Periods of the super loop (src/main.c)
+#define MAIN_MS					20
+#define LOOP_US_MIN				20			// One pass of the super loop
+#define LOOP_US_MAX				60
+#define BURST_MS				2			// Runaway aliveness indications
+
+// Nominal envelope of the random schedules
+#define JITTER_MAX_US			1000
+#define PREEMPT_MAX_US			200
+#define DRIFT_MAX_PERMILLE		100			// WDT oscillator +-10% against the CPU clock
+#define INIT_MAX_US				20000		// Init functions between timers_init and the loop
+
+#define NOMINAL_MS				1000
+#define FAULT_FIRST_MS			300
+#define FAULT_SPAN_MS			500
+
+/**
+ * Detection bound: the window running at the fault may still close OK, the next one
+ * closes at most WDGM_PERIOD_MS + one MainFunction period (+ jitter) later. A stopped
+ * MainFunction stops the refreshes at the next Timer1 notification and the slowest
+ * watchdog expires after that.
+ */
+#define DETECT_BOUND_US			(2UL * (WDGM_PERIOD_MS + MAIN_MS) * 1000UL + 2UL * JITTER_MAX_US + 2UL * TIMER1_US)
+
+#define COUNT_DEFAULT			200000UL
+#define SREG_ADDR				0x5F
+#define SREG_I_MASK				0x80
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+_Static_assert(sizeof(status) == 1 && sizeof(providedStatus) == 1,
+			   "status and providedStatus must be single bytes (atomic on AVR, -fshort-enums)");
+
+typedef enum {
+	FAULT_NONE = 0,
+	FAULT_NO_ALIVENESS,		/* LEDM stops calling WDGM_AlivenessIndication      */
+	FAULT_NO_MAIN,			/* WDGM_MainFunction is not called anymore          */
+	FAULT_MAIN_STALL,		/* WDGM_MainFunction never returns                  */
+	FAULT_ALIVENESS_BURST,	/* Extra aliveness indications every BURST_MS       */
+	FAULT_LOOP_HANG,		/* The super loop stops, only the ISRs run          */
+	FAULT_COUNT
+} FaultType;
+
+typedef enum {
+	VERDICT_PASS = 0,
+	VERDICT_FALSE_NOK,		/* NOK or watchdog expiry under a nominal schedule  */
+	VERDICT_MISSED,			/* Fault not detected within DETECT_BOUND_US        */
+	VERDICT_TORN			/* Invalid or inconsistent status seen by the ISR   */
+} VerdictType;
+
+typedef struct {
+	uint32_t Seed;				/* Event stream (jitter, preemption costs)      */
+	uint32_t DurationMs;
+	uint32_t JitterUs;
+	uint32_t PreemptUs;
+	int32_t  DriftPermille;
+	uint32_t InitUs;			/* Init time after timers_init (Timer1 phase)   */
+	uint32_t TickPhaseUs;		/* First millis tick                            */
+	uint32_t Fault;
+	uint32_t FaultAtMs;
+} ScheduleType;
+
+/* Knobs halved by Schedule_Shrink */
+typedef enum {
+	KNOB_JITTER = 0,
+	KNOB_PREEMPT,
+	KNOB_INIT,
+	KNOB_TICK_PHASE,
+	KNOB_FAULT_AT,
+	KNOB_COUNT
+} KnobType;
+
+typedef struct {
+	VerdictType Verdict;
+	uint64_t AtUs;				/* Time of the violation                        */
+	uint64_t DetectUs;			/* Fault to NOK/expiry, fault schedules         */
+} OutcomeType;
+
+typedef struct {
+	unsigned long Schedules;
+	unsigned long Faults;
+	unsigned long Failures;
+	uint64_t Worst[FAULT_COUNT];	/* Longest detection per fault class         */
+} SummaryType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+volatile uint32 millis;
+
+static uint8_t Regs[0x100];
+static const ScheduleType *Sched;
+static uint32_t Rng;
+static uint64_t Now, EndUs, FaultUs;
+static uint64_t NextTimer1, LastRefresh, ExpiryUs, NokUs, TornUs;
+static uint32_t WdtUs;
+static int InIsr, InMain, Stalled, SafeActive, Trace;
+static jmp_buf Harness_End;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+static uint32_t Rand(void) {
+	Rng ^= Rng << 13;
+	Rng ^= Rng >> 17;
+	Rng ^= Rng << 5;
+	return Rng;
+}
+
+static uint32_t Rand_Upto(uint32_t Max) {
+	return Max ? Rand() % (Max + 1) : 0;
+}
+
+static uint32_t Mix(uint32_t X) {
+	X ^= X >> 16;
+	X *= 0x7FEB352DUL;
+	X ^= X >> 15;
+	X *= 0x846CA68BUL;
+	X ^= X >> 16;
+	return X ? X : 1;
+}
+
+
+/**
+ * @brief Moves the clock (no interrupt dispatch): millis and the watchdog.
+ */
+static void Clock_Set(uint64_t Us) {
+	if (Us <= Now) {
+		return;
+	}
+	Now = Us;
+	millis = (Now >= Sched->TickPhaseUs) ? (uint32)((Now - Sched->TickPhaseUs) / TICK_US + 1) : 0;
+	if (!ExpiryUs && Now - LastRefresh >= WdtUs) {
+		ExpiryUs = LastRefresh + WdtUs;
+		if (Trace) {
+			printf("%10llu  watchdog expired\n", (unsigned long long)ExpiryUs);
+		}
+	}
+}
+
+
+static void Timer1_Isr(void) {
+	uint8_t sreg = Regs[SREG_ADDR];
+
+	InIsr = 1;
+	Regs[SREG_ADDR] &= (uint8_t)~SREG_I_MASK;
+	Clock_Set(Now + ISR_ENTRY_US);
+	WDGDrv_IsrNotification();
+	if ((status != OK && status != NOK) || providedStatus != status) {
+		if (!TornUs) {
+			TornUs = Now;
+		}
+	}
+	if (Trace) {
+		printf("%10llu  Timer1 ISR  millis %lu  status %d  refresh %s\n", (unsigned long long)Now,
+			   (unsigned long)millis, status, LastRefresh == Now ? "yes" : "no");
+	}
+	while (NextTimer1 <= Now) {
+		NextTimer1 += TIMER1_US;		// One flag: matches while held back are lost
+	}
+	Regs[SREG_ADDR] = sreg;
+	InIsr = 0;
+}
+
+
+/**
+ * @brief Main-context time passes: the Timer1 ISR preempts when it is due and the I-bit is set.
+ */
+static void Advance(uint32_t Us) {
+	uint64_t target = Now + Us;
+
+	while (!InIsr && (Regs[SREG_ADDR] & SREG_I_MASK) && NextTimer1 <= target) {
+		uint64_t start;
+
+		Clock_Set(NextTimer1);
+		start = Now;
+		Timer1_Isr();
+		target += Now - start;		// The ISR steals the CPU
+	}
+	Clock_Set(target);
+}
+
+
+/**
+ * @brief Preemption point: costs 1..PreemptUs, a stalled MainFunction ends here.
+ */
+static void Point(void) {
+	if (InIsr) {
+		Clock_Set(Now + 1);
+		return;
+	}
+	if (InMain && Sched->Fault == FAULT_MAIN_STALL && Now >= FaultUs) {
+		Stalled = 1;
+		while (Now < EndUs) {
+			Advance(1000);
+		}
+		longjmp(Harness_End, 1);
+	}
+	Advance(1 + Rand_Upto(Sched->PreemptUs ? Sched->PreemptUs - 1 : 0));
+}
+
+
+/*******************************************************************************
+ ******************   Firmware environment (register file, stubs)  *************
+ *******************************************************************************/
+volatile uint8_t *sim_access8(uint16_t Address) {
+	Point();
+	return &Regs[Address & 0xFF];
+}
+
+volatile uint16_t *sim_access16(uint16_t Address) {
+	static uint16_t dummy;
+
+	Point();
+	return &dummy;
+}
+
+void sim_sei(void) {
+	Regs[SREG_ADDR] |= SREG_I_MASK;
+}
+
+void sim_cli(void) {
+	Regs[SREG_ADDR] &= (uint8_t)~SREG_I_MASK;
+}
+
+void sim_wdr(void) {
+	if (!ExpiryUs && Now - LastRefresh >= WdtUs) {
+		ExpiryUs = LastRefresh + WdtUs;
+	}
+	LastRefresh = Now;
+}
+
+// Flash defaults, the super loop periods of the harness
+RunCfg_ParamsType RunCfg_Active = {
+	.WdgmPeriodMs = WDGM_PERIOD_MS,
+	.WdgmTaskMs = MAIN_MS,
+	.LedmPeriodMs = LEDM_MS,
+	.LedmCallsMin = LEDM_CALLS_OK_MIN,
+	.LedmCallsMax = LEDM_CALLS_OK_MAX,
+	.WdtTimeout = WDGDRV_DEFAULT_TIMEOUT,
+};
+
+void GPIO_Write(uint8 PinId, uint8 PinData) {
+	Point();
+}
+
+uint32_t HAL_GetTick(void) {
+	Point();
+	return millis;
+}
+
+void StackMon_Init(void) {
+}
+
+void StackMon_MainFunction(void) {
+	Point();
+}
+
+uint8 SafeState_IsActive(void) {
+	Point();
+	return (uint8)SafeActive;
+}
+
+void SafeState_Apply(void) {
+	SafeActive = 1;
+	if (!NokUs) {
+		NokUs = Now;
+		if (Trace) {
+			printf("%10llu  WDGM NOK, safe state\n", (unsigned long long)Now);
+		}
+	}
+}
+
+
+/*******************************************************************************
+ ******************************   Schedules        *****************************
+ *******************************************************************************/
+static uint64_t Tick_Time(uint32_t Millis) {
+	return Millis ? Sched->TickPhaseUs + (uint64_t)(Millis - 1) * TICK_US : 0;
+}
+
+
+/**
+ * @brief Runs one schedule: init, then the super loop of src/main.c until DurationMs.
+ */
+static OutcomeType Schedule_Run(const ScheduleType *Schedule) {
+	OutcomeType outcome = { VERDICT_PASS, 0, 0 };
+	uint32_t checkLed = 0, checkMain = 0, checkBurst = 0;
+	uint64_t detectUs;
+
+	Sched = Schedule;
+	Rng = Mix(Schedule->Seed);
+	memset(Regs, 0, sizeof(Regs));
+	Now = 0;
+	millis = 0;
+	EndUs = (uint64_t)Schedule->DurationMs * 1000ULL;
+	FaultUs = Schedule->Fault ? (uint64_t)Schedule->FaultAtMs * 1000ULL : ~0ULL;
+	NextTimer1 = TIMER1_US - Schedule->InitUs;
+	WdtUs = (uint32_t)(((int64_t)WDT_US * (1000 + Schedule->DriftPermille)) / 1000);
+	LastRefresh = ExpiryUs = NokUs = TornUs = 0;
+	InIsr = InMain = Stalled = SafeActive = 0;
+	WDGM_MainFunction_Stuck = OK;			// .bss of a fresh boot
+
+	if (!setjmp(Harness_End)) {
+		WDGDrv_Init();
+		WDGM_Init();
+#if (BOOT_FAST_MODE == 1)
+		sei();								// Once after every init function, as main()
+		checkLed = millis - LEDM_MS;
+#endif
+		while (Now < EndUs) {
+			uint32_t tick = millis;
+			int hang = (Schedule->Fault == FAULT_LOOP_HANG && Now >= FaultUs);
+			uint64_t next;
+
+			if (!hang && tick - checkLed >= LEDM_MS) {
+				Advance(Rand_Upto(Schedule->JitterUs));
+				Point();							// LEDM_Manage
+				if (!(Schedule->Fault == FAULT_NO_ALIVENESS && Now >= FaultUs)) {
+					WDGM_AlivenessIndication();
+				}
+				checkLed = tick;
+			}
+			if (!hang && tick - checkMain >= MAIN_MS &&
+				!(Schedule->Fault == FAULT_NO_MAIN && Now >= FaultUs)) {
+				Advance(Rand_Upto(Schedule->JitterUs));
+				InMain = 1;
+				WDGM_MainFunction();
+				InMain = 0;
+				if (Trace) {
+					printf("%10llu  WDGM_MainFunction done  millis %lu\n", (unsigned long long)Now,
+						   (unsigned long)millis);
+				}
+				checkMain = tick;
+			}
+			if (Schedule->Fault == FAULT_ALIVENESS_BURST && Now >= FaultUs &&
+				tick - checkBurst >= BURST_MS) {
+				WDGM_AlivenessIndication();
+				checkBurst = tick;
+			}
+
+			// Idle passes of the loop until the next task is due
+			next = Tick_Time(checkLed + LEDM_MS);
+			if (Tick_Time(checkMain + MAIN_MS) < next) {
+				next = Tick_Time(checkMain + MAIN_MS);
+			}
+			if (Schedule->Fault == FAULT_ALIVENESS_BURST && Tick_Time(checkBurst + BURST_MS) < next) {
+				next = Tick_Time(checkBurst + BURST_MS);
+			}
+			if (hang || next > EndUs) {
+				next = EndUs;
+			}
+			Advance((uint32_t)((next > Now ? next - Now : 0) + LOOP_US_MIN +
+							   Rand_Upto(LOOP_US_MAX - LOOP_US_MIN)));
+		}
+	}
+	Clock_Set(EndUs);
+
+	detectUs = ExpiryUs && (!NokUs || ExpiryUs < NokUs) ? ExpiryUs : NokUs;
+	if (TornUs) {
+		outcome.Verdict = VERDICT_TORN;
+		outcome.AtUs = TornUs;
+	} else if (!Schedule->Fault) {
+		if (detectUs) {
+			outcome.Verdict = VERDICT_FALSE_NOK;
+			outcome.AtUs = detectUs;
+		}
+	} else if (detectUs && detectUs < FaultUs) {
+		outcome.Verdict = VERDICT_FALSE_NOK;
+		outcome.AtUs = detectUs;
+	} else if (!detectUs || detectUs - FaultUs > DETECT_BOUND_US) {
+		outcome.Verdict = VERDICT_MISSED;
+		outcome.AtUs = FaultUs + DETECT_BOUND_US;
+	} else {
+		outcome.DetectUs = detectUs - FaultUs;
+	}
+	return outcome;
+}
+
+
+/**
+ * @brief Schedule number Index of the campaign Base: every FAULT_COUNT-th schedule (and
+ * half of the others) is nominal, the knobs are drawn inside the given envelope.
+ */
+static ScheduleType Schedule_Make(uint32_t Base, uint32_t Index, const ScheduleType *Envelope) {
+	ScheduleType s;
+
+	Rng = Mix(Base ^ Mix(Index + 1));
+	s.Seed = Rand();
+	s.JitterUs = Rand_Upto(Envelope->JitterUs);
+	s.PreemptUs = 1 + Rand_Upto(Envelope->PreemptUs - 1);
+	s.DriftPermille = (int32_t)Rand_Upto(2 * (uint32_t)Envelope->DriftPermille) - Envelope->DriftPermille;
+	s.InitUs = Rand_Upto(INIT_MAX_US);
+	s.TickPhaseUs = 1 + Rand_Upto(TICK_US - 1);
+	s.Fault = (Index % 2) ? 1 + Rand_Upto(FAULT_COUNT - 2) : FAULT_NONE;
+	s.FaultAtMs = FAULT_FIRST_MS + Rand_Upto(FAULT_SPAN_MS);
+	s.DurationMs = s.Fault ? s.FaultAtMs + (uint32_t)(DETECT_BOUND_US / 1000UL) + 50 : NOMINAL_MS;
+	return s;
+}
+
+
+static void Schedule_Print(const char *Prefix, const ScheduleType *S) {
+	printf("%s%lu:%lu:%lu:%lu:%ld:%lu:%lu:%lu:%lu\n", Prefix,
+		   (unsigned long)S->Seed, (unsigned long)S->DurationMs, (unsigned long)S->JitterUs,
+		   (unsigned long)S->PreemptUs, (long)S->DriftPermille, (unsigned long)S->InitUs,
+		   (unsigned long)S->TickPhaseUs, (unsigned long)S->Fault, (unsigned long)S->FaultAtMs);
+}
+
+
+static int Schedule_Parse(const char *Spec, ScheduleType *S) {
+	unsigned long v[9];
+	long drift;
+
+	if (sscanf(Spec, "%lu:%lu:%lu:%lu:%ld:%lu:%lu:%lu:%lu", &v[0], &v[1], &v[2], &v[3], &drift,
+			   &v[5], &v[6], &v[7], &v[8]) != 9 || v[7] >= FAULT_COUNT || v[5] > TIMER1_US) {
+		return 0;
+	}
+	S->Seed = (uint32_t)v[0];
+	S->DurationMs = (uint32_t)v[1];
+	S->JitterUs = (uint32_t)v[2];
+	S->PreemptUs = (uint32_t)v[3];
+	S->DriftPermille = (int32_t)drift;
+	S->InitUs = (uint32_t)v[5];
+	S->TickPhaseUs = (uint32_t)v[6];
+	S->Fault = (uint32_t)v[7];
+	S->FaultAtMs = (uint32_t)v[8];
+	return 1;
+}
+
+
+/**
+ * @brief Reads one knob of a schedule (the fields are packed, no pointers to them).
+ */
+static uint32_t Knob_Get(const ScheduleType *S, KnobType Knob) {
+	switch (Knob) {
+	case KNOB_JITTER:		return S->JitterUs;
+	case KNOB_PREEMPT:		return S->PreemptUs;
+	case KNOB_INIT:			return S->InitUs;
+	case KNOB_TICK_PHASE:	return S->TickPhaseUs;
+	default:				return S->FaultAtMs;
+	}
+}
+
+
+static void Knob_Set(ScheduleType *S, KnobType Knob, uint32_t Value) {
+	switch (Knob) {
+	case KNOB_JITTER:		S->JitterUs = Value; break;
+	case KNOB_PREEMPT:		S->PreemptUs = Value; break;
+	case KNOB_INIT:			S->InitUs = Value; break;
+	case KNOB_TICK_PHASE:	S->TickPhaseUs = Value; break;
+	default:				S->FaultAtMs = Value; break;
+	}
+}
+
+
+/**
+ * @brief Shrinks a failing schedule: the run is cut after the violation, then every knob
+ * is set to its neutral value or halved as long as the schedule fails the same way.
+ */
+static ScheduleType Schedule_Shrink(ScheduleType S, VerdictType Verdict) {
+	int progress = 1;
+	KnobType k;
+
+	while (progress) {
+		OutcomeType out = Schedule_Run(&S);
+		uint32_t cut = (uint32_t)(out.AtUs / 1000ULL) + 2;
+
+		progress = 0;
+		if (cut < S.DurationMs) {
+			S.DurationMs = cut;
+			progress = 1;
+		}
+		while (S.DriftPermille != 0) {
+			ScheduleType t = S;
+
+			t.DriftPermille = (S.DriftPermille / 2 == S.DriftPermille) ? 0 : S.DriftPermille / 2;
+			if (Schedule_Run(&t).Verdict != Verdict) {
+				break;
+			}
+			S = t;
+			progress = 1;
+		}
+		for (k = KNOB_JITTER; k < KNOB_COUNT; k++) {
+			uint32_t floor = (k == KNOB_PREEMPT || k == KNOB_TICK_PHASE) ? 1 : 0;
+
+			while (Knob_Get(&S, k) > floor) {
+				uint32_t keep = Knob_Get(&S, k);
+				uint32_t smaller = keep / 2 > floor ? keep / 2 : floor;
+
+				if (k == KNOB_FAULT_AT && !S.Fault) {
+					break;
+				}
+				Knob_Set(&S, k, smaller);
+				if (Schedule_Run(&S).Verdict != Verdict) {
+					Knob_Set(&S, k, keep);
+					break;
+				}
+				progress = 1;
+			}
+		}
+	}
+	return S;
+}
+
+
+static const char *Verdict_Name(VerdictType Verdict) {
+	static const char *const names[] = { "pass", "false NOK", "missed fault", "torn status read" };
+
+	return names[Verdict];
+}
+
+
+/**
+ * @brief Runs the schedules First, First + Step, ... below Count, shrinks the failures
+ * (at most 5 per worker).
+ */
+static SummaryType Campaign_Worker(uint32_t Base, unsigned long First, unsigned long Step,
+								   unsigned long Count, const ScheduleType *Envelope) {
+	SummaryType sum = { 0, 0, 0, { 0 } };
+	unsigned long i;
+
+	for (i = First; i < Count; i += Step) {
+		ScheduleType s = Schedule_Make(Base, (uint32_t)i, Envelope);
+		OutcomeType out = Schedule_Run(&s);
+
+		sum.Schedules++;
+		if (out.Verdict == VERDICT_PASS) {
+			if (s.Fault) {
+				sum.Faults++;
+				if (out.DetectUs > sum.Worst[s.Fault]) {
+					sum.Worst[s.Fault] = out.DetectUs;
+				}
+			}
+			continue;
+		}
+		sum.Failures++;
+		printf("schedule %lu (seed %lu): %s at %llu us\n", i, (unsigned long)Base,
+			   Verdict_Name(out.Verdict), (unsigned long long)out.AtUs);
+		Schedule_Print("  failing: --replay ", &s);
+		s = Schedule_Shrink(s, out.Verdict);
+		Schedule_Print("  shrunk:  --replay ", &s);
+		fflush(stdout);
+		if (sum.Failures >= 5) {
+			break;
+		}
+	}
+	return sum;
+}
+
+
+int main(int argc, char **argv) {
+	ScheduleType envelope = { 0, 0, JITTER_MAX_US, PREEMPT_MAX_US, DRIFT_MAX_PERMILLE, 0, 0, 0, 0 };
+	unsigned long count = COUNT_DEFAULT;
+	uint32_t base = 1;
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int jobs = cpus > 0 ? (int)cpus : 1;
+	int fds[64][2];
+	SummaryType total = { 0, 0, 0, { 0 } };
+	const char *replay = NULL;
+	struct timespec start, end;
+	double seconds;
+	pid_t pid;
+	int a, w;
+
+	for (a = 1; a < argc; a++) {
+		if (!strcmp(argv[a], "--count") && a + 1 < argc) {
+			count = strtoul(argv[++a], NULL, 0);
+		} else if (!strcmp(argv[a], "--jobs") && a + 1 < argc) {
+			jobs = atoi(argv[++a]);
+		} else if (!strcmp(argv[a], "--seed") && a + 1 < argc) {
+			base = (uint32_t)strtoul(argv[++a], NULL, 0);
+		} else if (!strcmp(argv[a], "--jitter-max") && a + 1 < argc) {
+			envelope.JitterUs = (uint32_t)strtoul(argv[++a], NULL, 0);
+		} else if (!strcmp(argv[a], "--preempt-max") && a + 1 < argc) {
+			envelope.PreemptUs = (uint32_t)strtoul(argv[++a], NULL, 0);
+		} else if (!strcmp(argv[a], "--drift-max") && a + 1 < argc) {
+			envelope.DriftPermille = (int32_t)strtol(argv[++a], NULL, 0);
+		} else if (!strcmp(argv[a], "--replay") && a + 1 < argc) {
+			replay = argv[++a];
+		} else if (!strcmp(argv[a], "--trace")) {
+			Trace = 1;
+		} else {
+			printf("usage: %s [--count N] [--seed S] [--jobs N] [--jitter-max US] [--preempt-max US] "
+				   "[--drift-max PERMILLE] | --replay SPEC [--trace]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (envelope.PreemptUs == 0) {
+		envelope.PreemptUs = 1;
+	}
+	if (jobs > 64) {
+		jobs = 64;
+	}
+
+	if (replay) {
+		ScheduleType s;
+		OutcomeType out;
+
+		if (!Schedule_Parse(replay, &s)) {
+			printf("bad replay spec '%s'\n", replay);
+			return 2;
+		}
+		out = Schedule_Run(&s);
+		printf("%s at %llu us", Verdict_Name(out.Verdict), (unsigned long long)out.AtUs);
+		if (s.Fault && out.Verdict == VERDICT_PASS) {
+			printf(", detected %llu us after the fault", (unsigned long long)out.DetectUs);
+		}
+		printf("\n");
+		return out.Verdict != VERDICT_PASS;
+	}
+
+	if (jobs < 1) {
+		jobs = 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (w = 0; w < jobs; w++) {
+		if (pipe(fds[w]) < 0 || (pid = fork()) < 0) {
+			perror("fork");
+			return 2;
+		}
+		if (pid == 0) {
+			SummaryType part = Campaign_Worker(base, w, jobs, count, &envelope);
+
+			fflush(stdout);
+			_exit(write(fds[w][1], &part, sizeof(part)) != (ssize_t)sizeof(part));
+		}
+		close(fds[w][1]);
+	}
+	for (w = 0; w < jobs; w++) {
+		SummaryType part;
+		int k;
+
+		if (read(fds[w][0], &part, sizeof(part)) != (ssize_t)sizeof(part)) {
+			part.Failures = 1;		// Worker crashed
+			part.Schedules = part.Faults = 0;
+			memset(part.Worst, 0, sizeof(part.Worst));
+			printf("worker %d died\n", w);
+		}
+		close(fds[w][0]);
+		total.Schedules += part.Schedules;
+		total.Faults += part.Faults;
+		total.Failures += part.Failures;
+		for (k = 0; k < FAULT_COUNT; k++) {
+			if (part.Worst[k] > total.Worst[k]) {
+				total.Worst[k] = part.Worst[k];
+			}
+		}
+	}
+	while (wait(NULL) > 0) {
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	seconds = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+	printf("%lu schedules (%lu with faults, %d jobs) in %.2f s, %.0f per minute\n", total.Schedules,
+		   total.Faults, jobs, seconds, seconds > 0 ? total.Schedules * 60.0 / seconds : 0.0);
+	printf("worst detection (bound %lu us): no aliveness %llu, no main %llu, main stall %llu, "
+		   "aliveness burst %llu, loop hang %llu us\n", (unsigned long)DETECT_BOUND_US,
+		   (unsigned long long)total.Worst[FAULT_NO_ALIVENESS], (unsigned long long)total.Worst[FAULT_NO_MAIN],
+		   (unsigned long long)total.Worst[FAULT_MAIN_STALL], (unsigned long long)total.Worst[FAULT_ALIVENESS_BURST],
+		   (unsigned long long)total.Worst[FAULT_LOOP_HANG]);
+	printf("%s: %lu failed schedules\n", __FILE__, total.Failures);
+	return total.Failures != 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * test_wdgm_stats.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Supervision statistics of WDGM, read back from the telemetry frames on the USART0 TX line
+ * of the host simulator (built with TELEMETRY_ENABLED=1):
+ *   - healthy run: LEDM ~10 calls per window, inside 8..12, no near miss, no violation; the
+ *     histogram adds up to the windows, the mean lies between min and max
+ *   - marginal run: one LEDM aliveness indication of every five is lost (--wrap), the
+ *     windows see 8 calls: still OK, but each one is a near miss at margin 0
+ *   - burst run: one window sees 0xFF LEDM calls (a runaway entity, the call counter
+ *     saturates); the violation is counted and the high margin saturates at -128
+ *   - WDGM_GetEntityStats at the end of the boot matches the last frame of the entity
+ *   - only the count-supervised entities have statistics and frames (LEDM in this build),
+ *     so the LEDM frame comes every TELEMETRY_PERIOD_MS
+ */
+
+#include <stdio.h>
+#include "sim.h"
+#include "WDGM.h"
+#include "Telemetry.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define RUN_US					4000000ULL
+#define DROP_EVERY				5
+// The burst lands about one second into the boot
+#define BURST_AT_CALL			100UL
+// Frames are queued every TELEMETRY_PERIOD_MS, one entity each
+#define FRAMES_MIN				((RUN_US / 1000UL / TELEMETRY_PERIOD_MS) - 2)
+#define FRAME_MAX				(TELEMETRY_STATS_LENGTH + TELEMETRY_FRAME_OVERHEAD)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	SCENARIO_HEALTHY = 0,
+	SCENARIO_MARGINAL,
+	SCENARIO_BURST
+} ScenarioType;
+
+/**
+ * Decoded frames, written by the UART hook inside the boot.
+ */
+typedef struct {
+	uint32_t Frames;
+	uint32_t CrcErrors;
+	uint8_t Seen[WDGM_ENTITY_COUNT];
+	WDGM_EntityStatsType Last[WDGM_ENTITY_COUNT];	// Last frame of each entity
+	uint16_t LastMeanX16[WDGM_ENTITY_COUNT];
+	WDGM_EntityStatsType Snapshot[WDGM_ENTITY_COUNT];	// WDGM_GetEntityStats at the end
+	uint8_t HasStats[WDGM_ENTITY_COUNT];				// WDGM_GetEntityStats returned true
+	uint8_t Rx[FRAME_MAX];
+	uint8_t RxCount;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static ScenarioType Scenario;
+static ObservedType *Observed;
+static uint32_t AlivenessCalls;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_WDGM_AlivenessIndication(void);
+
+void __wrap_WDGM_AlivenessIndication(void) {
+	uint16_t extra;
+
+	AlivenessCalls++;
+	if (Scenario == SCENARIO_BURST && AlivenessCalls == BURST_AT_CALL) {
+		for (extra = 0; extra < 0x100; extra++) {
+			__real_WDGM_AlivenessIndication();
+		}
+	}
+	if (Scenario != SCENARIO_MARGINAL || AlivenessCalls % DROP_EVERY != 0) {
+		__real_WDGM_AlivenessIndication();
+	}
+}
+
+
+static uint16_t Get16(const uint8_t *Data) {
+	return (uint16_t)(Data[0] | (Data[1] << 8));
+}
+
+
+/**
+ * @brief Decodes one entity stats payload into WDGM_EntityStatsType.
+ */
+static void Frame_Decode(const uint8_t *Payload) {
+	uint8_t entity = Payload[0];
+	WDGM_EntityStatsType *stats;
+	uint8_t bin;
+
+	if (entity >= WDGM_ENTITY_COUNT) {
+		Observed->CrcErrors++;
+		return;
+	}
+	stats = &Observed->Last[entity];
+	stats->Windows = Get16(Payload + 1) | ((uint32_t)Get16(Payload + 3) << 16);
+	stats->MinCount = Payload[5];
+	stats->MaxCount = Payload[6];
+	Observed->LastMeanX16[entity] = Get16(Payload + 7);
+	stats->MinMarginLow = (sint8)Payload[9];
+	stats->MinMarginHigh = (sint8)Payload[10];
+	stats->NearMisses = Get16(Payload + 11);
+	stats->Violations = Get16(Payload + 13);
+	for (bin = 0; bin < WDGM_STATS_BINS; bin++) {
+		stats->Histogram[bin] = Get16(Payload + 15 + 2 * bin);
+	}
+	Observed->Seen[entity] = 1;
+	Observed->Frames++;
+}
+
+
+static void Uart_Hook(uint8_t Data) {
+	uint8_t *rx = Observed->Rx;
+
+	if (Observed->RxCount == 0 && Data != TELEMETRY_SOF) {
+		return;
+	}
+	rx[Observed->RxCount++] = Data;
+	if (Observed->RxCount == 3 && (rx[1] != TELEMETRY_TYPE_ENTITY_STATS || rx[2] != TELEMETRY_STATS_LENGTH)) {
+		Observed->CrcErrors++;
+		Observed->RxCount = 0;
+	} else if (Observed->RxCount == FRAME_MAX) {
+		if (Telemetry_FrameCrc(rx[1], rx + 3, rx[2]) == rx[FRAME_MAX - 1]) {
+			Frame_Decode(rx + 3);
+		} else {
+			Observed->CrcErrors++;
+		}
+		Observed->RxCount = 0;
+	}
+}
+
+
+static void Snapshot_Hook(void) {
+	uint8_t entity;
+
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		Observed->HasStats[entity] = WDGM_GetEntityStats((WDGM_EntityIdType)entity, &Observed->Snapshot[entity]);
+	}
+}
+
+
+static SimExitType Scenario_Run(ScenarioType Which) {
+	Scenario = Which;
+	AlivenessCalls = 0;
+	sim_set_uart_tx_hook(Uart_Hook);
+	return sim_run(Snapshot_Hook, 100000UL, SIM_RESET_POWER_ON, RUN_US, NULL);
+}
+
+
+/**
+ * @brief Consistency of one decoded frame, returns the histogram sum.
+ */
+static uint32_t Stats_Check(uint8_t Entity) {
+	const WDGM_EntityStatsType *stats = &Observed->Last[Entity];
+	uint32_t sum = 0;
+	uint8_t bin;
+
+	for (bin = 0; bin < WDGM_STATS_BINS; bin++) {
+		sum += stats->Histogram[bin];
+	}
+	SIM_CHECK(sum == stats->Windows);
+	if (stats->Windows) {
+		SIM_CHECK(stats->MinCount <= stats->MaxCount);
+		SIM_CHECK(Observed->LastMeanX16[Entity] >= stats->MinCount * 16U);
+		SIM_CHECK(Observed->LastMeanX16[Entity] <= stats->MaxCount * 16U);
+	}
+	return sum;
+}
+
+
+static void Stats_Print(const char *Name) {
+	const WDGM_EntityStatsType *stats = &Observed->Last[WDGM_ENTITY_LEDM];
+	uint8_t bin;
+
+	printf("%-9s %u frames, %u bad; LEDM %u windows, calls %u..%u mean %u.%02u, margins %d/%d, "
+		   "near misses %u, violations %u, histogram",
+		   Name, (unsigned)Observed->Frames, (unsigned)Observed->CrcErrors, (unsigned)stats->Windows,
+		   stats->MinCount, stats->MaxCount, Observed->LastMeanX16[0] / 16,
+		   (Observed->LastMeanX16[0] % 16) * 100 / 16, stats->MinMarginLow, stats->MinMarginHigh,
+		   stats->NearMisses, stats->Violations);
+	for (bin = 0; bin < WDGM_STATS_BINS; bin++) {
+		if (stats->Histogram[bin]) {
+			printf(" %u:%u", bin, stats->Histogram[bin]);
+		}
+	}
+	printf("\n");
+}
+
+
+int main(void) {
+	const WDGM_EntityStatsType *ledm;
+	uint8_t entity;
+
+	Observed = (ObservedType *)sim_shared();
+
+	// Healthy: every entity with statistics reported, LEDM well inside its bounds
+	SIM_CHECK(Scenario_Run(SCENARIO_HEALTHY) == SIM_EXIT_STOPPED);
+	Stats_Print("healthy");
+	SIM_CHECK(Observed->CrcErrors == 0);
+	SIM_CHECK(Observed->Frames >= FRAMES_MIN);
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		SIM_CHECK(Observed->Seen[entity] == Observed->HasStats[entity]);
+		Stats_Check(entity);
+	}
+	SIM_CHECK(Observed->HasStats[WDGM_ENTITY_LEDM]);
+	SIM_CHECK(!Observed->HasStats[WDGM_ENTITY_STACKMON] && !Observed->HasStats[WDGM_ENTITY_FLASHCRC]);
+	SIM_CHECK(!Observed->HasStats[WDGM_ENTITY_TICKMON] && !Observed->HasStats[WDGM_ENTITY_VCCMON]);
+	ledm = &Observed->Last[WDGM_ENTITY_LEDM];
+	SIM_CHECK(ledm->Windows >= RUN_US / 1000UL / WDGM_PERIOD_MS - 10);
+	SIM_CHECK(ledm->MinCount >= LEDM_CALLS_OK_MIN + 1);
+	SIM_CHECK(ledm->MaxCount <= LEDM_CALLS_OK_MAX - 1);
+	SIM_CHECK(ledm->MinMarginLow == ledm->MinCount - LEDM_CALLS_OK_MIN);
+	SIM_CHECK(ledm->MinMarginHigh == LEDM_CALLS_OK_MAX - ledm->MaxCount);
+	SIM_CHECK(ledm->NearMisses == 0);
+	SIM_CHECK(ledm->Violations == 0);
+	// The snapshot is newer than the last frame of the entity, never older
+	SIM_CHECK(Observed->Snapshot[WDGM_ENTITY_LEDM].Windows >= ledm->Windows);
+	SIM_CHECK(Observed->Snapshot[WDGM_ENTITY_LEDM].Violations == 0);
+
+	// Marginal: 8 calls per window, OK but at the lower bound
+	SIM_CHECK(Scenario_Run(SCENARIO_MARGINAL) == SIM_EXIT_STOPPED);
+	Stats_Print("marginal");
+	SIM_CHECK(Observed->CrcErrors == 0);
+	Stats_Check(WDGM_ENTITY_LEDM);
+	ledm = &Observed->Last[WDGM_ENTITY_LEDM];
+	SIM_CHECK(ledm->Windows > 0);
+	SIM_CHECK(ledm->Violations == 0);
+	SIM_CHECK(ledm->MinMarginLow <= WDGM_STATS_NEAR_MISS);
+	SIM_CHECK(ledm->NearMisses >= ledm->Windows / 2);
+
+	// Burst: the saturated call count gives 12 - 255 = -243, stored as -128, not as +13
+	Scenario_Run(SCENARIO_BURST);
+	Stats_Print("burst");
+	SIM_CHECK(Observed->CrcErrors == 0);
+	ledm = &Observed->Snapshot[WDGM_ENTITY_LEDM];
+	SIM_CHECK(ledm->MaxCount == 0xFF);
+	SIM_CHECK(ledm->MinMarginHigh == -128);
+	SIM_CHECK(ledm->Violations >= 1);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
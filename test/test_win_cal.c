@@ -0,0 +1,263 @@
+/*
+ * test_win_cal.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ *
+ * Supervision windows learned after a cold boot (WinCal) on the host simulator, the EEPROM
+ * is kept across the boots:
+ *   - erased EEPROM, power-on: the LEDM window is learned (10 calls -> 9..11), written
+ *     in the background without a NOK window, and the record is valid in the EEPROM
+ *   - with the +/-1 jitter of the target (9 and 11 calls in turn) the learned window is
+ *     still 9..11, not widened to 8..12, and the jitter never gives a NOK window
+ *   - the next boots load it, a minute of healthy run stays OK with it; the learned window
+ *     detects a fault the default one misses
+ *     (one aliveness indication in five lost: 8 calls per window)
+ *   - a reset that is not a power-on does not learn (a brown-out after a power-on neither), a corrupted record is learned again,
+ *     a boot ending during the write leaves an invalid record
+ *   - a committed LEDM period of 12ms (8 calls per window, window 7..12) drops the record
+ *     learned at 10ms: the default window stays OK, the next cold boot learns again
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <util/crc16.h>
+#include "sim.h"
+#include "WDGM.h"
+#include "WinCal.h"
+#include "RunCfg.h"
+#include "LEDM.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+#define LEARN_RUN_US			8000000ULL
+#define SHORT_RUN_US			1000000ULL
+#define LOAD_RUN_US				60000000ULL
+#define HOOK_PERIOD_US			1000UL
+#define COMMIT_AT_US			200000ULL
+#define NEW_LEDM_MS				12
+#define NEW_LEDM_MIN			7
+#define DROP_EVERY				5
+// Jitter: in every JITTER_EVERY calls one is lost and one doubled half way, so that each
+// window of 10 calls holds exactly one of them (9 and 11 calls in turn)
+#define JITTER_EVERY			20
+#define JITTER_RUN_US			20000000ULL
+// Learning ends after the settling time and WINCAL_WINDOWS windows (+ the 20ms task)
+#define LEARN_MAX_US			((WINCAL_SETTLE_MS + (WINCAL_WINDOWS + 2UL) * WDGM_PERIOD_MS + 40UL) * 1000UL)
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	SCENARIO_HEALTHY = 0,
+	SCENARIO_MARGINAL,		/* One LEDM aliveness indication in DROP_EVERY lost */
+	SCENARIO_JITTER,		/* LEDM calls move by +/-1 between the windows      */
+	SCENARIO_STOP_WRITING,	/* Boot ends while the record is written            */
+	SCENARIO_LEDM_12MS		/* LEDM period 12ms, window 7..12, RunCfg commit    */
+} ScenarioType;
+
+/**
+ * What the firmware reported, written by the hook inside the boot.
+ */
+typedef struct {
+	WinCal_StateType State;
+	uint64_t StateUs[WINCAL_STATE_ABORTED + 1];	// First time in each state, 0: never
+	uint8_t NokSeen;
+	uint8_t CommitOk;
+	WDGM_EntityConfigType Ledm;
+} ObservedType;
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static ScenarioType Scenario;
+static ObservedType *Observed;
+static uint32_t AlivenessCalls;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+void __real_WDGM_AlivenessIndication(void);
+
+void __wrap_WDGM_AlivenessIndication(void) {
+	if (Scenario == SCENARIO_JITTER) {
+		uint32_t phase = AlivenessCalls++ % JITTER_EVERY;
+
+		if (phase == JITTER_EVERY / 2) {
+			__real_WDGM_AlivenessIndication();
+		}
+		if (phase != 0) {
+			__real_WDGM_AlivenessIndication();
+		}
+	} else if (Scenario != SCENARIO_MARGINAL || ++AlivenessCalls % DROP_EVERY != 0) {
+		__real_WDGM_AlivenessIndication();
+	}
+	if (Scenario == SCENARIO_LEDM_12MS && !Observed->CommitOk && sim_now_us() >= COMMIT_AT_US) {
+		RunCfg_Set(RUNCFG_PARAM_LEDM_PERIOD_MS, NEW_LEDM_MS);
+		RunCfg_Set(RUNCFG_PARAM_LEDM_CALLS_MIN, NEW_LEDM_MIN);
+		Observed->CommitOk = RunCfg_Commit();
+	}
+}
+
+
+static void Observe_Hook(void) {
+	WinCal_StateType state = WinCal_GetState();
+
+	Observed->State = state;
+	if (!Observed->StateUs[state]) {
+		Observed->StateUs[state] = sim_now_us();
+	}
+	if (WDGM_ProvideSupervisionStatus() == NOK) {
+		Observed->NokSeen = 1;
+	}
+	WDGM_GetEntityConfig(WDGM_ENTITY_LEDM, &Observed->Ledm);
+	if (Scenario == SCENARIO_STOP_WRITING && state == WINCAL_STATE_WRITING) {
+		sim_stop();
+	}
+}
+
+
+static SimExitType Scenario_Run(ScenarioType Which, SimResetType Cause, uint64_t RunUs) {
+	Scenario = Which;
+	return sim_run(Observe_Hook, HOOK_PERIOD_US, Cause, RunUs, NULL);
+}
+
+
+/**
+ * @brief Record in the simulated EEPROM, 1 when it is valid.
+ */
+static int Record_Get(WinCal_RecordType *Record) {
+	uint16_t crc = 0xFFFF;
+	size_t i;
+
+	memcpy(Record, sim_eeprom() + WINCAL_EEPROM_ADDR, sizeof(*Record));
+	for (i = 0; i < offsetof(WinCal_RecordType, Crc); i++) {
+		crc = _crc_ccitt_update(crc, ((const uint8_t *)Record)[i]);
+	}
+	return Record->Version == WINCAL_VERSION && Record->Crc == crc;
+}
+
+
+static void Eeprom_Erase(void) {
+	memset(sim_eeprom(), 0xFF, SIM_EEPROM_SIZE);
+}
+
+
+int main(void) {
+	WinCal_RecordType record;
+	SimExitType exitCause;
+
+	Observed = (ObservedType *)sim_shared();
+
+	// Cold boot, erased EEPROM: learned, written, no NOK window on the way
+	Eeprom_Erase();
+	exitCause = Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, LEARN_RUN_US);
+	printf("learn        learning at %llu us, written at %llu us, stored at %llu us, LEDM %u..%u\n",
+		   (unsigned long long)Observed->StateUs[WINCAL_STATE_LEARNING],
+		   (unsigned long long)Observed->StateUs[WINCAL_STATE_WRITING],
+		   (unsigned long long)Observed->StateUs[WINCAL_STATE_CALIBRATED], Observed->Ledm.MinCalls,
+		   Observed->Ledm.MaxCalls);
+	SIM_CHECK(exitCause == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->State == WINCAL_STATE_CALIBRATED);
+	SIM_CHECK(Observed->StateUs[WINCAL_STATE_WRITING] <= LEARN_MAX_US);
+	SIM_CHECK(!Observed->StateUs[WINCAL_STATE_ABORTED]);
+	SIM_CHECK(!Observed->NokSeen);
+	SIM_CHECK(Record_Get(&record));
+	SIM_CHECK(record.Entities == (1 << WDGM_ENTITY_LEDM));
+	SIM_CHECK(record.MinCalls[WDGM_ENTITY_LEDM] == 9);
+	SIM_CHECK(record.MaxCalls[WDGM_ENTITY_LEDM] >= 11 && record.MaxCalls[WDGM_ENTITY_LEDM] <= LEDM_CALLS_OK_MAX);
+	SIM_CHECK(Observed->Ledm.MinCalls == 9);
+
+	// Next cold boot: loaded at init, a long healthy run stays OK with the tight window
+	exitCause = Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, LOAD_RUN_US);
+	printf("load         state %d, LEDM %u..%u\n", (int)Observed->State, Observed->Ledm.MinCalls,
+		   Observed->Ledm.MaxCalls);
+	SIM_CHECK(exitCause == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->State == WINCAL_STATE_LOADED);
+	SIM_CHECK(Observed->Ledm.MinCalls == record.MinCalls[WDGM_ENTITY_LEDM]);
+	SIM_CHECK(!Observed->NokSeen);
+
+	// +/-1 jitter while learning: the observed 9..11 is kept, the jitter stays OK with it
+	Eeprom_Erase();
+	exitCause = Scenario_Run(SCENARIO_JITTER, SIM_RESET_POWER_ON, LEARN_RUN_US);
+	printf("jitter learn state %d, LEDM %u..%u\n", (int)Observed->State, Observed->Ledm.MinCalls,
+		   Observed->Ledm.MaxCalls);
+	SIM_CHECK(exitCause == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->State == WINCAL_STATE_CALIBRATED);
+	SIM_CHECK(!Observed->NokSeen);
+	SIM_CHECK(Record_Get(&record));
+	SIM_CHECK(record.MinCalls[WDGM_ENTITY_LEDM] == 9 && record.MaxCalls[WDGM_ENTITY_LEDM] == 11);
+	exitCause = Scenario_Run(SCENARIO_JITTER, SIM_RESET_POWER_ON, JITTER_RUN_US);
+	printf("jitter load  state %d, NOK %u\n", (int)Observed->State, Observed->NokSeen);
+	SIM_CHECK(exitCause == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->State == WINCAL_STATE_LOADED);
+	SIM_CHECK(!Observed->NokSeen);
+
+	// 8 calls per window: detected with the learned window...
+	exitCause = Scenario_Run(SCENARIO_MARGINAL, SIM_RESET_POWER_ON, SHORT_RUN_US);
+	printf("marginal     learned window: NOK %u, exit %d\n", Observed->NokSeen, (int)exitCause);
+	SIM_CHECK(Observed->NokSeen);
+	SIM_CHECK(exitCause == SIM_EXIT_WATCHDOG_RESET);
+
+	// ...not with the default one (reset other than power-on: nothing learned)
+	Eeprom_Erase();
+	exitCause = Scenario_Run(SCENARIO_MARGINAL, SIM_RESET_EXTERNAL, SHORT_RUN_US);
+	printf("marginal     default window: NOK %u, exit %d\n", Observed->NokSeen, (int)exitCause);
+	SIM_CHECK(!Observed->NokSeen);
+	SIM_CHECK(exitCause == SIM_EXIT_STOPPED);
+
+	// No learning after a reset that is not a power-on
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_EXTERNAL, LEARN_RUN_US);
+	printf("warm boot    state %d\n", (int)Observed->State);
+	SIM_CHECK(Observed->State == WINCAL_STATE_DEFAULT);
+	SIM_CHECK(sim_eeprom()[WINCAL_EEPROM_ADDR] == 0xFF);
+
+	// Brown-out after a power-on: PORF was cleared by the power-on boot, nothing learned
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, SHORT_RUN_US);
+	SIM_CHECK(Observed->State == WINCAL_STATE_LEARNING);
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_BROWN_OUT, SHORT_RUN_US);
+	printf("brown-out    state %d\n", (int)Observed->State);
+	SIM_CHECK(Observed->State == WINCAL_STATE_DEFAULT);
+
+	// Boot ending during the write: the record is not valid, the next cold boot learns
+	Scenario_Run(SCENARIO_STOP_WRITING, SIM_RESET_POWER_ON, LEARN_RUN_US);
+	printf("power loss   stopped in state %d, record valid %d\n", (int)Observed->State, Record_Get(&record));
+	SIM_CHECK(Observed->State == WINCAL_STATE_WRITING);
+	SIM_CHECK(!Record_Get(&record));
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, SHORT_RUN_US);
+	SIM_CHECK(Observed->State == WINCAL_STATE_LEARNING);
+
+	// Corrupted record: learned again
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, LEARN_RUN_US);
+	SIM_CHECK(Record_Get(&record));
+	sim_eeprom()[WINCAL_EEPROM_ADDR + offsetof(WinCal_RecordType, MinCalls)] ^= 0x01;
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, LEARN_RUN_US);
+	printf("corrupted    state %d, record valid %d\n", (int)Observed->State, Record_Get(&record));
+	SIM_CHECK(Observed->StateUs[WINCAL_STATE_LEARNING] != 0);
+	SIM_CHECK(Observed->State == WINCAL_STATE_CALIBRATED);
+	SIM_CHECK(Record_Get(&record));
+
+	// Other LEDM period committed: the record of 10ms no longer applies
+	SIM_CHECK(record.LedmPeriodMs == LEDM_PERIOD_MS);
+	Scenario_Run(SCENARIO_LEDM_12MS, SIM_RESET_EXTERNAL, SHORT_RUN_US);
+	SIM_CHECK(Observed->CommitOk);
+	exitCause = Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_EXTERNAL, SHORT_RUN_US);
+	printf("ledm 12ms    state %d, LEDM %u..%u, NOK %u, exit %d\n", (int)Observed->State, Observed->Ledm.MinCalls,
+		   Observed->Ledm.MaxCalls, Observed->NokSeen, (int)exitCause);
+	SIM_CHECK(exitCause == SIM_EXIT_STOPPED);
+	SIM_CHECK(Observed->State == WINCAL_STATE_DEFAULT);
+	SIM_CHECK(Observed->Ledm.MinCalls == NEW_LEDM_MIN && Observed->Ledm.MaxCalls == LEDM_CALLS_OK_MAX);
+	SIM_CHECK(!Observed->NokSeen);
+	Scenario_Run(SCENARIO_HEALTHY, SIM_RESET_POWER_ON, LEARN_RUN_US);
+	printf("ledm 12ms    relearned: state %d, LEDM %u..%u\n", (int)Observed->State, Observed->Ledm.MinCalls,
+		   Observed->Ledm.MaxCalls);
+	SIM_CHECK(Observed->State == WINCAL_STATE_CALIBRATED && !Observed->NokSeen);
+	SIM_CHECK(Record_Get(&record) && record.LedmPeriodMs == NEW_LEDM_MS);
+
+	printf("%s: %u failed checks\n", __FILE__, (unsigned)sim_failures());
+	return sim_failures() != 0;
+}
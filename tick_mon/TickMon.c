@@ -0,0 +1,156 @@
+/*
+ * TickMon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "TickMon.h"
+#include <avr/io.h>
+#include "timer.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+// TCNT2: one count every 32us, TIMER2_COMPARE_VALUE + 1 counts per tick
+#define TICKMON_COUNT_US		((TIMER2_PRESCALER * 1000UL) / (F_CPU / 1000UL))
+#define TICKMON_TICK_COUNTS		(TIMER2_COMPARE_VALUE + 1)
+#define TICKMON_LATE_COUNTS		(TICKMON_LATENCY_BOUND_US / TICKMON_COUNT_US)
+#define TICKMON_BIN_COUNTS		(TICKMON_BIN_US / TICKMON_COUNT_US)
+
+// Timer2 counts per Timer1 period (51 ticks) and per Timer1 count
+#define TICKMON_REF_COUNTS		((TIMER1_COMPARE_VALUE + 1UL) * TIMER1_PRESCALER / TIMER2_PRESCALER)
+#define TICKMON_REF_SCALE		(TIMER1_PRESCALER / TIMER2_PRESCALER)
+
+#if ((TIMER2_COMPARE_VALUE / TICKMON_BIN_COUNTS) >= TICKMON_BINS)
+#error "The latency histogram must cover one tick period"
+#endif
+#if ((TICKMON_REF_COUNTS % TICKMON_TICK_COUNTS) != 0)
+#error "The Timer1 period must be a whole number of 1ms ticks"
+#endif
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// Written by the Timer1/Timer2 interrupts only
+static uint8 TickMon_MaxCounts;
+static uint16 TickMon_Late;
+static uint16 TickMon_Lost;
+static uint32 TickMon_Histogram[TICKMON_BINS];
+
+static uint16 TickMon_RefPosition;		// Timer2 position at the last Timer1 compare match
+static uint8 TickMon_RefValid;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Clears the statistics, the next Timer1 interrupt takes a new reference.
+ *
+ * Called before timers_init.
+ */
+void TickMon_Init(void) {
+	TickMon_ResetStats();
+	TickMon_RefValid = 0;
+}
+
+
+/**
+ * @brief Latency of one tick, called from ISR(TIMER2_COMPA_vect).
+ *
+ * Timer2 runs in CTC mode: TCNT2 restarts from 0 at the compare match, so its value at
+ * the entry of the ISR is the latency in counts. A late tick is a failure of
+ * WDGM_ENTITY_TICKMON: every HAL_GetTick period of the window was stretched.
+ *
+ * @param Counts TCNT2 read first thing in the ISR.
+ */
+void TickMon_TickNotification(uint8 Counts) {
+	if (Counts > TickMon_MaxCounts) {
+		TickMon_MaxCounts = Counts;
+	}
+	TickMon_Histogram[Counts / TICKMON_BIN_COUNTS]++;
+	if (Counts >= TICKMON_LATE_COUNTS) {
+		TickMon_Late++;
+		WDGM_EntityFailureIndication(WDGM_ENTITY_TICKMON);
+	}
+}
+
+
+/**
+ * @brief Lost ticks, called from ISR(TIMER1_COMPA_vect) every 52.2ms.
+ *
+ * A tick is lost when the interrupts stay disabled past a second compare match: OCF2A
+ * holds one match only and TCNT2 does not show it. The Timer1 period is exactly
+ * TICKMON_REF_COUNTS Timer2 counts, both timers run from the same clock. The Timer2 position
+ * (millis, TCNT2 and a pending match) taken back to the Timer1 compare match with TCNT1
+ * must advance by that much, independently of the latency of either interrupt; the
+ * shortfall in whole ticks was lost. A tick pending for more than half a period at this
+ * point is counted lost as well (and it is late anyway).
+ */
+void TickMon_RefNotification(void) {
+	uint16 since = TCNT1;
+	uint8 counts = TCNT2;
+	uint16 ticks = (uint16)millis;
+	uint16 position;
+
+	// Compare match already happened but TIMER2_COMPA_vect did not run yet
+	if ((TIFR2 & (1 << OCF2A)) && counts < (TIMER2_COMPARE_VALUE / 2)) {
+		ticks++;
+	}
+	// Wraps every 2048 ticks, far more than one Timer1 period
+	position = (uint16)(ticks * TICKMON_TICK_COUNTS + counts - since * TICKMON_REF_SCALE);
+	if (TickMon_RefValid) {
+		sint16 missing = (sint16)(TICKMON_REF_COUNTS - (uint16)(position - TickMon_RefPosition));
+
+		if (missing > TICKMON_TICK_COUNTS / 2) {
+			TickMon_Lost += (uint16)((missing + TICKMON_TICK_COUNTS / 2) / TICKMON_TICK_COUNTS);
+			WDGM_EntityFailureIndication(WDGM_ENTITY_TICKMON);
+		}
+	}
+	TickMon_RefPosition = position;
+	TickMon_RefValid = 1;
+}
+
+
+/**
+ * @brief Copies the tick latency statistics.
+ */
+void TickMon_GetStats(TickMon_StatsType *Stats) {
+	uint8 sreg;
+	uint8 bin;
+
+	CRITSEC_ENTER(CRITSEC_SITE_TICKMON_STATS, sreg);
+	Stats->MaxUs = (uint16)(TickMon_MaxCounts * TICKMON_COUNT_US);
+	Stats->Late = TickMon_Late;
+	Stats->Lost = TickMon_Lost;
+	for (bin = 0; bin < TICKMON_BINS; bin++) {
+		WCET_LOOP_BOUND(TICKMON_BINS);
+		Stats->Histogram[bin] = TickMon_Histogram[bin];
+	}
+	CRITSEC_EXIT(CRITSEC_SITE_TICKMON_STATS, sreg);
+}
+
+
+/**
+ * @brief Clears the tick latency statistics.
+ */
+void TickMon_ResetStats(void) {
+	uint8 sreg;
+	uint8 bin;
+
+	CRITSEC_ENTER(CRITSEC_SITE_TICKMON_STATS, sreg);
+	TickMon_MaxCounts = 0;
+	TickMon_Late = 0;
+	TickMon_Lost = 0;
+	for (bin = 0; bin < TICKMON_BINS; bin++) {
+		WCET_LOOP_BOUND(TICKMON_BINS);
+		TickMon_Histogram[bin] = 0;
+	}
+	CRITSEC_EXIT(CRITSEC_SITE_TICKMON_STATS, sreg);
+}
@@ -0,0 +1,64 @@
+/*
+ * TickMon.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef TICKMON_H_
+#define TICKMON_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include "Std_types.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * Latency of the 1ms tick (compare match to TCNT2 read in ISR(TIMER2_COMPA_vect)) at or
+ * above which the tick is late and WDGM_ENTITY_TICKMON fails. Interrupts do not nest: it is
+ * the worst latency the cycle budgets of the other handlers and of the critical sections
+ * allow (541us, "latency" line of tools/wcet_budget.txt, checked by make wcet), rounded up
+ * to a TCNT2 count. A longer delay comes from code over its budget.
+ */
+#define TICKMON_LATENCY_BOUND_US	544
+
+// Latency histogram: TICKMON_BINS bins of TICKMON_BIN_US over one tick period
+#define TICKMON_BINS				8
+#define TICKMON_BIN_US				128
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Tick latency since TickMon_Init / TickMon_ResetStats. The latency includes the
+ * interrupt response and the ISR prologue (one or two TCNT2 counts of 32us on the MCU).
+ */
+typedef struct {
+	uint16 MaxUs;							/* Largest latency, 32us resolution            */
+	uint16 Late;							/* Ticks at or above TICKMON_LATENCY_BOUND_US  */
+	uint16 Lost;							/* Ticks never served (Timer1 cross-check)     */
+	uint32 Histogram[TICKMON_BINS];			/* Ticks per TICKMON_BIN_US of latency          */
+} TickMon_StatsType;
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void TickMon_Init(void);
+void TickMon_TickNotification(uint8 Counts);
+void TickMon_RefNotification(void);
+void TickMon_GetStats(TickMon_StatsType *Stats);
+void TickMon_ResetStats(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* TICKMON_H_ */
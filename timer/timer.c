@@ -6,8 +6,13 @@
  */
 
 #include "timer.h"
+#include "Boot.h"
+#include "FaultInj.h"
+#include "CritSec.h"
+#include "TickMon.h"
 
-vsint32_t millis = 0;
+volatile uint32 millis = 0;	// 32 bits: vsint32_t is an int (16 bits on AVR) and wrapped after 32.7s
+volatile uint16 timer1Wraps = 0;	// Number of Timer1 compare matches (counter restarts)
 
 
 /**
@@ -16,11 +21,23 @@ vsint32_t millis = 0;
  * This function sets up Timer1 and Timer2 for CTC (Clear Timer on Compare Match) mode.
  * Timer1 is configured to trigger an interrupt every ~52.2ms and Timer2 is configured
  * to trigger an interrupt every 1ms. The global interrupts are also enabled at the end
- * of this function.
+ * of this function, except in fast-boot mode (BOOT_FAST_MODE) where every register is
+ * written once and main() enables the interrupts after all the init functions.
  *
  * @return None
  */
 void timers_init() {
+#if (BOOT_FAST_MODE == 1)
+	// Timer1 was left stopped and cleared by Boot_ReleaseTimer, Timer2 is in its reset state
+	OCR1A = TIMER1_COMPARE_VALUE;
+	TIMSK1 = (1 << OCIE1A);
+	TCCR1B = (1 << WGM12) | (1 << CS11) | (1 << CS10);		// CTC, prescaler = 64
+
+	TCCR2A = (1 << WGM21);									// CTC
+	OCR2A = TIMER2_COMPARE_VALUE;
+	TIMSK2 = (1 << OCIE2A);
+	TCCR2B = (1 << CS21) | (1 << CS20);						// Prescaler = 32
+#else
 	/**
 	 * TIMER1A initialization
 	 */
@@ -35,7 +52,7 @@ void timers_init() {
      * For 52.2 ms interrupt: OCR1A = (0.0522 * 1000000 / 64) - 1 = ~815
      * we choose ~52ms not 50ms to avoid the sharp edge of the reseting time
      * */
-    OCR1A = 815; // output compare registers
+    OCR1A = TIMER1_COMPARE_VALUE; // output compare registers
 
     // Enable Timer1 compare interrupt A
     TIMSK1 |= (1 << OCIE1A);
@@ -57,7 +74,7 @@ void timers_init() {
 	 * For 1 ms interrupt: OCR2A = ((0.001 * 1000000 / 64) + 1) = 15.7 * 2 = 31.4 ~ 31
 	 *
 	 */
-	OCR2A = 31; // output compare registers
+	OCR2A = TIMER2_COMPARE_VALUE; // output compare registers
 
 	// Enable Timer2 compare interrupt A
 	TIMSK2 |= (1 << OCIE2A);
@@ -66,6 +83,7 @@ void timers_init() {
 	TCCR2B |= (1 << CS21) | (1 << CS20);  // Prescaler = 64
     // Enable global interrupts
     enable_global_interrupt();
+#endif
 }
 
 
@@ -74,16 +92,19 @@ void timers_init() {
  *
  * This function retrieves the value of the `millis` variable, which is incremented
  * by the Timer2 compare match interrupt. It temporarily disables global interrupts
- * to ensure a consistent read of the `millis` variable.
+ * to ensure a consistent read of the `millis` variable and restores SREG afterwards,
+ * so it does not enable the interrupts when called during (fast) boot.
  *
  * @return The number of milliseconds since the program started.
  */
 uint32_t HAL_GetTick() {
     uint32_t MilliSeconds;
-    disable_global_interrupt();  // Disable global interrupts
+    uint8 sreg;
+
+    CRITSEC_ENTER(CRITSEC_SITE_HAL_GETTICK, sreg);
     // Store the millis that incremented by the ISR(TIMER2_COMPA_vect)
     MilliSeconds = millis;
-    enable_global_interrupt();  // Enable global interrupts
+    CRITSEC_EXIT(CRITSEC_SITE_HAL_GETTICK, sreg);  // Restore the global interrupt flag
     return MilliSeconds;
 }
 
@@ -92,14 +113,21 @@ uint32_t HAL_GetTick() {
  * @brief Timer1 compare match interrupt service routine.
  *
  * This ISR is called when Timer1 reaches the compare match value.
- * It calls the watchdog driver ISR notification function.
+ * It counts the counter restarts (used to extend input capture timestamps),
+ * checks the 1ms ticks of the period against Timer1 (TickMon) and calls the
+ * watchdog driver ISR notification function.
  *
  * @return None
  */
 ISR(TIMER1_COMPA_vect) {
-	GPIO_Write(TIMER50MS_LED, HIGH);
+	FAULTINJ_POINT(FAULTINJ_POINT_TIMER1_ISR);
+
+	GPIO_WRITE_CONST(TIMER50MS_LED, HIGH);
+	timer1Wraps++;
+	FAULTINJ_CORRUPT(FAULTINJ_POINT_TIMER1_ISR, timer1Wraps);
+	TickMon_RefNotification();
     WDGDrv_IsrNotification();  // Call ISR function of WDG every ~50 ms
-    GPIO_Write(TIMER50MS_LED, LOW);
+    GPIO_WRITE_CONST(TIMER50MS_LED, LOW);
 }
 
 
@@ -108,11 +136,19 @@ ISR(TIMER1_COMPA_vect) {
  *
  * This ISR is called when Timer2 reaches the compare match value.
  * It increments the `millis` variable every 1ms to keep track of time.
+ * TCNT2 is read first: it counts from 0 again since the compare match, its
+ * value is the latency of the tick (TickMon).
  *
  * @return None
  */
 ISR(TIMER2_COMPA_vect) {
-	GPIO_Write(TIMER1MS_LED, HIGH);
+	uint8 latency = TCNT2;
+
+	FAULTINJ_POINT(FAULTINJ_POINT_TIMER2_ISR);
+
+	GPIO_WRITE_CONST(TIMER1MS_LED, HIGH);
 	millis++;  // Increment millis
-	GPIO_Write(TIMER1MS_LED, LOW);
+	FAULTINJ_CORRUPT(FAULTINJ_POINT_TIMER2_ISR, millis);
+	TickMon_TickNotification(latency);
+	GPIO_WRITE_CONST(TIMER1MS_LED, LOW);
 }
@@ -20,21 +20,22 @@
  ******************************   includes End      ****************************
  *******************************************************************************/
 
-#define TCCR1B   (*(volatile uint8 *)0x81)
-#define TIMSK1   (*(volatile uint8 *)0x6F)
+// Timer1 runs in CTC mode: one compare match (and WDG refresh) every (TOP + 1) ticks
+#define TIMER1_PRESCALER		64
+#define TIMER1_COMPARE_VALUE	815
 
-#define TCCR2A   (*(volatile uint8 *)0xB0)
-#define TCCR2B   (*(volatile uint8 *)0xB1)
-
-
-#define OCR2A    (*(volatile uint8 *)0xB3)
-#define TIMSK2   (*(volatile uint8 *)0x70)
+// Timer2 runs in CTC mode and drives millis: one tick every TIMER2_PERIOD_US (1024us)
+// CS21|CS20 selects clk/32 on Timer2 (its prescaler table differs from Timer0/1)
+#define TIMER2_PRESCALER		32
+#define TIMER2_COMPARE_VALUE	31
+#define TIMER2_PERIOD_US		((((TIMER2_COMPARE_VALUE) + 1UL) * (TIMER2_PRESCALER) * 1000UL) / (F_CPU / 1000UL))
 
 
 /*******************************************************************************
  *************************   Global variables Start      ***********************
  *******************************************************************************/
-extern vsint32_t millis;
+extern volatile uint32 millis;
+extern volatile uint16 timer1Wraps;
 /*******************************************************************************
  *************************   Global variables end      ***********************
  *******************************************************************************/
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+build_report.py
+
+Size/cycle report of the optimization variants built by `make matrix`.
+
+Every variant directory holds Final_WDG_AVR.elf (sizes from avr-size -A), flags.txt (the
+variant flags) and, when the benchmark was run, bench.log with "BENCH <name> <cycles>"
+lines (simavr output or a capture of the MCU serial port). The first variant is the
+reference of the deltas.
+
+usage: build_report.py [--size avr-size] [--out report.md] <variant dir>...
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+ELF = 'Final_WDG_AVR.elf'
+BENCH_LINE = re.compile(r'BENCH\s+(\S+)\s+(\d+)')
+
+FLASH_SECTIONS = ('.text', '.data')
+RAM_SECTIONS = ('.data', '.bss', '.noinit')
+
+
+def read_sections(elf, size_tool):
+    out = subprocess.run([size_tool, '-A', elf], check=True, capture_output=True, text=True).stdout
+    sections = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) >= 2 and fields[0].startswith('.') and fields[1].isdigit():
+            sections[fields[0]] = int(fields[1])
+    return sections
+
+
+def read_bench(path):
+    cycles = {}
+    if os.path.exists(path):
+        with open(path, errors='replace') as f:
+            for match in BENCH_LINE.finditer(f.read()):
+                cycles[match.group(1)] = int(match.group(2))
+    return cycles
+
+
+def read_flags(path):
+    if os.path.exists(path):
+        with open(path) as f:
+            return f.read().strip()
+    return '?'
+
+
+def delta(value, reference):
+    if reference is None or value is None:
+        return ''
+    diff = value - reference
+    return ' (%+d)' % diff if diff else ''
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('variants', nargs='+')
+    parser.add_argument('--size', default='avr-size')
+    parser.add_argument('--out')
+    args = parser.parse_args()
+
+    rows = []
+    for directory in args.variants:
+        name = os.path.basename(os.path.normpath(directory))
+        elf = os.path.join(directory, ELF)
+        if not os.path.exists(elf):
+            print('%s: %s missing, variant skipped' % (name, elf), file=sys.stderr)
+            continue
+        sections = read_sections(elf, args.size)
+        rows.append({
+            'name': name,
+            'flags': read_flags(os.path.join(directory, 'flags.txt')),
+            'flash': sum(sections.get(s, 0) for s in FLASH_SECTIONS),
+            'ram': sum(sections.get(s, 0) for s in RAM_SECTIONS),
+            'cycles': read_bench(os.path.join(directory, 'bench.log')),
+        })
+    if not rows:
+        print('no variant built', file=sys.stderr)
+        return 1
+
+    reference = rows[0]
+    lines = ['# Build variants', '',
+             '| Variant | Flags | Flash (bytes) | RAM (bytes) |',
+             '|---|---|---:|---:|']
+    for row in rows:
+        lines.append('| %s | `%s` | %d%s | %d%s |' % (
+            row['name'], row['flags'],
+            row['flash'], delta(row['flash'], reference['flash']),
+            row['ram'], delta(row['ram'], reference['ram'])))
+
+    benchmarks = []
+    for row in rows:
+        for name in row['cycles']:
+            if name not in benchmarks:
+                benchmarks.append(name)
+    lines += ['', '## CPU cycles (worst of the benchmark runs)', '']
+    if benchmarks:
+        lines.append('| Function | ' + ' | '.join(row['name'] for row in rows) + ' |')
+        lines.append('|---|' + '---:|' * len(rows))
+        for name in benchmarks:
+            ref = reference['cycles'].get(name)
+            cells = []
+            for row in rows:
+                value = row['cycles'].get(name)
+                cells.append('-' if value is None else '%d%s' % (value, delta(value, ref)))
+            lines.append('| %s | %s |' % (name, ' | '.join(cells)))
+    else:
+        lines.append('No bench.log found (simavr not installed and no capture from the MCU).')
+
+    report = '\n'.join(lines) + '\n'
+    if args.out:
+        with open(args.out, 'w') as f:
+            f.write(report)
+    sys.stdout.write(report)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+flash_crc.py
+
+Post-link step of the flash integrity check (flash_crc/FlashCrc.c).
+
+Computes the CRC-16/CCITT-FALSE of the application image [0, __data_load_end)
+without the two bytes of FlashCrc_Expected and writes it into FlashCrc_Expected
+in the ELF file (little endian, as read by pgm_read_word). The .hex is generated
+from the patched ELF afterwards, so the ELF (avrdude, debugWIRE, simavr) and the
+.hex hold the same image.
+
+The image is read from the loadable segments of the ELF at their load (flash)
+addresses, as avr-objcopy -O ihex writes them: .text and the initializers of .data.
+
+usage: flash_crc.py <image.elf> [--nm avr-nm]
+"""
+
+import argparse
+import struct
+import subprocess
+import sys
+
+FLASH_END = 0x800000            # Data memory (0x800000) and EEPROM (0x810000) are not flash
+PT_LOAD = 1
+
+
+def crc16_ccitt_false(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def read_symbols(elf, nm):
+    out = subprocess.run([nm, elf], check=True, capture_output=True, text=True).stdout
+    symbols = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 3:
+            symbols[fields[2]] = int(fields[0], 16)
+    return symbols
+
+
+def read_segments(path):
+    """[(file offset, load address, size)] of the flash part of the loadable segments."""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4] != 1 or elf[5] != 1:
+        raise SystemExit('%s: not a 32-bit little-endian ELF file' % path)
+    phoff, = struct.unpack_from('<I', elf, 28)
+    phentsize, phnum = struct.unpack_from('<HH', elf, 42)
+    segments = []
+    for i in range(phnum):
+        ptype, offset, _, paddr, filesz = struct.unpack_from('<IIIII', elf, phoff + i * phentsize)
+        if ptype == PT_LOAD and filesz and paddr < FLASH_END:
+            segments.append((offset, paddr, filesz))
+    return elf, segments
+
+
+def read_image(elf, segments):
+    image = {}
+    for offset, address, size in segments:
+        for i in range(size):
+            image[address + i] = elf[offset + i]
+    return image
+
+
+def file_offset(segments, address):
+    for offset, start, size in segments:
+        if start <= address and address + 2 <= start + size:
+            return offset + address - start
+    raise SystemExit('FlashCrc_Expected (0x%04X) is not in a loadable segment' % address)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('elf')
+    parser.add_argument('--nm', default='avr-nm')
+    args = parser.parse_args()
+
+    symbols = read_symbols(args.elf, args.nm)
+    end = symbols['__data_load_end']
+    crc_address = symbols['FlashCrc_Expected']
+    elf, segments = read_segments(args.elf)
+    image = read_image(elf, segments)
+
+    data = bytes(image.get(a, 0xFF) for a in range(end) if a not in (crc_address, crc_address + 1))
+    crc = crc16_ccitt_false(data)
+    offset = file_offset(segments, crc_address)
+    with open(args.elf, 'r+b') as f:
+        f.seek(offset)
+        f.write(struct.pack('<H', crc))
+    print('flash_crc: [0x0000, 0x%04X) CRC 0x%04X written at 0x%04X' % (end, crc, crc_address))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""
+size_budget.py
+
+Per-module flash/RAM report of the firmware and budget gate.
+
+The linker map (-Wl,-Map) lists every input section kept in the image with its size and
+object file. Each section is attributed to the module directory of its object (gpio,
+timer, WDG_drv, WDGMrh, ...), archive members to their library (libgcc, libc) and the
+C runtime to "toolchain". Sizes are split by output section:
+
+  flash = .text + .data (initializers are stored in flash)
+  ram   = .data + .bss + .noinit
+
+The budget file holds one "<module> <flash> <ram>" line per module ("-" for no limit) and
+an optional "total" line. The script exits with status 1 when a budget is exceeded, so the
+build fails on the first byte of growth past a budget instead of at link time.
+
+usage: size_budget.py [--budget size_budget.txt] [--out report.md] [--top 15] <map>
+"""
+
+import argparse
+import os
+import re
+import sys
+
+COUNTED = ('.text', '.data', '.bss', '.noinit')
+FLASH = ('.text', '.data')
+RAM = ('.data', '.bss', '.noinit')
+
+OUTPUT_SECTION = re.compile(r'^(\.\S+)(?:\s+0x[0-9a-fA-F]+\s+0x[0-9a-fA-F]+.*)?$')
+INPUT_SECTION = re.compile(r'^ (\.\S+|COMMON)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+))?$')
+CONTINUATION = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(.+)$')
+SYMBOL = re.compile(r'^\s+0x[0-9a-fA-F]+\s+([A-Za-z_][\w.$]*)$')
+SECTION_PREFIX = re.compile(r'^\.(?:text|data|bss|noinit|rodata|progmem\.data|progmem)\.')
+
+
+def module_of(path):
+    """Module directory of an object file, library of an archive member."""
+    path = path.strip().replace('\\', '/')
+    archive = re.match(r'^(.*?)([^/]+)\.a\(.*\)$', path)
+    if archive:
+        return archive.group(2)
+    if path == 'linker stubs' or os.path.isabs(path) or re.match(r'^[A-Za-z]:/', path):
+        return 'toolchain'
+    return os.path.basename(os.path.dirname(os.path.normpath(path))) or 'toolchain'
+
+
+def parse_map(path):
+    """[(output section, input section, size, module, symbols)] of the kept sections."""
+    sections = []
+    with open(path, errors='replace') as f:
+        lines = f.read().splitlines()
+    try:
+        start = next(i for i, line in enumerate(lines) if line.startswith('Linker script and memory map'))
+    except StopIteration:
+        raise SystemExit('%s: not a GNU ld map file' % path)
+
+    output = None
+    pending = None              # Input section name waiting for its address line
+    current = None              # Last input section, collects the symbols
+    for line in lines[start + 1:]:
+        if not line.strip():
+            continue
+        if not line[0].isspace():
+            match = OUTPUT_SECTION.match(line)
+            output = match.group(1) if match else None
+            pending = current = None
+            continue
+        if output not in COUNTED:
+            continue
+        match = INPUT_SECTION.match(line)
+        if match:
+            current = None
+            if match.group(2) is None:
+                pending = match.group(1)
+            else:
+                pending = None
+                current = [output, match.group(1), int(match.group(3), 16), module_of(match.group(4)), []]
+                sections.append(current)
+            continue
+        match = CONTINUATION.match(line)
+        if pending and match:
+            current = [output, pending, int(match.group(2), 16), module_of(match.group(3)), []]
+            sections.append(current)
+            pending = None
+            continue
+        match = SYMBOL.match(line)
+        if current and match:
+            current[4].append(match.group(1))
+    return sections
+
+
+def symbol_name(section):
+    _, name, _, module, symbols = section
+    if SECTION_PREFIX.match(name):
+        return SECTION_PREFIX.sub('', name)
+    if len(symbols) == 1:
+        return symbols[0]
+    if symbols:
+        return '%s (+%d)' % (symbols[0], len(symbols) - 1)
+    return '%s(%s)' % (name, module)
+
+
+def read_budget(path):
+    budget = {}
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            if len(fields) != 3:
+                raise SystemExit('%s:%d: expected "<module> <flash> <ram>"' % (path, number))
+            budget[fields[0]] = tuple(None if v == '-' else int(v, 0) for v in fields[1:])
+    return budget
+
+
+def check(used, limit):
+    if limit is None:
+        return '', True
+    return ('%d' % limit, used <= limit)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('map')
+    parser.add_argument('--budget')
+    parser.add_argument('--out')
+    parser.add_argument('--top', type=int, default=15)
+    args = parser.parse_args()
+
+    sections = parse_map(args.map)
+    budget = read_budget(args.budget) if args.budget else {}
+
+    modules = {}
+    for output, _, size, module, _ in sections:
+        modules.setdefault(module, dict.fromkeys(COUNTED, 0))[output] += size
+
+    lines = ['# Flash/RAM per module: %s' % args.map, '',
+             '| Module | .text | .data | .bss | .noinit | flash | budget | ram | budget | |',
+             '|---|---|---|---|---|---|---|---|---|---|']
+    failures = []
+    totals = dict.fromkeys(COUNTED, 0)
+
+    def row(name, sizes):
+        flash = sum(sizes[s] for s in FLASH)
+        ram = sum(sizes[s] for s in RAM)
+        flash_limit, ram_limit = budget.get(name, (None, None))
+        flash_text, flash_ok = check(flash, flash_limit)
+        ram_text, ram_ok = check(ram, ram_limit)
+        status = 'ok' if name in budget else 'no budget'
+        if not flash_ok:
+            failures.append('%s: flash %d > %d' % (name, flash, flash_limit))
+            status = 'OVER'
+        if not ram_ok:
+            failures.append('%s: ram %d > %d' % (name, ram, ram_limit))
+            status = 'OVER'
+        lines.append('| %s | %d | %d | %d | %d | %d | %s | %d | %s | %s |' % (
+            name, sizes['.text'], sizes['.data'], sizes['.bss'], sizes['.noinit'],
+            flash, flash_text, ram, ram_text, status))
+
+    for name in sorted(modules, key=str.lower):
+        row(name, modules[name])
+        for s in COUNTED:
+            totals[s] += modules[name][s]
+    row('total', totals)
+
+    lines += ['', '## Largest symbols', '', '| Symbol | Section | Module | Bytes |', '|---|---|---|---|']
+    for section in sorted(sections, key=lambda s: -s[2])[:args.top]:
+        if section[2]:
+            lines.append('| %s | %s | %s | %d |' % (symbol_name(section), section[0], section[3], section[2]))
+    if failures:
+        lines += ['', '## Budget exceeded', ''] + ['- ' + failure for failure in failures]
+
+    report = '\n'.join(lines) + '\n'
+    if args.out:
+        with open(args.out, 'w') as f:
+            f.write(report)
+    sys.stdout.write(report)
+    if failures:
+        print('size budget exceeded: ' + ', '.join(failures), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,689 @@
+#!/usr/bin/env python3
+"""
+wcet_stack.py
+
+Static worst-case execution time and stack depth of the interrupt handlers and tasks.
+
+The disassembly (.lss from avr-objdump -h -S, or an ELF disassembled with avr-objdump -d)
+is split into functions from their entry addresses. Each function gets a control flow
+graph with the ATmega328P instruction timings on its edges (branch taken / not taken,
+skip over one or two words); a call edge costs the call plus the bound of the callee, so
+the bound of an entry covers its whole call tree. Loops are the natural loops of the back
+edges: every loop needs an iteration bound, it costs bound * (longest iteration) + (longest
+path from its header to its exit). The result is a safe upper bound for any input, not a
+measured sample.
+
+Loops of the sources carry their bound in the image: WCET_LOOP_BOUND(n) (Std_types.h)
+emits the local label __wcet_loop_<id>_<n> in the loop body, the bound belongs to the
+innermost loop holding the label (the largest one when several labels end up in one loop,
+e.g. after unrolling). The label moves with the loop when it is inlined or cloned. The
+other loops (variable shifts and block copies generated by the compiler, avr-libc inline
+assembly, libgcc) take their bounds from the "loop" line of the function, one per loop
+without label in address order: a different number of bounds is an error, no bound is
+reused.
+
+Stack depth follows push/pop, the return addresses of call/rcall/icall ("rcall .+0"
+reserves two bytes), the frames allocated through SP (in r28,SPL; sbiw r28,N; out SPL,r28)
+and the callees. An interrupt costs 7 cycles before its first instruction (response and
+vector jmp) and 2 bytes of return address.
+
+The budget file holds:
+
+  isr   <vector|function> <cycles> <stack>   interrupt handler, e.g. TIMER1_COMPA_vect
+  task  <function> <cycles> <stack>          function called from the super loop
+  main  main - <stack>                       main call tree + deepest interrupt handler
+  loop  <function> <bound>...                iteration bounds of the loops without
+                                             WCET_LOOP_BOUND label, in header address order
+  icall <function> <target>...|none          targets of the indirect calls
+  latency <vector> <cycles> <cycles>        latency bound of the vector (request to its
+                                             TCNT2 read), bound of the critical sections
+  exempt <vector>...                         handlers left out of the latency (reset follows)
+  critsec <function>...                      functions of main outside the tasks whose
+                                             critical sections count
+
+A critical section runs from a cli to the out to SREG (or sei) that closes it; the sections
+of the tasks and of the "critsec" functions, with their whole call trees, are bounded like
+the functions. The latency of the vector is its response and prologue + the longest
+critical section or lower priority handler + every higher priority handler once, all of
+them from the budgets: with "latency", every handler of the image needs a cycle budget.
+
+"-" is no limit. Recursion, unbounded loops, indirect jumps and icall without targets
+are errors: the bound would not be guaranteed. The script exits with status 1 on an error
+or an exceeded budget, unless --report-only is given (variants the budgets are not made
+for).
+
+usage: wcet_stack.py [--budget wcet_budget.txt] [--out report.md] [--f-cpu 1000000]
+                     [--objdump avr-objdump] [--report-only] <lss|elf>
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+# ATmega328P vector numbers (avr-libc names without _vect)
+VECTORS = {
+    'INT0': 1, 'INT1': 2, 'PCINT0': 3, 'PCINT1': 4, 'PCINT2': 5, 'WDT': 6,
+    'TIMER2_COMPA': 7, 'TIMER2_COMPB': 8, 'TIMER2_OVF': 9, 'TIMER1_CAPT': 10,
+    'TIMER1_COMPA': 11, 'TIMER1_COMPB': 12, 'TIMER1_OVF': 13, 'TIMER0_COMPA': 14,
+    'TIMER0_COMPB': 15, 'TIMER0_OVF': 16, 'SPI_STC': 17, 'USART_RX': 18, 'USART_UDRE': 19,
+    'USART_TX': 20, 'ADC': 21, 'EE_READY': 22, 'ANALOG_COMP': 23, 'TWI': 24, 'SPM_READY': 25,
+}
+
+# Cycles of the instructions that do not take 1 (datasheet instruction set summary)
+CYCLES = {
+    'adiw': 2, 'sbiw': 2, 'mul': 2, 'muls': 2, 'mulsu': 2, 'fmul': 2, 'fmuls': 2, 'fmulsu': 2,
+    'ld': 2, 'ldd': 2, 'lds': 2, 'st': 2, 'std': 2, 'sts': 2, 'push': 2, 'pop': 2,
+    'cbi': 2, 'sbi': 2, 'lpm': 3, 'elpm': 3, 'rjmp': 2, 'ijmp': 2, 'jmp': 3,
+    'rcall': 3, 'icall': 3, 'call': 4, 'ret': 4, 'reti': 4,
+}
+SKIPS = ('cpse', 'sbrc', 'sbrs', 'sbic', 'sbis')
+RETURNS = ('ret', 'reti')
+INTERRUPT_RESPONSE = 4 + 3          # Push PC + vector jmp
+RETURN_ADDRESS = 2                  # 16-bit PC
+SPL, SPH, SREG = '0x3d', '0x3e', '0x3f'
+TCNT2 = 0xb2                        # Data address (lds)
+MAX_SECTION_DEPTH = 4
+
+LABEL = re.compile(r'^([0-9a-fA-F]{8}) <([^>]+)>:\s*$')
+MARKER = re.compile(r'^__wcet_loop_\d+_(\d+)$')
+INSN = re.compile(r'^\s*([0-9a-fA-F]+):\t((?:[0-9a-fA-F]{2} )+)\s*\t(\S+)\s*([^;]*?)\s*(?:;\s*(.*))?$')
+COMMENT_TARGET = re.compile(r'0x([0-9a-fA-F]+)')
+
+
+class AnalysisError(Exception):
+    pass
+
+
+class Insn:
+    __slots__ = ('addr', 'size', 'op', 'args', 'target')
+
+    def __init__(self, addr, size, op, args, target):
+        self.addr, self.size, self.op, self.args, self.target = addr, size, op, args, target
+
+
+def read_disassembly(path, objdump):
+    if path.endswith('.elf'):
+        return subprocess.run([objdump, '-d', path], check=True, capture_output=True, text=True).stdout
+    with open(path, errors='replace') as f:
+        return f.read()
+
+
+def parse(text):
+    """Instructions by address, labels and WCET_LOOP_BOUND markers of the .text section."""
+    insns, labels, markers = {}, {}, []
+    in_text = False
+    for line in text.splitlines():
+        if line.startswith('Disassembly of section'):
+            in_text = line.rstrip().endswith('.text:')
+            continue
+        if not in_text:
+            continue
+        match = LABEL.match(line)
+        if match:
+            marker = MARKER.match(match.group(2))
+            if marker:
+                markers.append((int(match.group(1), 16), int(marker.group(1))))
+            else:
+                labels.setdefault(match.group(2), int(match.group(1), 16))
+            continue
+        match = INSN.match(line)
+        if not match:
+            continue
+        addr = int(match.group(1), 16)
+        op = match.group(3)
+        args = [a.strip() for a in match.group(4).split(',')] if match.group(4) else []
+        target = None
+        if op in ('call', 'jmp', 'rcall', 'rjmp') or op.startswith('br'):
+            found = COMMENT_TARGET.search(match.group(5) or '') or COMMENT_TARGET.search(match.group(4))
+            target = int(found.group(1), 16) if found else (int(args[0], 0) if args else None)
+        insns[addr] = Insn(addr, len(match.group(2).split()), op, args, target)
+    if not insns:
+        raise SystemExit('no .text disassembly found')
+    return insns, labels, markers
+
+
+def read_budget(path):
+    entries, loops, icalls, latency = [], {}, {}, {'bound': None, 'exempt': [], 'critsec': []}
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            kind = fields[0]
+            if kind in ('isr', 'task', 'main') and len(fields) == 4:
+                limits = [None if v == '-' else int(v, 0) for v in fields[2:]]
+                entries.append((kind, fields[1], limits[0], limits[1]))
+            elif kind == 'loop' and len(fields) >= 3:
+                loops[fields[1]] = [int(v, 0) for v in fields[2:]]
+            elif kind == 'icall' and len(fields) >= 3:
+                icalls[fields[1]] = [] if fields[2:] == ['none'] else fields[2:]
+            elif kind == 'latency' and len(fields) == 4:
+                latency['bound'] = (fields[1], int(fields[2], 0), int(fields[3], 0))
+            elif kind in ('exempt', 'critsec') and len(fields) >= 2:
+                latency[kind] += fields[1:]
+            else:
+                raise SystemExit('%s:%d: unknown or incomplete line' % (path, number))
+    return entries, loops, icalls, latency
+
+
+def symbol_of(name):
+    """__vector_N of an avr-libc vector name, the name otherwise."""
+    vector = name[:-5] if name.endswith('_vect') else None
+    if vector in VECTORS:
+        return '__vector_%d' % VECTORS[vector]
+    return name
+
+
+class Program:
+    def __init__(self, insns, labels, markers, loops, icalls):
+        self.insns = insns
+        self.labels = labels
+        self.markers = markers
+        self.names = {}
+        for name, addr in labels.items():
+            # Prefer the global name over local labels at the same address
+            if addr not in self.names or self.names[addr].startswith('.'):
+                self.names[addr] = name
+        self.loops = {symbol_of(k): v for k, v in loops.items()}
+        self.icalls = {symbol_of(k): [symbol_of(t) for t in v] for k, v in icalls.items()}
+        self.entries = {i.target for i in insns.values() if i.op in ('call', 'rcall') and
+                        i.target is not None and i.target != i.addr + i.size}
+        self.entries |= {a for n, a in labels.items() if n.startswith('__vector_')}
+        self.loops_used = set()
+        self.wcet_memo, self.stack_memo = {}, {}
+        self.sections = {}
+        self.callees = {}
+        self.active = []
+
+    def name(self, addr):
+        return self.names.get(addr, '0x%x' % addr)
+
+    def address(self, name):
+        if name not in self.labels:
+            raise AnalysisError('%s: not in the image' % name)
+        return self.labels[name]
+
+    def next_addr(self, insn):
+        return insn.addr + insn.size
+
+    def is_tail_call(self, insn, entry):
+        return insn.op in ('jmp', 'rjmp') and insn.target in self.entries and insn.target != entry
+
+    def calls(self, insn, func):
+        """Callees of a call instruction (rcall .+0 is a stack reservation)."""
+        if insn.op in ('call', 'rcall'):
+            return [] if insn.target == self.next_addr(insn) else [insn.target]
+        if insn.op in ('icall', 'eicall'):
+            if func not in self.icalls:
+                raise AnalysisError('%s: indirect call at 0x%x without targets (add "icall %s <target>...")'
+                                    % (func, insn.addr, func))
+            return [self.address(t) for t in self.icalls[func]]
+        return []
+
+    def successors(self, insn, entry):
+        """[(next address or None for the return, cycles of the transition)]"""
+        op, cycles = insn.op, CYCLES.get(insn.op, 1)
+        nxt = self.next_addr(insn)
+        if op in RETURNS:
+            return [(None, cycles)]
+        if op in ('jmp', 'rjmp'):
+            if insn.target is None:
+                raise AnalysisError('%s: jump without target at 0x%x' % (self.name(entry), insn.addr))
+            return [(None if self.is_tail_call(insn, entry) else insn.target, cycles)]
+        if op in ('ijmp', 'eijmp'):
+            raise AnalysisError('%s: indirect jump at 0x%x' % (self.name(entry), insn.addr))
+        if op.startswith('br') and op != 'break':
+            return [(nxt, 1), (insn.target, 2)]
+        if op in SKIPS:
+            skipped = self.insns.get(nxt)
+            if skipped is None:
+                raise AnalysisError('%s: skip at the end of the code at 0x%x' % (self.name(entry), insn.addr))
+            return [(nxt, 1), (self.next_addr(skipped), 1 + skipped.size // 2)]
+        return [(nxt, cycles)]
+
+    def body(self, entry):
+        """Reachable instructions of the function starting at entry."""
+        seen, work = set(), [entry]
+        while work:
+            addr = work.pop()
+            if addr in seen:
+                continue
+            if addr not in self.insns:
+                raise AnalysisError('%s: no instruction at 0x%x' % (self.name(entry), addr))
+            seen.add(addr)
+            for nxt, _ in self.successors(self.insns[addr], entry):
+                if nxt is not None:
+                    work.append(nxt)
+        return seen
+
+    def enter(self, entry):
+        name = self.name(entry)
+        if entry in self.active:
+            chain = [self.name(a) for a in self.active[self.active.index(entry):]] + [name]
+            raise AnalysisError('recursion: ' + ' -> '.join(chain))
+        self.active.append(entry)
+
+    # Worst-case execution time ----------------------------------------------------------
+    def wcet(self, entry):
+        if entry in self.wcet_memo:
+            return self.wcet_memo[entry]
+        self.enter(entry)
+        try:
+            cycles = self.function_wcet(entry)
+        finally:
+            self.active.pop()
+        self.wcet_memo[entry] = cycles
+        return cycles
+
+    def edge_cost(self, insn, cycles, entry, func):
+        cost = cycles
+        callees = self.calls(insn, func)
+        if callees:
+            cost += max(self.wcet(c) for c in callees)
+        if insn.op in ('jmp', 'rjmp') and self.is_tail_call(insn, entry):
+            cost += self.wcet(insn.target)
+        return cost
+
+    def function_wcet(self, entry):
+        func = self.name(entry)
+        nodes = self.body(entry)
+        self.callees[entry] = sorted({c for a in nodes for c in self.calls(self.insns[a], func)} |
+                                     {self.insns[a].target for a in nodes if self.is_tail_call(self.insns[a], entry)})
+        EXIT = -1
+        succ = {a: [] for a in nodes}
+        for a in nodes:
+            insn = self.insns[a]
+            for nxt, cycles in self.successors(insn, entry):
+                succ[a].append((EXIT if nxt is None else nxt, self.edge_cost(insn, cycles, entry, func)))
+        succ[EXIT] = []
+
+        loops = self.natural_loops(entry, succ)
+        bound_of = self.loop_bounds(func, loops)
+        self.sections[entry] = [(a, self.section_wcet(func, a, succ, loops, bound_of))
+                                for a in sorted(nodes) if self.insns[a].op == 'cli']
+        longest = self.longest_collapsed(func, entry, succ, natural=loops, bound_of=bound_of)
+        if EXIT not in longest:
+            raise AnalysisError('%s: never returns' % func)
+        return longest[EXIT]
+
+    def longest_collapsed(self, func, start, succ, natural, bound_of):
+        """Longest distance from start once every loop is collapsed into one node (succ changes)."""
+        loops = natural
+        headers = list(loops)
+
+        # Collapse the loops, innermost first, into one node each
+        rep = {a: a for a in succ}
+        for header in sorted(headers, key=lambda h: len(loops[h])):
+            body = {rep[a] for a in loops[header]}
+            h = rep[header]
+            where = header[0] if isinstance(header, tuple) else header
+            inner = {u: [(v, c) for v, c in succ[u] if v in body and v != h] for u in body}
+            longest = self.longest_paths(h, inner)
+            iteration = max((longest[u] + c for u in body if u in longest
+                             for v, c in succ[u] if v == h), default=0)
+            exits = {}
+            for u in body:
+                if u not in longest:
+                    continue
+                for v, c in succ[u]:
+                    if v not in body:
+                        exits[v] = max(exits.get(v, 0), longest[u] + c)
+            if not exits:
+                raise AnalysisError('%s: loop at 0x%x never exits' % (func, where))
+            for u, edges in succ.items():
+                if u not in body and any(v in body and v != h for v, _ in edges):
+                    raise AnalysisError('%s: loop at 0x%x entered in the middle' % (func, where))
+            node = ('loop', header)
+            succ[node] = [(v, bound_of[header] * iteration + c) for v, c in exits.items()]
+            for u in list(succ):
+                if u in body:
+                    del succ[u]
+                else:
+                    succ[u] = [(node if v in body else v, c) for v, c in succ[u]]
+            for a in rep:
+                if rep[a] in body:
+                    rep[a] = node
+        return self.longest_paths(rep[start], succ)
+
+    def section_wcet(self, func, start, succ, loops, bound_of):
+        """Cycles from the cli at start until SREG is restored (out SREG, sei) at the same depth.
+
+        The nodes are (address, open sections): a cli inside the section opens a nested one,
+        an out to SREG closes the innermost one. A loop of the section takes the bound of the
+        innermost loop of the function holding its header.
+        """
+        END, work, graph = 'end', [(start, 0)], {}
+        while work:
+            node = work.pop()
+            if node in graph:
+                continue
+            addr, depth = node
+            insn = self.insns[addr]
+            if insn.op == 'cli':
+                depth += 1
+            elif insn.op == 'out' and insn.args[:1] == [SREG]:
+                depth -= 1
+            elif insn.op == 'sei':
+                depth = 0
+            if depth > MAX_SECTION_DEPTH:
+                raise AnalysisError('%s: critical section at 0x%x nests deeper than %d (unbalanced cli)'
+                                    % (func, start, MAX_SECTION_DEPTH))
+            graph[node] = []
+            for nxt, cycles in succ[addr]:
+                if depth == 0:
+                    graph[node].append((END, cycles))
+                elif nxt == -1:
+                    raise AnalysisError('%s: critical section at 0x%x returns with the interrupts disabled'
+                                        % (func, start))
+                else:
+                    graph[node].append(((nxt, depth), cycles))
+                    work.append((nxt, depth))
+        graph[END] = []
+        nested = self.natural_loops((start, 0), graph)
+        bounds = {}
+        for header in nested:
+            holding = [h for h in loops if header[0] in loops[h]]
+            if not holding:
+                raise AnalysisError('%s: loop at 0x%x of the critical section at 0x%x has no bound'
+                                    % (func, header[0], start))
+            bounds[header] = bound_of[min(holding, key=lambda h: len(loops[h]))]
+        return self.longest_collapsed(func, (start, 0), graph, natural=nested, bound_of=bounds)[END]
+
+    def loop_bounds(self, func, loops):
+        """{header: bound}, from the markers and then from the "loop" line of the function."""
+        bound_of = {}
+        for addr, bound in self.markers:
+            holding = [h for h in loops if addr in loops[h]]
+            if holding:
+                h = min(holding, key=lambda h: len(loops[h]))
+                bound_of[h] = max(bound_of.get(h, 0), bound)
+        unmarked = sorted(h for h in loops if h not in bound_of)
+        bounds = self.loops.get(func, [])
+        if func in self.loops:
+            self.loops_used.add(func)
+        if len(bounds) != len(unmarked):
+            raise AnalysisError('%s: %d loop(s) without WCET_LOOP_BOUND (%s) but "loop %s" gives %d bound(s)'
+                                % (func, len(unmarked), ', '.join('0x%x' % h for h in unmarked) or 'none',
+                                   func, len(bounds)))
+        bound_of.update(zip(unmarked, bounds))
+        return bound_of
+
+    @staticmethod
+    def longest_paths(start, succ):
+        """Longest distance from start to every reachable node of an acyclic graph."""
+        order, seen, stack = [], set(), [(start, iter(succ.get(start, [])))]
+        seen.add(start)
+        while stack:
+            node, edges = stack[-1]
+            for v, _ in edges:
+                if v not in seen:
+                    seen.add(v)
+                    stack.append((v, iter(succ.get(v, []))))
+                    break
+            else:
+                order.append(node)
+                stack.pop()
+        dist = {start: 0}
+        for u in reversed(order):
+            if u not in dist:
+                continue
+            for v, c in succ.get(u, []):
+                if dist[u] + c > dist.get(v, -1):
+                    dist[v] = dist[u] + c
+        return dist
+
+    def natural_loops(self, entry, succ):
+        """{header: body} of the natural loops (back edges found by depth-first search)."""
+        back, state = [], {entry: 1}
+        stack = [(entry, iter(succ[entry]))]
+        while stack:
+            node, edges = stack[-1]
+            for v, _ in edges:
+                if state.get(v) == 1:
+                    back.append((node, v))
+                elif v not in state:
+                    state[v] = 1
+                    stack.append((v, iter(succ[v])))
+                    break
+            else:
+                state[node] = 2
+                stack.pop()
+        pred = {}
+        for u, edges in succ.items():
+            for v, _ in edges:
+                pred.setdefault(v, set()).add(u)
+        loops = {}
+        for u, h in back:
+            body = loops.setdefault(h, {h})
+            work = [u]
+            while work:
+                n = work.pop()
+                if n not in body:
+                    body.add(n)
+                    work.extend(pred.get(n, ()))
+        return loops
+
+    # Worst-case stack depth -------------------------------------------------------------
+    def stack(self, entry):
+        if entry in self.stack_memo:
+            return self.stack_memo[entry]
+        self.enter(entry)
+        try:
+            depth = self.function_stack(entry)
+        finally:
+            self.active.pop()
+        self.stack_memo[entry] = depth
+        return depth
+
+    def function_stack(self, entry):
+        """Deepest stack use below the return address of the function."""
+        func = self.name(entry)
+        best = {}
+        deepest = 0
+        work = [(entry, 0, None)]       # (address, bytes pushed, Y as pushed bytes after in r28,SPL)
+        while work:
+            addr, height, y = work.pop()
+            if best.get(addr, -1) >= height:
+                continue
+            if height > 256:
+                raise AnalysisError('%s: stack grows in a loop at 0x%x' % (func, addr))
+            best[addr] = height
+            insn = self.insns[addr]
+            op, args = insn.op, insn.args
+            deepest = max(deepest, height)
+            if op == 'push':
+                height += 1
+            elif op == 'pop':
+                height -= 1
+            elif op == 'in' and args == ['r28', SPL]:
+                y = height
+            elif y is not None and op in ('sbiw', 'adiw') and args[0] == 'r28':
+                y += int(args[1], 0) if op == 'sbiw' else -int(args[1], 0)
+            elif y is not None and op == 'subi' and args[0] == 'r28':
+                value = int(args[1], 0)
+                y += value if value < 0x80 else value - 0x100
+            elif op == 'out' and args == [SPL, 'r28'] and y is not None:
+                height = y
+            elif op == 'rcall' and insn.target == self.next_addr(insn):
+                height += RETURN_ADDRESS
+            for callee in self.calls(insn, func):
+                deepest = max(deepest, height + RETURN_ADDRESS + self.stack(callee))
+            if self.is_tail_call(insn, entry):
+                deepest = max(deepest, height + self.stack(insn.target))
+            deepest = max(deepest, height)
+            for nxt, _ in self.successors(insn, entry):
+                if nxt is not None:
+                    work.append((nxt, height, y))
+        return deepest
+
+
+def response_cycles(program, vector):
+    """Interrupt response plus the prologue of the handler up to its read of TCNT2."""
+    addr, cycles = program.address(symbol_of(vector)), INTERRUPT_RESPONSE
+    while addr in program.insns:
+        insn = program.insns[addr]
+        cycles += CYCLES.get(insn.op, 1)
+        if insn.op == 'lds' and len(insn.args) == 2 and int(insn.args[1], 0) == TCNT2:
+            return cycles
+        if insn.op.startswith('br') or insn.op in SKIPS or insn.op in RETURNS or insn.target is not None:
+            break
+        addr = program.next_addr(insn)
+    raise AnalysisError('%s: TCNT2 is not read before the first branch or call' % vector)
+
+
+def tick_latency(program, analyzed, latency, failures, f_cpu):
+    """Report lines of the latency check, the failures are appended to failures.
+
+    The request of the vector waits for the interrupt response and its prologue, for one
+    critical section of the tasks or one lower priority handler (interrupts do not nest, a
+    section and a handler cannot both be running), then for every higher priority handler
+    once. The budgets of the handlers are used, not their analyzed cycles: a handler within
+    its budget can never delay the tick past the bound.
+    """
+    vector, bound, critsec_limit = latency['bound']
+    lines = ['', '## Latency of %s' % vector, '']
+    try:
+        response = response_cycles(program, vector)
+    except AnalysisError as error:
+        failures.append(str(error))
+        return lines + ['ERROR: %s' % error]
+
+    # Critical sections of the tasks and of the main loop functions, all their call tree
+    tree, work = set(), [program.address(symbol_of(n)) for k, n, _, _, _, _ in analyzed
+                         if k == 'task' and symbol_of(n) in program.labels]
+    for name in latency['critsec']:
+        try:
+            work.append(program.address(name))
+            program.wcet(work[-1])
+        except AnalysisError as error:
+            failures.append('%s: %s' % (name, error))
+    while work:
+        entry = work.pop()
+        if entry not in tree:
+            tree.add(entry)
+            work.extend(program.callees.get(entry, []))
+    sections = sorted(((cycles, program.name(entry), addr) for entry in tree
+                       for addr, cycles in program.sections.get(entry, [])), reverse=True)
+    critsec = sections[0][0] if sections else 0
+    lines += ['| Critical section | Cycles |', '|---|---|']
+    lines += ['| %s 0x%x | %d |' % (name, addr, cycles) for cycles, name, addr in sections]
+    if critsec > critsec_limit:
+        failures.append('critical section %s 0x%x: %d cycles > %d' % (sections[0][1], sections[0][2],
+                                                                       critsec, critsec_limit))
+
+    # Every handler of the image needs a cycle budget, unless exempt
+    number = VECTORS[vector[:-5]]
+    budgets = {symbol_of(n): (n, limit) for k, n, _, _, limit, _ in analyzed if k == 'isr'}
+    exempt = {symbol_of(n) for n in latency['exempt']}
+    higher, lower = [], [('critical section', critsec_limit)]
+    for label in sorted(program.labels):
+        match = re.match(r'^__vector_(\d+)$', label)
+        if not match or int(match.group(1)) == number or label in exempt:
+            continue
+        name, limit = budgets.get(label, (label, None))
+        if limit is None:
+            failures.append('%s: no cycle budget, the latency of %s is not bounded' % (name, vector))
+            continue
+        (higher if int(match.group(1)) < number else lower).append((name, limit))
+    blocking = max(lower, key=lambda b: b[1])
+    worst = response + blocking[1] + sum(limit for _, limit in higher)
+    lines += ['', '| Term | Cycles |', '|---|---|',
+              '| Response and prologue to the TCNT2 read | %d |' % response,
+              '| Longest blocking: %s | %d |' % blocking]
+    lines += ['| Higher priority: %s | %d |' % h for h in higher]
+    lines += ['| Worst latency (bound %d) | %d (%.1f us) |' % (bound, worst, worst * 1e6 / f_cpu), '',
+              'Budgets of the handlers and of the critical sections, not their analyzed cycles; '
+              'exempt: %s.' % (', '.join(latency['exempt']) or 'none')]
+    if worst > bound:
+        failures.append('%s latency: %d cycles > %d with the budgets' % (vector, worst, bound))
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('image')
+    parser.add_argument('--budget')
+    parser.add_argument('--out')
+    parser.add_argument('--f-cpu', type=int, default=1000000)
+    parser.add_argument('--objdump', default='avr-objdump')
+    parser.add_argument('--report-only', action='store_true')
+    args = parser.parse_args()
+
+    insns, labels, markers = parse(read_disassembly(args.image, args.objdump))
+    if args.budget:
+        entries, loops, icalls, latency = read_budget(args.budget)
+    else:
+        entries, loops, icalls, latency = [], {}, {}, {'bound': None, 'exempt': [], 'critsec': []}
+        entries += [('isr', n, None, None) for n in sorted(labels) if n.startswith('__vector_')]
+    program = Program(insns, labels, markers, loops, icalls)
+
+    lines = ['# Worst-case execution time and stack: %s' % args.image, '',
+             '| Entry | Kind | Cycles | us | Budget | Stack | Budget | |', '|---|---|---|---|---|---|---|---|']
+    failures, isr_stack = [], 0
+    analyzed = []
+    for kind, name, cycle_limit, stack_limit in entries:
+        symbol = symbol_of(name)
+        try:
+            entry = program.address(symbol)
+            cycles = None
+            if kind != 'main':
+                cycles = program.wcet(entry) + (INTERRUPT_RESPONSE if kind == 'isr' else 0)
+            depth = program.stack(entry) + RETURN_ADDRESS
+            if kind == 'isr':
+                isr_stack = max(isr_stack, depth)
+            analyzed.append((kind, name, cycles, depth, cycle_limit, stack_limit))
+        except AnalysisError as error:
+            failures.append('%s: %s' % (name, error))
+            analyzed.append((kind, name, None, None, cycle_limit, stack_limit))
+
+    for kind, name, cycles, depth, cycle_limit, stack_limit in analyzed:
+        if depth is None:
+            lines.append('| %s | %s | | | %s | | %s | ERROR |' % (
+                name, kind, '-' if cycle_limit is None else cycle_limit, '-' if stack_limit is None else stack_limit))
+            continue
+        if kind == 'main':
+            depth += isr_stack           # Interrupts do not nest (the I-bit stays cleared)
+        status = 'ok'
+        if cycle_limit is not None and cycles is not None and cycles > cycle_limit:
+            failures.append('%s: %d cycles > %d' % (name, cycles, cycle_limit))
+            status = 'OVER'
+        if stack_limit is not None and depth > stack_limit:
+            failures.append('%s: stack %d > %d' % (name, depth, stack_limit))
+            status = 'OVER'
+        lines.append('| %s | %s | %s | %s | %s | %d | %s | %s |' % (
+            name, kind, '-' if cycles is None else cycles,
+            '-' if cycles is None else '%.1f' % (cycles * 1e6 / args.f_cpu),
+            '-' if cycle_limit is None else cycle_limit, depth,
+            '-' if stack_limit is None else stack_limit, status))
+    lines.append('')
+    lines.append('Cycles include the interrupt response (%d) for the handlers, stacks the return address; '
+                 'main includes the deepest handler.' % INTERRUPT_RESPONSE)
+
+    if latency['bound']:
+        lines += tick_latency(program, analyzed, latency, failures, args.f_cpu)
+
+    lines += ['', '## Call graph', '', '| Function | Cycles | Stack | Calls |', '|---|---|---|---|']
+    for entry in sorted(program.wcet_memo, key=lambda a: -program.wcet_memo[a]):
+        lines.append('| %s | %d | %s | %s |' % (
+            program.name(entry), program.wcet_memo[entry], program.stack_memo.get(entry, ''),
+            ', '.join(program.name(c) for c in program.callees.get(entry, []))))
+    unused = sorted(n for n in program.loops if n not in program.loops_used)
+    if unused:
+        lines += ['', 'Loop lines of functions not analyzed in this image: ' + ', '.join(unused) + '.']
+    if failures:
+        lines += ['', '## Failed', ''] + ['- ' + failure for failure in failures]
+
+    report = '\n'.join(lines) + '\n'
+    if args.out:
+        with open(args.out, 'w') as f:
+            f.write(report)
+    sys.stdout.write(report)
+    if failures:
+        print('wcet/stack check failed: ' + '; '.join(failures), file=sys.stderr)
+        return 0 if args.report_only else 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,174 @@
+/*
+ * VccMon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include "VccMon.h"
+#include "SafeState.h"
+#include "CritSec.h"
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+// AVCC reference (REFS0), input: the 1.1V bandgap (MUX3:0 = 14)
+#define VCCMON_ADMUX			((1 << REFS0) | (1 << MUX3) | (1 << MUX2) | (1 << MUX1))
+
+/**
+ * ADC = VCCMON_BANDGAP_MV * 1024 / VCC: a lower supply gives a higher reading. The filter
+ * keeps the sum of the window, the thresholds are compared in the same unit.
+ */
+#define VCCMON_MV_TIMES_SUM		((uint32)VCCMON_BANDGAP_MV * 1024UL * VCCMON_WINDOW)
+#define VCCMON_SUM_OF_MV(mv)	((uint16)(VCCMON_MV_TIMES_SUM / (mv)))
+
+#if ((VCCMON_WINDOW & (VCCMON_WINDOW - 1)) != 0)
+#error "VCCMON_WINDOW must be a power of two"
+#endif
+#if (VCCMON_SAFE_MV <= VCCMON_BOD_MV || VCCMON_SAG_MV <= VCCMON_SAFE_MV)
+#error "The thresholds must be ordered: VCCMON_SAG_MV > VCCMON_SAFE_MV > VCCMON_BOD_MV"
+#endif
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+// Written by ISR(ADC_vect) only
+static uint16 VccMon_Ring[VCCMON_WINDOW];		// Last samples, oldest at VccMon_Head
+static uint8 VccMon_Head;
+static uint8 VccMon_Fill;						// Samples in the window, up to VCCMON_WINDOW
+static uint8 VccMon_Settle;						// Samples still to be dropped
+static uint16 VccMon_Sum;						// Sum of the window, 0 until it is full
+static uint16 VccMon_Acc;						// Running sum while the window fills
+static uint16 VccMon_MaxSum;					// Lowest VCC seen
+static uint32 VccMon_Samples;
+static uint16 VccMon_Sags;
+static uint8 VccMon_InSag;
+static uint8 VccMon_SafeState;
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief Starts the conversions of the bandgap channel.
+ *
+ * The ADC runs on its own (free running or auto-triggered by Timer1 compare match B) and
+ * every result is handled by ISR(ADC_vect): nothing waits for ADSC. The first result
+ * arrives after 25 ADC clocks, once the interrupts are enabled.
+ *
+ * @return None
+ */
+void VccMon_Init(void) {
+	uint8 i;
+
+	for (i = 0; i < VCCMON_WINDOW; i++) {
+		WCET_LOOP_BOUND(VCCMON_WINDOW);
+		VccMon_Ring[i] = 0;
+	}
+	VccMon_Head = 0;
+	VccMon_Fill = 0;
+	VccMon_Settle = VCCMON_SETTLE_SAMPLES;
+	VccMon_Sum = 0;
+	VccMon_Acc = 0;
+	VccMon_MaxSum = 0;
+	VccMon_Samples = 0;
+	VccMon_Sags = 0;
+	VccMon_InSag = 0;
+	VccMon_SafeState = 0;
+#if (VCCMON_ENABLED == 1)
+	ADMUX = VCCMON_ADMUX;
+	ADCSRB = VCCMON_TRIGGER;
+#if (VCCMON_TRIGGER == VCCMON_TRIGGER_TIMER1_COMPB)
+	// Half way between two WDG notifications (TIMER1_COMPA_vect), no interrupt of its own
+	OCR1B = TIMER1_COMPARE_VALUE / 2;
+	TIFR1 = (1 << OCF1B);
+	ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIE) | VCCMON_ADPS;
+#else
+	ADCSRA = (1 << ADEN) | (1 << ADSC) | (1 << ADATE) | (1 << ADIE) | VCCMON_ADPS;
+#endif
+#endif
+}
+
+
+/**
+ * @brief Filtered supply voltage in mV, 0 until the first window is full.
+ */
+uint16 VccMon_GetVccMv(void) {
+	uint16 sum;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_VCCMON_READ, sreg);
+	sum = VccMon_Sum;
+	CRITSEC_EXIT(CRITSEC_SITE_VCCMON_READ, sreg);
+	return sum ? (uint16)(VCCMON_MV_TIMES_SUM / sum) : 0;
+}
+
+
+/**
+ * @brief Copies the counters.
+ */
+void VccMon_GetStats(VccMon_StatsType *Stats) {
+	uint16 maxSum;
+	uint8 sreg;
+
+	CRITSEC_ENTER(CRITSEC_SITE_VCCMON_READ, sreg);
+	Stats->Samples = VccMon_Samples;
+	Stats->Sags = VccMon_Sags;
+	Stats->SafeState = VccMon_SafeState;
+	maxSum = VccMon_MaxSum;
+	CRITSEC_EXIT(CRITSEC_SITE_VCCMON_READ, sreg);
+	Stats->MinMv = maxSum ? (uint16)(VCCMON_MV_TIMES_SUM / maxSum) : 0;
+}
+
+
+/**
+ * @brief Conversion complete: the sample replaces the oldest one of the ring buffer and
+ * the moving average is updated by the difference (a few additions, no division).
+ *
+ * Below VCCMON_SAG_MV every sample fails WDGM_ENTITY_VCCMON, so the window closes NOK and
+ * the watchdog resets. Below VCCMON_SAFE_MV the supply may not last until then: the
+ * outputs are driven to the safe state right here.
+ */
+ISR(ADC_vect) {
+	uint16 sample = ADC;
+
+#if (VCCMON_TRIGGER == VCCMON_TRIGGER_TIMER1_COMPB)
+	// The next compare match must be a rising edge of the flag again
+	TIFR1 = (1 << OCF1B);
+#endif
+	VccMon_Samples++;
+	if (VccMon_Settle) {
+		VccMon_Settle--;
+		return;
+	}
+	VccMon_Acc = (uint16)(VccMon_Acc + sample - VccMon_Ring[VccMon_Head]);
+	VccMon_Ring[VccMon_Head] = sample;
+	VccMon_Head = (VccMon_Head + 1) & (VCCMON_WINDOW - 1);
+	if (VccMon_Fill < VCCMON_WINDOW) {
+		VccMon_Fill++;
+		if (VccMon_Fill < VCCMON_WINDOW) {
+			return;
+		}
+	}
+	VccMon_Sum = VccMon_Acc;
+	if (VccMon_Sum > VccMon_MaxSum) {
+		VccMon_MaxSum = VccMon_Sum;
+	}
+	if (VccMon_Sum < VCCMON_SUM_OF_MV(VCCMON_SAG_MV)) {
+		VccMon_InSag = 0;
+		return;
+	}
+	if (!VccMon_InSag) {
+		VccMon_InSag = 1;
+		VccMon_Sags++;
+	}
+	WDGM_EntityFailureIndication(WDGM_ENTITY_VCCMON);
+	if (VccMon_Sum >= VCCMON_SUM_OF_MV(VCCMON_SAFE_MV) && !SafeState_IsActive()) {
+		VccMon_SafeState = 1;
+		SafeState_Apply();
+	}
+}
@@ -0,0 +1,98 @@
+/*
+ * VccMon.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef VCCMON_H_
+#define VCCMON_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Std_types.h"
+#include "timer.h"
+#include "WDGM.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> the supply voltage is measured with the ADC (internal bandgap against AVCC) and
+ * supervised by WDGM. Off by default: the bandgap is 1.0V to 1.2V from part to part,
+ * VCCMON_BANDGAP_MV has to be calibrated on the board first.
+ */
+#ifndef VCCMON_ENABLED
+#define VCCMON_ENABLED			0
+#endif
+
+// Bandgap voltage of the part (1.1V nominal): ADC * VCC / 1024 with VCC measured on the board
+#define VCCMON_BANDGAP_MV		1100
+
+/**
+ * Nominal supply 5V, brown-out detector at 2.7V (BODLEVEL fuses). Below VCCMON_SAG_MV the
+ * supply sags: every sample is a failure of WDGM_ENTITY_VCCMON. Below VCCMON_SAFE_MV the
+ * outputs are driven to the safe state at once, before the brown-out reset.
+ */
+#define VCCMON_SAG_MV			4500
+#define VCCMON_SAFE_MV			3000
+#define VCCMON_BOD_MV			2700
+
+/**
+ * Conversion trigger (ADTS value):
+ *   VCCMON_TRIGGER_FREE_RUNNING  one conversion every 13 ADC clocks (601 per second)
+ *   VCCMON_TRIGGER_TIMER1_COMPB  one conversion per Timer1 period (52.2ms, 19 per second),
+ *                                OCR1B is set half way between two WDG notifications
+ */
+#define VCCMON_TRIGGER_FREE_RUNNING	0
+#define VCCMON_TRIGGER_TIMER1_COMPB	5
+#ifndef VCCMON_TRIGGER
+#define VCCMON_TRIGGER			VCCMON_TRIGGER_FREE_RUNNING
+#endif
+
+// ADC clock F_CPU / 128 (ADPS2:0 = 7): 7.8kHz at 1MHz, 13 clocks (1664us) per conversion
+#define VCCMON_ADPS				7
+#if (VCCMON_TRIGGER == VCCMON_TRIGGER_TIMER1_COMPB)
+#define VCCMON_SAMPLE_US		((TIMER1_COMPARE_VALUE + 1UL) * TIMER1_PRESCALER * 1000UL / (F_CPU / 1000UL))
+#else
+#define VCCMON_SAMPLE_US		((13UL << VCCMON_ADPS) * 1000UL / (F_CPU / 1000UL))
+#endif
+
+// Moving average over the last VCCMON_WINDOW samples (power of two, ring buffer)
+#define VCCMON_WINDOW			8
+
+// Conversions dropped after VccMon_Init while the bandgap settles
+#define VCCMON_SETTLE_SAMPLES	2
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+/**
+ * Counters since VccMon_Init.
+ */
+typedef struct {
+	uint32 Samples;			/* Conversions, the settling ones included            */
+	uint16 MinMv;			/* Lowest filtered VCC, 0 before the first full window */
+	uint16 Sags;			/* Times the filtered VCC fell below VCCMON_SAG_MV     */
+	uint8  SafeState;		/* 1: VccMon applied the safe state (VCCMON_SAFE_MV)   */
+} VccMon_StatsType;
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void VccMon_Init(void);
+uint16 VccMon_GetVccMv(void);
+void VccMon_GetStats(VccMon_StatsType *Stats);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* VCCMON_H_ */
@@ -0,0 +1,253 @@
+/*
+ * WinCal.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#include <stddef.h>
+#include "WinCal.h"
+
+/*******************************************************************************
+ *************************   Global variables Start      ***********************
+ *******************************************************************************/
+static WinCal_StateType WinCal_State = WINCAL_STATE_DEFAULT;
+static WinCal_RecordType WinCal_Record;		// Loaded, or being written (Eeprom_Write)
+static uint32 WinCal_Since;					// Start of the settling time
+static const uint8 WinCal_Invalid = 0xFF;	// Version byte of an invalidated record
+/*******************************************************************************
+ *************************   Global variables end      ***********************
+ *******************************************************************************/
+
+
+/**
+ * @brief CRC16-CCITT of the record without its Crc field.
+ */
+static uint16 WinCal_Crc(const WinCal_RecordType *Record) {
+	const uint8 *data = (const uint8 *)Record;
+	uint16 crc = 0xFFFF;
+	uint8 i;
+
+	for (i = 0; i < offsetof(WinCal_RecordType, Crc); i++) {
+		WCET_LOOP_BOUND(offsetof(WinCal_RecordType, Crc));
+		crc = _crc_ccitt_update(crc, data[i]);
+	}
+	return crc;
+}
+
+
+/**
+ * @brief Entities whose window is learned: enabled, with a lower bound on the calls
+ * (the failure-only entities have nothing to learn).
+ */
+static uint8 WinCal_Entities(void) {
+	WDGM_EntityConfigType config;
+	uint8 entities = 0;
+	uint8 entity;
+
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		WDGM_GetEntityConfig((WDGM_EntityIdType)entity, &config);
+		if (config.Enabled && config.MinCalls > 0) {
+			entities |= (1 << entity);
+		}
+	}
+	return entities;
+}
+
+
+/**
+ * @brief Checks the loaded record against this build and the default windows (which it
+ * may only tighten). Called while the default windows are active.
+ */
+static bool WinCal_RecordValid(void) {
+	WDGM_EntityConfigType config;
+	uint8 entity;
+
+	if (WinCal_Record.Version != WINCAL_VERSION || WinCal_Record.WindowMs != RunCfg_Active.WdgmPeriodMs ||
+		WinCal_Record.LedmPeriodMs != RunCfg_Active.LedmPeriodMs || WinCal_Record.WdgmTaskMs != RunCfg_Active.WdgmTaskMs ||
+		WinCal_Record.CpuKhz != (uint16)(F_CPU / 1000UL) || WinCal_Record.Entities != WinCal_Entities() ||
+		WinCal_Record.Crc != WinCal_Crc(&WinCal_Record)) {
+		return false;
+	}
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		WDGM_GetEntityConfig((WDGM_EntityIdType)entity, &config);
+		if (WinCal_Record.MinCalls[entity] < config.MinCalls || WinCal_Record.MaxCalls[entity] > config.MaxCalls ||
+			WinCal_Record.MinCalls[entity] > WinCal_Record.MaxCalls[entity]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+static void WinCal_Apply(void) {
+	uint8 entity;
+
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		if (WinCal_Record.Entities & (1 << entity)) {
+			WDGM_SetEntityWindow((WDGM_EntityIdType)entity, WinCal_Record.MinCalls[entity],
+								 WinCal_Record.MaxCalls[entity]);
+		}
+	}
+}
+
+
+/**
+ * @brief Loads the learned windows or arms the learning.
+ *
+ * Must be called after WDGM_Init and LimpHome_Init. A valid record is applied on every
+ * boot. Without one, the windows are learned after a cold boot only (power-on, no watchdog
+ * or external reset since): the load after a reset is not the nominal one. A limp-home boot
+ * invalidates the record, windows that ended in a reset loop are learned again at the next
+ * cold boot.
+ *
+ * @return None
+ */
+void WinCal_Init(void) {
+	uint8 flags = Boot_GetResetFlags();
+
+	WinCal_State = WINCAL_STATE_DEFAULT;
+#if (WINCAL_ENABLED == 1)
+	if (LimpHome_IsActive()) {
+		(void)Eeprom_Write(WINCAL_EEPROM_ADDR + offsetof(WinCal_RecordType, Version), &WinCal_Invalid, 1);
+		return;
+	}
+	Eeprom_Read(WINCAL_EEPROM_ADDR, (uint8 *)&WinCal_Record, sizeof(WinCal_Record));
+	if (WinCal_RecordValid()) {
+		WinCal_Apply();
+		WinCal_State = WINCAL_STATE_LOADED;
+	} else if ((flags & (1 << PORF)) && !(flags & ((1 << WDRF) | (1 << EXTRF)))) {
+		WinCal_Recalibrate();
+	}
+#else
+	(void)flags;
+#endif
+}
+
+
+/**
+ * @brief Learns the windows again from now on (default windows meanwhile).
+ *
+ * Called from the super loop context only. The stored record is replaced once the
+ * learning completes.
+ *
+ * @return None
+ */
+void WinCal_Recalibrate(void) {
+	WDGM_RestoreDefaultWindows();
+	WinCal_Since = HAL_GetTick();
+	WinCal_State = WINCAL_STATE_SETTLING;
+}
+
+
+/**
+ * @brief Derives the windows from the statistics of the learning windows.
+ *
+ * @return false if a learned entity had a violation (learning aborted).
+ */
+static bool WinCal_Learn(void) {
+	WDGM_EntityConfigType config;
+	WDGM_EntityStatsType stats;
+	uint8 entities = WinCal_Entities();
+	uint8 entity;
+
+	WinCal_Record.Version = WINCAL_VERSION;
+	WinCal_Record.Entities = entities;
+	WinCal_Record.WindowMs = RunCfg_Active.WdgmPeriodMs;
+	WinCal_Record.LedmPeriodMs = RunCfg_Active.LedmPeriodMs;
+	WinCal_Record.WdgmTaskMs = RunCfg_Active.WdgmTaskMs;
+	WinCal_Record.CpuKhz = (uint16)(F_CPU / 1000UL);
+	for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+		sint16 min, max;
+
+		WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+		WDGM_GetEntityConfig((WDGM_EntityIdType)entity, &config);
+		min = config.MinCalls;
+		max = config.MaxCalls;
+		if ((entities & (1 << entity)) && WDGM_GetEntityStats((WDGM_EntityIdType)entity, &stats)) {
+			if (stats.Violations != 0) {
+				return false;
+			}
+			min = (sint16)stats.MinCount;
+			max = (sint16)stats.MaxCount;
+			// A spread that already shows the +/-1 jitter of the task needs no margin on top
+			if (max - min < 2 * WINCAL_MARGIN) {
+				min -= WINCAL_MARGIN;
+				max += WINCAL_MARGIN;
+			}
+			min = (min < config.MinCalls) ? config.MinCalls : min;
+			max = (max > config.MaxCalls) ? config.MaxCalls : max;
+		}
+		WinCal_Record.MinCalls[entity] = (uint8)min;
+		WinCal_Record.MaxCalls[entity] = (uint8)max;
+	}
+	WinCal_Record.Crc = WinCal_Crc(&WinCal_Record);
+	return true;
+}
+
+
+/**
+ * @brief Periodic function of the window calibration, called after WDGM_MainFunction.
+ *
+ * Learning uses the WDGM statistics (cleared when it starts): once every learned entity
+ * has WINCAL_WINDOWS windows, its window becomes the observed [min, max], widened by
+ * WINCAL_MARGIN on each side when the spread is below 2 * WINCAL_MARGIN, clipped to the
+ * default window. A violation while learning aborts
+ * it, the default windows stay. The record is written in the background (Eeprom_Write).
+ *
+ * @return None
+ */
+void WinCal_MainFunction(void) {
+	WDGM_EntityStatsType stats;
+	uint8 entities;
+	uint8 entity;
+
+	switch (WinCal_State) {
+	case WINCAL_STATE_SETTLING:
+		if ((HAL_GetTick() - WinCal_Since) >= WINCAL_SETTLE_MS) {
+			WDGM_ResetStats();
+			WinCal_State = WINCAL_STATE_LEARNING;
+		}
+		break;
+	case WINCAL_STATE_LEARNING:
+		entities = WinCal_Entities();
+		for (entity = 0; entity < WDGM_ENTITY_COUNT; entity++) {
+			WCET_LOOP_BOUND(WDGM_ENTITY_COUNT);
+			if ((entities & (1 << entity)) && WDGM_GetEntityStats((WDGM_EntityIdType)entity, &stats)) {
+				if (stats.Violations != 0) {
+					WinCal_State = WINCAL_STATE_ABORTED;
+					return;
+				}
+				if (stats.Windows < WINCAL_WINDOWS) {
+					return;
+				}
+			}
+		}
+		if (!WinCal_Learn() || Eeprom_IsBusy()) {
+			WinCal_State = WINCAL_STATE_ABORTED;
+			return;
+		}
+		WinCal_Apply();
+		(void)Eeprom_Write(WINCAL_EEPROM_ADDR, (const uint8 *)&WinCal_Record, sizeof(WinCal_Record));
+		WinCal_State = WINCAL_STATE_WRITING;
+		break;
+	case WINCAL_STATE_WRITING:
+		if (!Eeprom_IsBusy()) {
+			WinCal_State = WINCAL_STATE_CALIBRATED;
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+
+/**
+ * @brief Returns the state of the window calibration.
+ */
+WinCal_StateType WinCal_GetState(void) {
+	return WinCal_State;
+}
@@ -0,0 +1,100 @@
+/*
+ * WinCal.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: Mahmoud
+ */
+
+#ifndef WINCAL_H_
+#define WINCAL_H_
+/*******************************************************************************
+ ******************************   includes Start    ****************************
+ *******************************************************************************/
+#include <avr/io.h>
+#include <util/crc16.h>
+#include "Std_types.h"
+#include "timer.h"
+#include "WDGM.h"
+#include "Eeprom.h"
+#include "Boot.h"
+#include "LimpHome.h"
+#include "RunCfg.h"
+/*******************************************************************************
+ ******************************   includes End      ****************************
+ *******************************************************************************/
+
+
+/*******************************************************************************
+ ******************************   Macros Start      ****************************
+ *******************************************************************************/
+/**
+ * 1 -> the windows of the count-supervised entities are learned after a cold boot and kept
+ * in the EEPROM, 0 -> the build-time windows (LEDM_CALLS_OK_MIN/MAX, ...) are used.
+ */
+#ifndef WINCAL_ENABLED
+#define WINCAL_ENABLED			1
+#endif
+
+// Learning: windows skipped after the boot, then windows observed per entity
+#define WINCAL_SETTLE_MS		(2 * WDGM_PERIOD_MS)
+#define WINCAL_WINDOWS			50
+
+/*
+ * Calls added on each side of the observed min/max when the observed spread is below
+ * 2 * WINCAL_MARGIN; never wider than the default window. A periodic task moves by +/-1 call
+ * against the window: a spread that shows it (9..11 for LEDM on target) is kept as observed,
+ * a spread that does not (10..10 in the jitter-free simulator) is widened to cover it.
+ */
+#define WINCAL_MARGIN			1
+
+#define WINCAL_EEPROM_ADDR		0x0000
+#define WINCAL_VERSION			4		// 4: LEDM and WDGM task periods added to the record
+/*******************************************************************************
+ ******************************   Macros End        ****************************
+ *******************************************************************************/
+
+
+typedef enum {
+	WINCAL_STATE_DEFAULT = 0,	/* Default windows (disabled, no record, not a cold boot) */
+	WINCAL_STATE_LOADED,		/* Windows of the EEPROM record                           */
+	WINCAL_STATE_SETTLING,		/* Learning starts after WINCAL_SETTLE_MS                 */
+	WINCAL_STATE_LEARNING,		/* Observing WINCAL_WINDOWS windows                       */
+	WINCAL_STATE_WRITING,		/* Learned windows active, record being written           */
+	WINCAL_STATE_CALIBRATED,	/* Learned windows active and stored                      */
+	WINCAL_STATE_ABORTED		/* Violation while learning, default windows              */
+} WinCal_StateType;
+
+/**
+ * EEPROM record of the learned windows. The record only applies to the build and the
+ * runtime configuration it was learned with (window length, task periods, clock, entities):
+ * the calls per window follow the periods. The CRC comes last and is written last.
+ */
+typedef struct {
+	uint8  Version;							/* WINCAL_VERSION, 0xFF: erased/invalidated */
+	uint8  Entities;						/* Bit per learned WDGM_EntityIdType        */
+	uint16 WindowMs;						/* RunCfg_Active.WdgmPeriodMs               */
+	uint16 LedmPeriodMs;					/* RunCfg_Active.LedmPeriodMs               */
+	uint16 WdgmTaskMs;						/* RunCfg_Active.WdgmTaskMs                 */
+	uint16 CpuKhz;							/* F_CPU / 1000                             */
+	uint8  MinCalls[WDGM_ENTITY_COUNT];
+	uint8  MaxCalls[WDGM_ENTITY_COUNT];
+	uint16 Crc;								/* CRC16-CCITT of the fields above          */
+} WinCal_RecordType;
+
+// EEPROM layout of the AVR build, the record ends before the RunCfg copies
+_Static_assert(sizeof(WinCal_RecordType) == 10 + 2 * WDGM_ENTITY_COUNT + 2, "WinCal_RecordType layout");
+_Static_assert(WINCAL_EEPROM_ADDR + sizeof(WinCal_RecordType) <= RUNCFG_EEPROM_ADDR_A, "WinCal record overlaps RunCfg");
+
+
+/*******************************************************************************
+ ******************************   Fucntion Prototype Start  ********************
+ *******************************************************************************/
+void WinCal_Init(void);
+void WinCal_MainFunction(void);
+void WinCal_Recalibrate(void);
+WinCal_StateType WinCal_GetState(void);
+/*******************************************************************************
+ ******************************   Fucntion Prototype End     *******************
+ *******************************************************************************/
+
+#endif /* WINCAL_H_ */